@@ -0,0 +1,489 @@
+#if !defined(GJ_AABB_TREE_H)
+#define GJ_AABB_TREE_H
+
+// Dynamic AABB tree for objects that move, spawn and die all the time, where
+// rebuilding a grid or BVH every frame would be wasted work.
+//
+// Leaves store a fat box, the object's box grown by margin on every side,
+// so small moves don't touch the tree at all. A leaf is only reinserted
+// once its object leaves the fat box. Insertion walks down picking the child
+// whose box grows the least in surface area (the SAH cost of the new
+// parent), and every node on the way back up is rebalanced with a tree
+// rotation when one child is more than one level taller than the other, so
+// the height stays close to logarithmic whatever the insertion order.
+//
+// Nodes come from a free list backed by blocks pushed on the arena, removed
+// nodes are reused and nothing goes to the heap. Node pointers stay valid
+// until the node is removed.
+//
+//  GJAABBTree tree;
+//  gj_aabb_tree_create(&tree, &arena, 0.1f);
+//  entity->proxy = gj_aabb_tree_insert(&tree, entity->min, entity->max, entity_index);
+//  gj_aabb_tree_move(&tree, entity->proxy, entity->min, entity->max);
+//  u32 hits[64];
+//  u32 hit_count = gj_aabb_tree_query_aabb(&tree, min, max, hits, gj_ArrayCount(hits));
+//  gj_aabb_tree_remove(&tree, entity->proxy);
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+
+#define GJ_AABB_TREE_NODE_BLOCK 256
+// NOTE: Traversal stack on the C stack, taller trees get theirs from the
+//       arena. The tree stays balanced so that takes a huge tree.
+#define GJ_AABB_TREE_STACK_SIZE 256
+
+typedef struct GJAABBTreeNode GJAABBTreeNode;
+struct GJAABBTreeNode
+{
+    V3f min;
+    V3f max;
+    // NOTE: Next free node while on the free list
+    GJAABBTreeNode* parent;
+    // NOTE: Both NULL for leaves
+    GJAABBTreeNode* child1;
+    GJAABBTreeNode* child2;
+    u32 user;
+    // NOTE: 0 for leaves
+    s32 height;
+};
+
+// NOTE: The user values of two leaves whose fat boxes overlap
+typedef struct GJAABBTreePair
+{
+    u32 a;
+    u32 b;
+} GJAABBTreePair;
+
+typedef struct GJAABBTree
+{
+    GJAABBTreeNode* root;
+    GJAABBTreeNode* free_list;
+    MemoryArena*    arena;
+    f32             margin;
+    u32             leaf_count;
+    u32             node_count;
+} GJAABBTree;
+
+static void
+gj_aabb_tree_create(GJAABBTree* tree, MemoryArena* arena, f32 margin)
+{
+    tree->root       = NULL;
+    tree->free_list  = NULL;
+    tree->arena      = arena;
+    tree->margin     = margin;
+    tree->leaf_count = 0;
+    tree->node_count = 0;
+}
+
+inline b32 gj__aabb_tree_is_leaf(GJAABBTreeNode* node) { return node->child1 == NULL; }
+
+inline f32
+gj__aabb_tree_area(V3f min, V3f max)
+{
+    V3f e = V3_sub(max, min);
+    return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+}
+
+inline void
+gj__aabb_tree_combine(V3f a_min, V3f a_max, V3f b_min, V3f b_max, V3f* min, V3f* max)
+{
+    *min = {gj_Min(a_min.x, b_min.x), gj_Min(a_min.y, b_min.y), gj_Min(a_min.z, b_min.z)};
+    *max = {gj_Max(a_max.x, b_max.x), gj_Max(a_max.y, b_max.y), gj_Max(a_max.z, b_max.z)};
+}
+
+inline b32
+gj__aabb_tree_overlap(V3f a_min, V3f a_max, V3f b_min, V3f b_max)
+{
+    return (a_min.x <= b_max.x && b_min.x <= a_max.x &&
+            a_min.y <= b_max.y && b_min.y <= a_max.y &&
+            a_min.z <= b_max.z && b_min.z <= a_max.z);
+}
+
+// NOTE: Refits node to its children
+inline void
+gj__aabb_tree_refit(GJAABBTreeNode* node)
+{
+    gj__aabb_tree_combine(node->child1->min, node->child1->max, node->child2->min, node->child2->max, &node->min, &node->max);
+    node->height = 1 + gj_Max(node->child1->height, node->child2->height);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Node Pool
+///////////////////////////////////////////////////////////////////////////
+static GJAABBTreeNode*
+gj__aabb_tree_allocate_node(GJAABBTree* tree)
+{
+    if (!tree->free_list)
+    {
+        GJAABBTreeNode* block = (GJAABBTreeNode*)_push(tree->arena, GJ_AABB_TREE_NODE_BLOCK * sizeof(GJAABBTreeNode), 64);
+        for (u32 i = 0; i < GJ_AABB_TREE_NODE_BLOCK - 1; i++) block[i].parent = block + i + 1;
+        block[GJ_AABB_TREE_NODE_BLOCK - 1].parent = NULL;
+        tree->free_list = block;
+    }
+    GJAABBTreeNode* node = tree->free_list;
+    tree->free_list = node->parent;
+    node->parent = NULL;
+    node->child1 = NULL;
+    node->child2 = NULL;
+    node->user   = 0;
+    node->height = 0;
+    tree->node_count++;
+    return node;
+}
+
+inline void
+gj__aabb_tree_free_node(GJAABBTree* tree, GJAABBTreeNode* node)
+{
+    node->parent = tree->free_list;
+    node->height = -1;
+    tree->free_list = node;
+    tree->node_count--;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Balancing
+///////////////////////////////////////////////////////////////////////////
+inline void
+gj__aabb_tree_replace_child(GJAABBTree* tree, GJAABBTreeNode* parent, GJAABBTreeNode* old_child, GJAABBTreeNode* new_child)
+{
+    if (!parent)                          tree->root     = new_child;
+    else if (parent->child1 == old_child) parent->child1 = new_child;
+    else                                  parent->child2 = new_child;
+}
+
+// NOTE: If one child of a is more than one level taller than the other, the
+//       taller child c takes a's place and a takes the shorter of c's
+//       children, c keeps the taller one. Returns the node now in a's place.
+static GJAABBTreeNode*
+gj__aabb_tree_balance(GJAABBTree* tree, GJAABBTreeNode* a)
+{
+    if (gj__aabb_tree_is_leaf(a) || a->height < 2) return a;
+
+    GJAABBTreeNode* b = a->child1;
+    GJAABBTreeNode* c = a->child2;
+    s32 balance = c->height - b->height;
+    if (balance > 1)
+    {
+        GJAABBTreeNode* f = c->child1;
+        GJAABBTreeNode* g = c->child2;
+        c->child1 = a;
+        c->parent = a->parent;
+        a->parent = c;
+        gj__aabb_tree_replace_child(tree, c->parent, a, c);
+        if (f->height > g->height)
+        {
+            c->child2 = f;
+            a->child2 = g;
+            g->parent = a;
+        }
+        else
+        {
+            c->child2 = g;
+            a->child2 = f;
+            f->parent = a;
+        }
+        gj__aabb_tree_refit(a);
+        gj__aabb_tree_refit(c);
+        return c;
+    }
+    if (balance < -1)
+    {
+        GJAABBTreeNode* d = b->child1;
+        GJAABBTreeNode* e = b->child2;
+        b->child1 = a;
+        b->parent = a->parent;
+        a->parent = b;
+        gj__aabb_tree_replace_child(tree, b->parent, a, b);
+        if (d->height > e->height)
+        {
+            b->child2 = d;
+            a->child1 = e;
+            e->parent = a;
+        }
+        else
+        {
+            b->child2 = e;
+            a->child1 = d;
+            d->parent = a;
+        }
+        gj__aabb_tree_refit(a);
+        gj__aabb_tree_refit(b);
+        return b;
+    }
+    return a;
+}
+
+// NOTE: Refit and rebalance from node up to the root
+static void
+gj__aabb_tree_fix_upwards(GJAABBTree* tree, GJAABBTreeNode* node)
+{
+    while (node)
+    {
+        node = gj__aabb_tree_balance(tree, node);
+        gj__aabb_tree_refit(node);
+        node = node->parent;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Insert / Remove
+///////////////////////////////////////////////////////////////////////////
+static void
+gj__aabb_tree_insert_leaf(GJAABBTree* tree, GJAABBTreeNode* leaf)
+{
+    if (!tree->root)
+    {
+        tree->root = leaf;
+        leaf->parent = NULL;
+        return;
+    }
+
+    // NOTE: Descend into the child where adding the leaf costs the least.
+    //       Pairing with node costs the area of the new parent, going below
+    //       it also grows node and everything above (the inherited cost).
+    GJAABBTreeNode* node = tree->root;
+    while (!gj__aabb_tree_is_leaf(node))
+    {
+        V3f combined_min, combined_max;
+        gj__aabb_tree_combine(node->min, node->max, leaf->min, leaf->max, &combined_min, &combined_max);
+        f32 area          = gj__aabb_tree_area(node->min, node->max);
+        f32 combined_area = gj__aabb_tree_area(combined_min, combined_max);
+        f32 cost             = 2.0f * combined_area;
+        f32 inheritance_cost = 2.0f * (combined_area - area);
+
+        f32 child_costs[2];
+        GJAABBTreeNode* children[2] = {node->child1, node->child2};
+        for (u32 i = 0; i < 2; i++)
+        {
+            GJAABBTreeNode* child = children[i];
+            V3f child_min, child_max;
+            gj__aabb_tree_combine(child->min, child->max, leaf->min, leaf->max, &child_min, &child_max);
+            f32 child_cost = gj__aabb_tree_area(child_min, child_max);
+            if (!gj__aabb_tree_is_leaf(child)) child_cost -= gj__aabb_tree_area(child->min, child->max);
+            child_costs[i] = child_cost + inheritance_cost;
+        }
+
+        if (cost < child_costs[0] && cost < child_costs[1]) break;
+        node = child_costs[0] < child_costs[1] ? node->child1 : node->child2;
+    }
+
+    GJAABBTreeNode* sibling    = node;
+    GJAABBTreeNode* old_parent = sibling->parent;
+    GJAABBTreeNode* new_parent = gj__aabb_tree_allocate_node(tree);
+    new_parent->parent = old_parent;
+    new_parent->child1 = sibling;
+    new_parent->child2 = leaf;
+    sibling->parent    = new_parent;
+    leaf->parent       = new_parent;
+    gj__aabb_tree_replace_child(tree, old_parent, sibling, new_parent);
+    gj__aabb_tree_fix_upwards(tree, new_parent);
+}
+
+static void
+gj__aabb_tree_remove_leaf(GJAABBTree* tree, GJAABBTreeNode* leaf)
+{
+    if (leaf == tree->root)
+    {
+        tree->root = NULL;
+        return;
+    }
+
+    // NOTE: The sibling takes the parent's place
+    GJAABBTreeNode* parent       = leaf->parent;
+    GJAABBTreeNode* grand_parent = parent->parent;
+    GJAABBTreeNode* sibling      = parent->child1 == leaf ? parent->child2 : parent->child1;
+    sibling->parent = grand_parent;
+    gj__aabb_tree_replace_child(tree, grand_parent, parent, sibling);
+    gj__aabb_tree_free_node(tree, parent);
+    gj__aabb_tree_fix_upwards(tree, grand_parent);
+}
+
+// NOTE: Returns the leaf, which is the handle for move and remove
+static GJAABBTreeNode*
+gj_aabb_tree_insert(GJAABBTree* tree, V3f min, V3f max, u32 user)
+{
+    GJAABBTreeNode* leaf = gj__aabb_tree_allocate_node(tree);
+    leaf->min  = V3_add(min, -tree->margin);
+    leaf->max  = V3_add(max,  tree->margin);
+    leaf->user = user;
+    gj__aabb_tree_insert_leaf(tree, leaf);
+    tree->leaf_count++;
+    return leaf;
+}
+
+static void
+gj_aabb_tree_remove(GJAABBTree* tree, GJAABBTreeNode* leaf)
+{
+    gj_AssertDebug(gj__aabb_tree_is_leaf(leaf) && leaf->height == 0);
+    gj__aabb_tree_remove_leaf(tree, leaf);
+    gj__aabb_tree_free_node(tree, leaf);
+    tree->leaf_count--;
+}
+
+// NOTE: Nothing happens while [min, max] stays inside the fat box, returns
+//       whether the leaf had to be reinserted
+static b32
+gj_aabb_tree_move(GJAABBTree* tree, GJAABBTreeNode* leaf, V3f min, V3f max)
+{
+    gj_AssertDebug(gj__aabb_tree_is_leaf(leaf) && leaf->height == 0);
+    if (leaf->min.x <= min.x && leaf->min.y <= min.y && leaf->min.z <= min.z &&
+        max.x <= leaf->max.x && max.y <= leaf->max.y && max.z <= leaf->max.z) return gj_False;
+
+    gj__aabb_tree_remove_leaf(tree, leaf);
+    leaf->min = V3_add(min, -tree->margin);
+    leaf->max = V3_add(max,  tree->margin);
+    gj__aabb_tree_insert_leaf(tree, leaf);
+    return gj_True;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Queries
+///////////////////////////////////////////////////////////////////////////
+// NOTE: The queries write up to out_max user values and return how many
+//       matched in total, a result above out_max means out was cut short.
+//       They test the fat boxes, so the results are candidates for an exact
+//       test.
+
+// NOTE: A depth first walk holds at most one pending sibling per level, so
+//       height + 2 entries always fit
+static GJAABBTreeNode**
+gj__aabb_tree_query_stack(GJAABBTree* tree, GJAABBTreeNode** local_stack, u32* stack_size)
+{
+    *stack_size = (u32)tree->root->height + 2;
+    if (*stack_size <= GJ_AABB_TREE_STACK_SIZE) return local_stack;
+    return push_array_no_zero(tree->arena, GJAABBTreeNode*, *stack_size);
+}
+
+// NOTE: Leaves whose fat box overlaps [min, max]
+static u32
+gj_aabb_tree_query_aabb(GJAABBTree* tree, V3f min, V3f max, u32* out, u32 out_max)
+{
+    if (!tree->root) return 0;
+    GJAABBTreeNode* local_stack[GJ_AABB_TREE_STACK_SIZE];
+    BeginTemporaryMemoryBlock(tree->arena);
+    u32 stack_size;
+    GJAABBTreeNode** stack = gj__aabb_tree_query_stack(tree, local_stack, &stack_size);
+    u32 stack_count = 0;
+    u32 found = 0;
+    stack[stack_count++] = tree->root;
+    while (stack_count)
+    {
+        GJAABBTreeNode* node = stack[--stack_count];
+        if (!gj__aabb_tree_overlap(node->min, node->max, min, max)) continue;
+        if (gj__aabb_tree_is_leaf(node))
+        {
+            if (found < out_max) out[found] = node->user;
+            found++;
+            continue;
+        }
+        gj_AssertDebug(stack_count + 2 <= stack_size);
+        stack[stack_count++] = node->child2;
+        stack[stack_count++] = node->child1;
+    }
+    EndTemporaryMemoryBlock(tree->arena);
+    return found;
+}
+
+// NOTE: Leaves whose fat box the ray passes through within [0, t_max],
+//       nearest node first but not sorted. Uses the RaySlab test, the
+//       origin being inside a box counts as a hit (ray_box_intersection
+//       rejects that, which would cull the whole tree from inside the
+//       root) and axis parallel rays are handled.
+static u32
+gj_aabb_tree_query_ray(GJAABBTree* tree, V3f ray_origin, V3f ray_direction, u32* out, u32 out_max, f32 t_max = FLT_MAX)
+{
+    if (!tree->root) return 0;
+    RaySlab ray = RaySlab_create(ray_origin, ray_direction);
+    GJAABBTreeNode* local_stack[GJ_AABB_TREE_STACK_SIZE];
+    BeginTemporaryMemoryBlock(tree->arena);
+    u32 stack_size;
+    GJAABBTreeNode** stack = gj__aabb_tree_query_stack(tree, local_stack, &stack_size);
+    u32 stack_count = 0;
+    u32 found = 0;
+    stack[stack_count++] = tree->root;
+    while (stack_count)
+    {
+        GJAABBTreeNode* node = stack[--stack_count];
+        f32 t_enter = 0.0f;
+        f32 t_exit  = t_max;
+        RaySlab__axis(node->min.x, node->max.x, ray.origin.x, ray.inverse_direction.x, &t_enter, &t_exit);
+        RaySlab__axis(node->min.y, node->max.y, ray.origin.y, ray.inverse_direction.y, &t_enter, &t_exit);
+        RaySlab__axis(node->min.z, node->max.z, ray.origin.z, ray.inverse_direction.z, &t_enter, &t_exit);
+        if (t_enter > t_exit) continue;
+        if (gj__aabb_tree_is_leaf(node))
+        {
+            if (found < out_max) out[found] = node->user;
+            found++;
+            continue;
+        }
+        gj_AssertDebug(stack_count + 2 <= stack_size);
+        stack[stack_count++] = node->child2;
+        stack[stack_count++] = node->child1;
+    }
+    EndTemporaryMemoryBlock(tree->arena);
+    return found;
+}
+
+typedef struct GJAABBTreePairQuery
+{
+    GJAABBTreePair* pairs;
+    u32             pair_max;
+    u32             found;
+} GJAABBTreePairQuery;
+
+// NOTE: Every overlapping leaf pair with one leaf under a and one under b
+static void
+gj__aabb_tree_pairs_between(GJAABBTreePairQuery* query, GJAABBTreeNode* a, GJAABBTreeNode* b)
+{
+    if (!gj__aabb_tree_overlap(a->min, a->max, b->min, b->max)) return;
+    b32 a_leaf = gj__aabb_tree_is_leaf(a);
+    b32 b_leaf = gj__aabb_tree_is_leaf(b);
+    if (a_leaf && b_leaf)
+    {
+        if (query->found < query->pair_max)
+        {
+            query->pairs[query->found].a = gj_Min(a->user, b->user);
+            query->pairs[query->found].b = gj_Max(a->user, b->user);
+        }
+        query->found++;
+    }
+    else if (b_leaf || (!a_leaf && a->height >= b->height))
+    {
+        gj__aabb_tree_pairs_between(query, a->child1, b);
+        gj__aabb_tree_pairs_between(query, a->child2, b);
+    }
+    else
+    {
+        gj__aabb_tree_pairs_between(query, a, b->child1);
+        gj__aabb_tree_pairs_between(query, a, b->child2);
+    }
+}
+
+static void
+gj__aabb_tree_pairs_within(GJAABBTreePairQuery* query, GJAABBTreeNode* node)
+{
+    if (gj__aabb_tree_is_leaf(node)) return;
+    gj__aabb_tree_pairs_between(query, node->child1, node->child2);
+    gj__aabb_tree_pairs_within(query, node->child1);
+    gj__aabb_tree_pairs_within(query, node->child2);
+}
+
+// NOTE: Every pair of leaves whose fat boxes overlap, once each with a <= b,
+//       found by descending the tree against itself so subtrees that don't
+//       touch are skipped as a whole. Recursion depth is bounded by twice
+//       the height.
+static u32
+gj_aabb_tree_query_pairs(GJAABBTree* tree, GJAABBTreePair* pairs, u32 pair_max)
+{
+    GJAABBTreePairQuery query = {pairs, pair_max, 0};
+    if (tree->root) gj__aabb_tree_pairs_within(&query, tree->root);
+    return query.found;
+}
+
+inline s32
+gj_aabb_tree_height(GJAABBTree* tree)
+{
+    return tree->root ? tree->root->height : 0;
+}
+
+#endif
@@ -7,7 +7,11 @@
 
 #include <string> // stod
 #include <cstring> // memset
+#if defined(_MSC_VER)
 #include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////
 // Types
@@ -38,6 +42,23 @@ typedef u8 one_byte;
 #define gj_True  1
 #define gj_False 0
 
+///////////////////////////////////////////////////////////////////////////
+// SIMD
+///////////////////////////////////////////////////////////////////////////
+// NOTE: Picked at compile time. GCC/Clang define the feature macros with
+//       -msse4.2/-mavx2 (or -march=...), MSVC only with /arch:AVX. These can
+//       also be defined before including this file since MSVC compiles the
+//       intrinsics without any /arch flag.
+#if !defined(GJ_SSE42) && (defined(__SSE4_2__) || defined(__AVX__))
+#define GJ_SSE42 1
+#endif
+#if !defined(GJ_AVX2) && defined(__AVX2__)
+#define GJ_AVX2 1
+#endif
+#if !defined(GJ_AVX) && (defined(__AVX__) || defined(GJ_AVX2))
+#define GJ_AVX 1
+#endif
+
 ///////////////////////////////////////////////////////////////////////////
 // sprintf
 ///////////////////////////////////////////////////////////////////////////
@@ -147,7 +168,7 @@ gj_safe_cast_s32_to_u32(s32 value)
 
 inline u32*
 gj_safe_cast_s32_to_u32(s32* value)
-{ gj_AssertDebug(value >= 0); return (u32*)value; }
+{ gj_AssertDebug(*value >= 0); return (u32*)value; }
 
 #define gj_IsCharacter(c) ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
 #define gj_IsDigit(c) (c >= '0' && c <= '9')
@@ -159,8 +180,8 @@ gj_safe_cast_s32_to_u32(s32* value)
 #define FLT_MAX 3.402823466e+38F /* max value */
 #define FLT_MIN 1.175494351e-38F /* min positive value */
 
-#define gj_SwapVar(type, x, y) do {##type __tmp = (x); (x) = (y); (y) = __tmp;} while(gj_False)
-#define gj_SwapArray(array, type, i, j) do {##type __tmp = array[i]; array[i] = array[j]; array[j] = __tmp;} while(gj_False)
+#define gj_SwapVar(type, x, y) do {type __tmp = (x); (x) = (y); (y) = __tmp;} while(gj_False)
+#define gj_SwapArray(array, type, i, j) do {type __tmp = array[i]; array[i] = array[j]; array[j] = __tmp;} while(gj_False)
 
 #define gj_ZeroMem(Mem, Size)    do { memset(Mem, 0, Size); } while(gj_False)
 #define gj__ZeroStruct(Struct)       do { memset(&Struct, 0, sizeof(Struct)); } while(gj_False)
@@ -179,6 +200,34 @@ inline void gj_unset_flag (u32* flags, u32 flag) { *flags &= ~(gj_BitmaskU32 & (
 inline b32  gj_get_flag   (u32 flags,  u32 flag) { return flags & (1 << flag); }
 inline void gj_toggle_flag(u32* flags, u32 flag) { *flags ^= (1 << flag); }
 
+// NOTE: Undefined for value == 0
+#if defined(_MSC_VER)
+inline u32 gj_count_trailing_zeros_u32(u32 value) { unsigned long index; _BitScanForward(&index, value);   return (u32)index; }
+inline u32 gj_count_trailing_zeros_u64(u64 value) { unsigned long index; _BitScanForward64(&index, value); return (u32)index; }
+inline u32 gj_count_leading_zeros_u32 (u32 value) { unsigned long index; _BitScanReverse(&index, value);   return 31 - (u32)index; }
+inline u32 gj_count_leading_zeros_u64 (u64 value) { unsigned long index; _BitScanReverse64(&index, value); return 63 - (u32)index; }
+#else
+inline u32 gj_count_trailing_zeros_u32(u32 value) { return (u32)__builtin_ctz(value); }
+inline u32 gj_count_trailing_zeros_u64(u64 value) { return (u32)__builtin_ctzll(value); }
+inline u32 gj_count_leading_zeros_u32 (u32 value) { return (u32)__builtin_clz(value); }
+inline u32 gj_count_leading_zeros_u64 (u64 value) { return (u32)__builtin_clzll(value); }
+#endif
+
+#if defined(GJ_SSE42)
+inline u32 gj_popcount_u64(u64 value) { return (u32)_mm_popcnt_u64(value); }
+#elif defined(_MSC_VER)
+// NOTE: __popcnt64 needs the POPCNT instruction too, count by hand
+inline u32 gj_popcount_u64(u64 value)
+{
+    value = value - ((value >> 1) & 0x5555555555555555ull);
+    value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (u32)((value * 0x0101010101010101ull) >> 56);
+}
+#else
+inline u32 gj_popcount_u64(u64 value) { return (u32)__builtin_popcountll(value); }
+#endif
+
 ///////////////////////////////////////////////////////////////////////////
 // TimedBlock
 ///////////////////////////////////////////////////////////////////////////
@@ -438,6 +487,489 @@ static s32 gj_parse_word(const char* s, char* dst, int dst_size)
     return result;
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Hash
+///////////////////////////////////////////////////////////////////////////
+// NOTE: gj_hash64 is XXH64 (https://github.com/Cyan4973/xxHash), same output
+//       as the reference implementation for the same seed.
+#define GJ_HASH64_PRIME_1 0x9E3779B185EBCA87ull
+#define GJ_HASH64_PRIME_2 0xC2B2AE3D27D4EB4Full
+#define GJ_HASH64_PRIME_3 0x165667B19E3779F9ull
+#define GJ_HASH64_PRIME_4 0x85EBCA77C2B2AE63ull
+#define GJ_HASH64_PRIME_5 0x27D4EB2F165667C5ull
+
+inline u64 gj_rotl64(u64 x, u32 r) { return (x << r) | (x >> (64 - r)); }
+inline u64 gj_read_u64(const u8* p) { u64 result; memcpy(&result, p, sizeof(result)); return result; }
+inline u32 gj_read_u32(const u8* p) { u32 result; memcpy(&result, p, sizeof(result)); return result; }
+
+inline u64
+gj_hash64_round(u64 acc, u64 input)
+{
+    acc += input * GJ_HASH64_PRIME_2;
+    acc  = gj_rotl64(acc, 31);
+    acc *= GJ_HASH64_PRIME_1;
+    return acc;
+}
+
+inline u64
+gj_hash64_merge_round(u64 acc, u64 value)
+{
+    acc ^= gj_hash64_round(0, value);
+    return acc * GJ_HASH64_PRIME_1 + GJ_HASH64_PRIME_4;
+}
+
+// NOTE: Hashes the last (< 32) bytes and mixes the result
+static u64
+gj_hash64_finalize(u64 h, const u8* p, size_t size)
+{
+    for (; size >= 8; size -= 8, p += 8)
+    {
+        h ^= gj_hash64_round(0, gj_read_u64(p));
+        h  = gj_rotl64(h, 27) * GJ_HASH64_PRIME_1 + GJ_HASH64_PRIME_4;
+    }
+    if (size >= 4)
+    {
+        h ^= (u64)gj_read_u32(p) * GJ_HASH64_PRIME_1;
+        h  = gj_rotl64(h, 23) * GJ_HASH64_PRIME_2 + GJ_HASH64_PRIME_3;
+        size -= 4; p += 4;
+    }
+    for (; size > 0; size--, p++)
+    {
+        h ^= (*p) * GJ_HASH64_PRIME_5;
+        h  = gj_rotl64(h, 11) * GJ_HASH64_PRIME_1;
+    }
+
+    h ^= h >> 33;
+    h *= GJ_HASH64_PRIME_2;
+    h ^= h >> 29;
+    h *= GJ_HASH64_PRIME_3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline u64
+gj_hash64_merge_accumulators(u64 v[4])
+{
+    u64 h = gj_rotl64(v[0], 1) + gj_rotl64(v[1], 7) + gj_rotl64(v[2], 12) + gj_rotl64(v[3], 18);
+    h = gj_hash64_merge_round(h, v[0]);
+    h = gj_hash64_merge_round(h, v[1]);
+    h = gj_hash64_merge_round(h, v[2]);
+    h = gj_hash64_merge_round(h, v[3]);
+    return h;
+}
+
+static u64
+gj_hash64(const void* data, size_t size, u64 seed)
+{
+    const u8* p   = (const u8*)data;
+    const u8* end = p + size;
+    u64 h;
+
+    if (size >= 32)
+    {
+        u64 v[4] = {seed + GJ_HASH64_PRIME_1 + GJ_HASH64_PRIME_2, seed + GJ_HASH64_PRIME_2, seed, seed - GJ_HASH64_PRIME_1};
+        for (; p + 32 <= end; p += 32)
+        {
+            v[0] = gj_hash64_round(v[0], gj_read_u64(p));
+            v[1] = gj_hash64_round(v[1], gj_read_u64(p + 8));
+            v[2] = gj_hash64_round(v[2], gj_read_u64(p + 16));
+            v[3] = gj_hash64_round(v[3], gj_read_u64(p + 24));
+        }
+        h = gj_hash64_merge_accumulators(v);
+    }
+    else
+    {
+        h = seed + GJ_HASH64_PRIME_5;
+    }
+
+    h += (u64)size;
+    return gj_hash64_finalize(h, p, end - p);
+}
+
+inline u64 gj_hash64(const void* data, size_t size) { return gj_hash64(data, size, 0); }
+inline u64 gj_hash64(const char* s)                 { return gj_hash64(s, strlen(s), 0); }
+
+// NOTE: Streaming version of gj_hash64, feeding the same bytes in any number
+//       of gj_hash64_update calls gives the same hash as the one-shot call
+typedef struct GJHash64State
+{
+    u64 v[4];
+    u64 total_size;
+    u64 seed;
+    u8  buffer[32];
+    u32 buffer_size;
+} GJHash64State;
+
+inline void
+gj_hash64_begin(GJHash64State* state, u64 seed = 0)
+{
+    gj__ZeroStruct(*state);
+    state->seed = seed;
+    state->v[0] = seed + GJ_HASH64_PRIME_1 + GJ_HASH64_PRIME_2;
+    state->v[1] = seed + GJ_HASH64_PRIME_2;
+    state->v[2] = seed;
+    state->v[3] = seed - GJ_HASH64_PRIME_1;
+}
+
+static void
+gj_hash64_update(GJHash64State* state, const void* data, size_t size)
+{
+    const u8* p   = (const u8*)data;
+    const u8* end = p + size;
+    state->total_size += size;
+
+    if (state->buffer_size + size < 32)
+    {
+        memcpy(state->buffer + state->buffer_size, p, size);
+        state->buffer_size += (u32)size;
+        return;
+    }
+
+    if (state->buffer_size > 0)
+    {
+        u32 fill = 32 - state->buffer_size;
+        memcpy(state->buffer + state->buffer_size, p, fill);
+        p += fill;
+        for (u32 lane = 0; lane < 4; lane++)
+        {
+            state->v[lane] = gj_hash64_round(state->v[lane], gj_read_u64(state->buffer + lane * 8));
+        }
+        state->buffer_size = 0;
+    }
+
+    for (; p + 32 <= end; p += 32)
+    {
+        state->v[0] = gj_hash64_round(state->v[0], gj_read_u64(p));
+        state->v[1] = gj_hash64_round(state->v[1], gj_read_u64(p + 8));
+        state->v[2] = gj_hash64_round(state->v[2], gj_read_u64(p + 16));
+        state->v[3] = gj_hash64_round(state->v[3], gj_read_u64(p + 24));
+    }
+
+    state->buffer_size = (u32)(end - p);
+    memcpy(state->buffer, p, state->buffer_size);
+}
+
+inline u64
+gj_hash64_end(GJHash64State* state)
+{
+    u64 h = state->total_size >= 32 ? gj_hash64_merge_accumulators(state->v) : state->seed + GJ_HASH64_PRIME_5;
+    h += state->total_size;
+    return gj_hash64_finalize(h, state->buffer, state->buffer_size);
+}
+
+// NOTE: CRC-32C (Castagnoli). Pass the previous result as crc to continue a
+//       checksum over several buffers, 0 to start a new one. Uses the SSE4.2
+//       crc32 instruction when GJ_SSE42 is defined and slicing-by-8 otherwise.
+#define GJ_CRC32C_POLYNOMIAL 0x82F63B78
+
+#if !defined(GJ_SSE42)
+// NOTE: Slicing-by-8 tables, table[0] is the bytewise table and
+//       table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF].
+//       Constant so that threads never see a partly built table.
+global_variable const u32 g_gj_crc32c_table[8][256] =
+{
+    {
+        0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4, 0xC79A971F, 0x35F1141C, 0x26A1E7E8, 0xD4CA64EB,
+        0x8AD958CF, 0x78B2DBCC, 0x6BE22838, 0x9989AB3B, 0x4D43CFD0, 0xBF284CD3, 0xAC78BF27, 0x5E133C24,
+        0x105EC76F, 0xE235446C, 0xF165B798, 0x030E349B, 0xD7C45070, 0x25AFD373, 0x36FF2087, 0xC494A384,
+        0x9A879FA0, 0x68EC1CA3, 0x7BBCEF57, 0x89D76C54, 0x5D1D08BF, 0xAF768BBC, 0xBC267848, 0x4E4DFB4B,
+        0x20BD8EDE, 0xD2D60DDD, 0xC186FE29, 0x33ED7D2A, 0xE72719C1, 0x154C9AC2, 0x061C6936, 0xF477EA35,
+        0xAA64D611, 0x580F5512, 0x4B5FA6E6, 0xB93425E5, 0x6DFE410E, 0x9F95C20D, 0x8CC531F9, 0x7EAEB2FA,
+        0x30E349B1, 0xC288CAB2, 0xD1D83946, 0x23B3BA45, 0xF779DEAE, 0x05125DAD, 0x1642AE59, 0xE4292D5A,
+        0xBA3A117E, 0x4851927D, 0x5B016189, 0xA96AE28A, 0x7DA08661, 0x8FCB0562, 0x9C9BF696, 0x6EF07595,
+        0x417B1DBC, 0xB3109EBF, 0xA0406D4B, 0x522BEE48, 0x86E18AA3, 0x748A09A0, 0x67DAFA54, 0x95B17957,
+        0xCBA24573, 0x39C9C670, 0x2A993584, 0xD8F2B687, 0x0C38D26C, 0xFE53516F, 0xED03A29B, 0x1F682198,
+        0x5125DAD3, 0xA34E59D0, 0xB01EAA24, 0x42752927, 0x96BF4DCC, 0x64D4CECF, 0x77843D3B, 0x85EFBE38,
+        0xDBFC821C, 0x2997011F, 0x3AC7F2EB, 0xC8AC71E8, 0x1C661503, 0xEE0D9600, 0xFD5D65F4, 0x0F36E6F7,
+        0x61C69362, 0x93AD1061, 0x80FDE395, 0x72966096, 0xA65C047D, 0x5437877E, 0x4767748A, 0xB50CF789,
+        0xEB1FCBAD, 0x197448AE, 0x0A24BB5A, 0xF84F3859, 0x2C855CB2, 0xDEEEDFB1, 0xCDBE2C45, 0x3FD5AF46,
+        0x7198540D, 0x83F3D70E, 0x90A324FA, 0x62C8A7F9, 0xB602C312, 0x44694011, 0x5739B3E5, 0xA55230E6,
+        0xFB410CC2, 0x092A8FC1, 0x1A7A7C35, 0xE811FF36, 0x3CDB9BDD, 0xCEB018DE, 0xDDE0EB2A, 0x2F8B6829,
+        0x82F63B78, 0x709DB87B, 0x63CD4B8F, 0x91A6C88C, 0x456CAC67, 0xB7072F64, 0xA457DC90, 0x563C5F93,
+        0x082F63B7, 0xFA44E0B4, 0xE9141340, 0x1B7F9043, 0xCFB5F4A8, 0x3DDE77AB, 0x2E8E845F, 0xDCE5075C,
+        0x92A8FC17, 0x60C37F14, 0x73938CE0, 0x81F80FE3, 0x55326B08, 0xA759E80B, 0xB4091BFF, 0x466298FC,
+        0x1871A4D8, 0xEA1A27DB, 0xF94AD42F, 0x0B21572C, 0xDFEB33C7, 0x2D80B0C4, 0x3ED04330, 0xCCBBC033,
+        0xA24BB5A6, 0x502036A5, 0x4370C551, 0xB11B4652, 0x65D122B9, 0x97BAA1BA, 0x84EA524E, 0x7681D14D,
+        0x2892ED69, 0xDAF96E6A, 0xC9A99D9E, 0x3BC21E9D, 0xEF087A76, 0x1D63F975, 0x0E330A81, 0xFC588982,
+        0xB21572C9, 0x407EF1CA, 0x532E023E, 0xA145813D, 0x758FE5D6, 0x87E466D5, 0x94B49521, 0x66DF1622,
+        0x38CC2A06, 0xCAA7A905, 0xD9F75AF1, 0x2B9CD9F2, 0xFF56BD19, 0x0D3D3E1A, 0x1E6DCDEE, 0xEC064EED,
+        0xC38D26C4, 0x31E6A5C7, 0x22B65633, 0xD0DDD530, 0x0417B1DB, 0xF67C32D8, 0xE52CC12C, 0x1747422F,
+        0x49547E0B, 0xBB3FFD08, 0xA86F0EFC, 0x5A048DFF, 0x8ECEE914, 0x7CA56A17, 0x6FF599E3, 0x9D9E1AE0,
+        0xD3D3E1AB, 0x21B862A8, 0x32E8915C, 0xC083125F, 0x144976B4, 0xE622F5B7, 0xF5720643, 0x07198540,
+        0x590AB964, 0xAB613A67, 0xB831C993, 0x4A5A4A90, 0x9E902E7B, 0x6CFBAD78, 0x7FAB5E8C, 0x8DC0DD8F,
+        0xE330A81A, 0x115B2B19, 0x020BD8ED, 0xF0605BEE, 0x24AA3F05, 0xD6C1BC06, 0xC5914FF2, 0x37FACCF1,
+        0x69E9F0D5, 0x9B8273D6, 0x88D28022, 0x7AB90321, 0xAE7367CA, 0x5C18E4C9, 0x4F48173D, 0xBD23943E,
+        0xF36E6F75, 0x0105EC76, 0x12551F82, 0xE03E9C81, 0x34F4F86A, 0xC69F7B69, 0xD5CF889D, 0x27A40B9E,
+        0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E, 0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351,
+    },
+    {
+        0x00000000, 0x13A29877, 0x274530EE, 0x34E7A899, 0x4E8A61DC, 0x5D28F9AB, 0x69CF5132, 0x7A6DC945,
+        0x9D14C3B8, 0x8EB65BCF, 0xBA51F356, 0xA9F36B21, 0xD39EA264, 0xC03C3A13, 0xF4DB928A, 0xE7790AFD,
+        0x3FC5F181, 0x2C6769F6, 0x1880C16F, 0x0B225918, 0x714F905D, 0x62ED082A, 0x560AA0B3, 0x45A838C4,
+        0xA2D13239, 0xB173AA4E, 0x859402D7, 0x96369AA0, 0xEC5B53E5, 0xFFF9CB92, 0xCB1E630B, 0xD8BCFB7C,
+        0x7F8BE302, 0x6C297B75, 0x58CED3EC, 0x4B6C4B9B, 0x310182DE, 0x22A31AA9, 0x1644B230, 0x05E62A47,
+        0xE29F20BA, 0xF13DB8CD, 0xC5DA1054, 0xD6788823, 0xAC154166, 0xBFB7D911, 0x8B507188, 0x98F2E9FF,
+        0x404E1283, 0x53EC8AF4, 0x670B226D, 0x74A9BA1A, 0x0EC4735F, 0x1D66EB28, 0x298143B1, 0x3A23DBC6,
+        0xDD5AD13B, 0xCEF8494C, 0xFA1FE1D5, 0xE9BD79A2, 0x93D0B0E7, 0x80722890, 0xB4958009, 0xA737187E,
+        0xFF17C604, 0xECB55E73, 0xD852F6EA, 0xCBF06E9D, 0xB19DA7D8, 0xA23F3FAF, 0x96D89736, 0x857A0F41,
+        0x620305BC, 0x71A19DCB, 0x45463552, 0x56E4AD25, 0x2C896460, 0x3F2BFC17, 0x0BCC548E, 0x186ECCF9,
+        0xC0D23785, 0xD370AFF2, 0xE797076B, 0xF4359F1C, 0x8E585659, 0x9DFACE2E, 0xA91D66B7, 0xBABFFEC0,
+        0x5DC6F43D, 0x4E646C4A, 0x7A83C4D3, 0x69215CA4, 0x134C95E1, 0x00EE0D96, 0x3409A50F, 0x27AB3D78,
+        0x809C2506, 0x933EBD71, 0xA7D915E8, 0xB47B8D9F, 0xCE1644DA, 0xDDB4DCAD, 0xE9537434, 0xFAF1EC43,
+        0x1D88E6BE, 0x0E2A7EC9, 0x3ACDD650, 0x296F4E27, 0x53028762, 0x40A01F15, 0x7447B78C, 0x67E52FFB,
+        0xBF59D487, 0xACFB4CF0, 0x981CE469, 0x8BBE7C1E, 0xF1D3B55B, 0xE2712D2C, 0xD69685B5, 0xC5341DC2,
+        0x224D173F, 0x31EF8F48, 0x050827D1, 0x16AABFA6, 0x6CC776E3, 0x7F65EE94, 0x4B82460D, 0x5820DE7A,
+        0xFBC3FAF9, 0xE861628E, 0xDC86CA17, 0xCF245260, 0xB5499B25, 0xA6EB0352, 0x920CABCB, 0x81AE33BC,
+        0x66D73941, 0x7575A136, 0x419209AF, 0x523091D8, 0x285D589D, 0x3BFFC0EA, 0x0F186873, 0x1CBAF004,
+        0xC4060B78, 0xD7A4930F, 0xE3433B96, 0xF0E1A3E1, 0x8A8C6AA4, 0x992EF2D3, 0xADC95A4A, 0xBE6BC23D,
+        0x5912C8C0, 0x4AB050B7, 0x7E57F82E, 0x6DF56059, 0x1798A91C, 0x043A316B, 0x30DD99F2, 0x237F0185,
+        0x844819FB, 0x97EA818C, 0xA30D2915, 0xB0AFB162, 0xCAC27827, 0xD960E050, 0xED8748C9, 0xFE25D0BE,
+        0x195CDA43, 0x0AFE4234, 0x3E19EAAD, 0x2DBB72DA, 0x57D6BB9F, 0x447423E8, 0x70938B71, 0x63311306,
+        0xBB8DE87A, 0xA82F700D, 0x9CC8D894, 0x8F6A40E3, 0xF50789A6, 0xE6A511D1, 0xD242B948, 0xC1E0213F,
+        0x26992BC2, 0x353BB3B5, 0x01DC1B2C, 0x127E835B, 0x68134A1E, 0x7BB1D269, 0x4F567AF0, 0x5CF4E287,
+        0x04D43CFD, 0x1776A48A, 0x23910C13, 0x30339464, 0x4A5E5D21, 0x59FCC556, 0x6D1B6DCF, 0x7EB9F5B8,
+        0x99C0FF45, 0x8A626732, 0xBE85CFAB, 0xAD2757DC, 0xD74A9E99, 0xC4E806EE, 0xF00FAE77, 0xE3AD3600,
+        0x3B11CD7C, 0x28B3550B, 0x1C54FD92, 0x0FF665E5, 0x759BACA0, 0x663934D7, 0x52DE9C4E, 0x417C0439,
+        0xA6050EC4, 0xB5A796B3, 0x81403E2A, 0x92E2A65D, 0xE88F6F18, 0xFB2DF76F, 0xCFCA5FF6, 0xDC68C781,
+        0x7B5FDFFF, 0x68FD4788, 0x5C1AEF11, 0x4FB87766, 0x35D5BE23, 0x26772654, 0x12908ECD, 0x013216BA,
+        0xE64B1C47, 0xF5E98430, 0xC10E2CA9, 0xD2ACB4DE, 0xA8C17D9B, 0xBB63E5EC, 0x8F844D75, 0x9C26D502,
+        0x449A2E7E, 0x5738B609, 0x63DF1E90, 0x707D86E7, 0x0A104FA2, 0x19B2D7D5, 0x2D557F4C, 0x3EF7E73B,
+        0xD98EEDC6, 0xCA2C75B1, 0xFECBDD28, 0xED69455F, 0x97048C1A, 0x84A6146D, 0xB041BCF4, 0xA3E32483,
+    },
+    {
+        0x00000000, 0xA541927E, 0x4F6F520D, 0xEA2EC073, 0x9EDEA41A, 0x3B9F3664, 0xD1B1F617, 0x74F06469,
+        0x38513EC5, 0x9D10ACBB, 0x773E6CC8, 0xD27FFEB6, 0xA68F9ADF, 0x03CE08A1, 0xE9E0C8D2, 0x4CA15AAC,
+        0x70A27D8A, 0xD5E3EFF4, 0x3FCD2F87, 0x9A8CBDF9, 0xEE7CD990, 0x4B3D4BEE, 0xA1138B9D, 0x045219E3,
+        0x48F3434F, 0xEDB2D131, 0x079C1142, 0xA2DD833C, 0xD62DE755, 0x736C752B, 0x9942B558, 0x3C032726,
+        0xE144FB14, 0x4405696A, 0xAE2BA919, 0x0B6A3B67, 0x7F9A5F0E, 0xDADBCD70, 0x30F50D03, 0x95B49F7D,
+        0xD915C5D1, 0x7C5457AF, 0x967A97DC, 0x333B05A2, 0x47CB61CB, 0xE28AF3B5, 0x08A433C6, 0xADE5A1B8,
+        0x91E6869E, 0x34A714E0, 0xDE89D493, 0x7BC846ED, 0x0F382284, 0xAA79B0FA, 0x40577089, 0xE516E2F7,
+        0xA9B7B85B, 0x0CF62A25, 0xE6D8EA56, 0x43997828, 0x37691C41, 0x92288E3F, 0x78064E4C, 0xDD47DC32,
+        0xC76580D9, 0x622412A7, 0x880AD2D4, 0x2D4B40AA, 0x59BB24C3, 0xFCFAB6BD, 0x16D476CE, 0xB395E4B0,
+        0xFF34BE1C, 0x5A752C62, 0xB05BEC11, 0x151A7E6F, 0x61EA1A06, 0xC4AB8878, 0x2E85480B, 0x8BC4DA75,
+        0xB7C7FD53, 0x12866F2D, 0xF8A8AF5E, 0x5DE93D20, 0x29195949, 0x8C58CB37, 0x66760B44, 0xC337993A,
+        0x8F96C396, 0x2AD751E8, 0xC0F9919B, 0x65B803E5, 0x1148678C, 0xB409F5F2, 0x5E273581, 0xFB66A7FF,
+        0x26217BCD, 0x8360E9B3, 0x694E29C0, 0xCC0FBBBE, 0xB8FFDFD7, 0x1DBE4DA9, 0xF7908DDA, 0x52D11FA4,
+        0x1E704508, 0xBB31D776, 0x511F1705, 0xF45E857B, 0x80AEE112, 0x25EF736C, 0xCFC1B31F, 0x6A802161,
+        0x56830647, 0xF3C29439, 0x19EC544A, 0xBCADC634, 0xC85DA25D, 0x6D1C3023, 0x8732F050, 0x2273622E,
+        0x6ED23882, 0xCB93AAFC, 0x21BD6A8F, 0x84FCF8F1, 0xF00C9C98, 0x554D0EE6, 0xBF63CE95, 0x1A225CEB,
+        0x8B277743, 0x2E66E53D, 0xC448254E, 0x6109B730, 0x15F9D359, 0xB0B84127, 0x5A968154, 0xFFD7132A,
+        0xB3764986, 0x1637DBF8, 0xFC191B8B, 0x595889F5, 0x2DA8ED9C, 0x88E97FE2, 0x62C7BF91, 0xC7862DEF,
+        0xFB850AC9, 0x5EC498B7, 0xB4EA58C4, 0x11ABCABA, 0x655BAED3, 0xC01A3CAD, 0x2A34FCDE, 0x8F756EA0,
+        0xC3D4340C, 0x6695A672, 0x8CBB6601, 0x29FAF47F, 0x5D0A9016, 0xF84B0268, 0x1265C21B, 0xB7245065,
+        0x6A638C57, 0xCF221E29, 0x250CDE5A, 0x804D4C24, 0xF4BD284D, 0x51FCBA33, 0xBBD27A40, 0x1E93E83E,
+        0x5232B292, 0xF77320EC, 0x1D5DE09F, 0xB81C72E1, 0xCCEC1688, 0x69AD84F6, 0x83834485, 0x26C2D6FB,
+        0x1AC1F1DD, 0xBF8063A3, 0x55AEA3D0, 0xF0EF31AE, 0x841F55C7, 0x215EC7B9, 0xCB7007CA, 0x6E3195B4,
+        0x2290CF18, 0x87D15D66, 0x6DFF9D15, 0xC8BE0F6B, 0xBC4E6B02, 0x190FF97C, 0xF321390F, 0x5660AB71,
+        0x4C42F79A, 0xE90365E4, 0x032DA597, 0xA66C37E9, 0xD29C5380, 0x77DDC1FE, 0x9DF3018D, 0x38B293F3,
+        0x7413C95F, 0xD1525B21, 0x3B7C9B52, 0x9E3D092C, 0xEACD6D45, 0x4F8CFF3B, 0xA5A23F48, 0x00E3AD36,
+        0x3CE08A10, 0x99A1186E, 0x738FD81D, 0xD6CE4A63, 0xA23E2E0A, 0x077FBC74, 0xED517C07, 0x4810EE79,
+        0x04B1B4D5, 0xA1F026AB, 0x4BDEE6D8, 0xEE9F74A6, 0x9A6F10CF, 0x3F2E82B1, 0xD50042C2, 0x7041D0BC,
+        0xAD060C8E, 0x08479EF0, 0xE2695E83, 0x4728CCFD, 0x33D8A894, 0x96993AEA, 0x7CB7FA99, 0xD9F668E7,
+        0x9557324B, 0x3016A035, 0xDA386046, 0x7F79F238, 0x0B899651, 0xAEC8042F, 0x44E6C45C, 0xE1A75622,
+        0xDDA47104, 0x78E5E37A, 0x92CB2309, 0x378AB177, 0x437AD51E, 0xE63B4760, 0x0C158713, 0xA954156D,
+        0xE5F54FC1, 0x40B4DDBF, 0xAA9A1DCC, 0x0FDB8FB2, 0x7B2BEBDB, 0xDE6A79A5, 0x3444B9D6, 0x91052BA8,
+    },
+    {
+        0x00000000, 0xDD45AAB8, 0xBF672381, 0x62228939, 0x7B2231F3, 0xA6679B4B, 0xC4451272, 0x1900B8CA,
+        0xF64463E6, 0x2B01C95E, 0x49234067, 0x9466EADF, 0x8D665215, 0x5023F8AD, 0x32017194, 0xEF44DB2C,
+        0xE964B13D, 0x34211B85, 0x560392BC, 0x8B463804, 0x924680CE, 0x4F032A76, 0x2D21A34F, 0xF06409F7,
+        0x1F20D2DB, 0xC2657863, 0xA047F15A, 0x7D025BE2, 0x6402E328, 0xB9474990, 0xDB65C0A9, 0x06206A11,
+        0xD725148B, 0x0A60BE33, 0x6842370A, 0xB5079DB2, 0xAC072578, 0x71428FC0, 0x136006F9, 0xCE25AC41,
+        0x2161776D, 0xFC24DDD5, 0x9E0654EC, 0x4343FE54, 0x5A43469E, 0x8706EC26, 0xE524651F, 0x3861CFA7,
+        0x3E41A5B6, 0xE3040F0E, 0x81268637, 0x5C632C8F, 0x45639445, 0x98263EFD, 0xFA04B7C4, 0x27411D7C,
+        0xC805C650, 0x15406CE8, 0x7762E5D1, 0xAA274F69, 0xB327F7A3, 0x6E625D1B, 0x0C40D422, 0xD1057E9A,
+        0xABA65FE7, 0x76E3F55F, 0x14C17C66, 0xC984D6DE, 0xD0846E14, 0x0DC1C4AC, 0x6FE34D95, 0xB2A6E72D,
+        0x5DE23C01, 0x80A796B9, 0xE2851F80, 0x3FC0B538, 0x26C00DF2, 0xFB85A74A, 0x99A72E73, 0x44E284CB,
+        0x42C2EEDA, 0x9F874462, 0xFDA5CD5B, 0x20E067E3, 0x39E0DF29, 0xE4A57591, 0x8687FCA8, 0x5BC25610,
+        0xB4868D3C, 0x69C32784, 0x0BE1AEBD, 0xD6A40405, 0xCFA4BCCF, 0x12E11677, 0x70C39F4E, 0xAD8635F6,
+        0x7C834B6C, 0xA1C6E1D4, 0xC3E468ED, 0x1EA1C255, 0x07A17A9F, 0xDAE4D027, 0xB8C6591E, 0x6583F3A6,
+        0x8AC7288A, 0x57828232, 0x35A00B0B, 0xE8E5A1B3, 0xF1E51979, 0x2CA0B3C1, 0x4E823AF8, 0x93C79040,
+        0x95E7FA51, 0x48A250E9, 0x2A80D9D0, 0xF7C57368, 0xEEC5CBA2, 0x3380611A, 0x51A2E823, 0x8CE7429B,
+        0x63A399B7, 0xBEE6330F, 0xDCC4BA36, 0x0181108E, 0x1881A844, 0xC5C402FC, 0xA7E68BC5, 0x7AA3217D,
+        0x52A0C93F, 0x8FE56387, 0xEDC7EABE, 0x30824006, 0x2982F8CC, 0xF4C75274, 0x96E5DB4D, 0x4BA071F5,
+        0xA4E4AAD9, 0x79A10061, 0x1B838958, 0xC6C623E0, 0xDFC69B2A, 0x02833192, 0x60A1B8AB, 0xBDE41213,
+        0xBBC47802, 0x6681D2BA, 0x04A35B83, 0xD9E6F13B, 0xC0E649F1, 0x1DA3E349, 0x7F816A70, 0xA2C4C0C8,
+        0x4D801BE4, 0x90C5B15C, 0xF2E73865, 0x2FA292DD, 0x36A22A17, 0xEBE780AF, 0x89C50996, 0x5480A32E,
+        0x8585DDB4, 0x58C0770C, 0x3AE2FE35, 0xE7A7548D, 0xFEA7EC47, 0x23E246FF, 0x41C0CFC6, 0x9C85657E,
+        0x73C1BE52, 0xAE8414EA, 0xCCA69DD3, 0x11E3376B, 0x08E38FA1, 0xD5A62519, 0xB784AC20, 0x6AC10698,
+        0x6CE16C89, 0xB1A4C631, 0xD3864F08, 0x0EC3E5B0, 0x17C35D7A, 0xCA86F7C2, 0xA8A47EFB, 0x75E1D443,
+        0x9AA50F6F, 0x47E0A5D7, 0x25C22CEE, 0xF8878656, 0xE1873E9C, 0x3CC29424, 0x5EE01D1D, 0x83A5B7A5,
+        0xF90696D8, 0x24433C60, 0x4661B559, 0x9B241FE1, 0x8224A72B, 0x5F610D93, 0x3D4384AA, 0xE0062E12,
+        0x0F42F53E, 0xD2075F86, 0xB025D6BF, 0x6D607C07, 0x7460C4CD, 0xA9256E75, 0xCB07E74C, 0x16424DF4,
+        0x106227E5, 0xCD278D5D, 0xAF050464, 0x7240AEDC, 0x6B401616, 0xB605BCAE, 0xD4273597, 0x09629F2F,
+        0xE6264403, 0x3B63EEBB, 0x59416782, 0x8404CD3A, 0x9D0475F0, 0x4041DF48, 0x22635671, 0xFF26FCC9,
+        0x2E238253, 0xF36628EB, 0x9144A1D2, 0x4C010B6A, 0x5501B3A0, 0x88441918, 0xEA669021, 0x37233A99,
+        0xD867E1B5, 0x05224B0D, 0x6700C234, 0xBA45688C, 0xA345D046, 0x7E007AFE, 0x1C22F3C7, 0xC167597F,
+        0xC747336E, 0x1A0299D6, 0x782010EF, 0xA565BA57, 0xBC65029D, 0x6120A825, 0x0302211C, 0xDE478BA4,
+        0x31035088, 0xEC46FA30, 0x8E647309, 0x5321D9B1, 0x4A21617B, 0x9764CBC3, 0xF54642FA, 0x2803E842,
+    },
+    {
+        0x00000000, 0x38116FAC, 0x7022DF58, 0x4833B0F4, 0xE045BEB0, 0xD854D11C, 0x906761E8, 0xA8760E44,
+        0xC5670B91, 0xFD76643D, 0xB545D4C9, 0x8D54BB65, 0x2522B521, 0x1D33DA8D, 0x55006A79, 0x6D1105D5,
+        0x8F2261D3, 0xB7330E7F, 0xFF00BE8B, 0xC711D127, 0x6F67DF63, 0x5776B0CF, 0x1F45003B, 0x27546F97,
+        0x4A456A42, 0x725405EE, 0x3A67B51A, 0x0276DAB6, 0xAA00D4F2, 0x9211BB5E, 0xDA220BAA, 0xE2336406,
+        0x1BA8B557, 0x23B9DAFB, 0x6B8A6A0F, 0x539B05A3, 0xFBED0BE7, 0xC3FC644B, 0x8BCFD4BF, 0xB3DEBB13,
+        0xDECFBEC6, 0xE6DED16A, 0xAEED619E, 0x96FC0E32, 0x3E8A0076, 0x069B6FDA, 0x4EA8DF2E, 0x76B9B082,
+        0x948AD484, 0xAC9BBB28, 0xE4A80BDC, 0xDCB96470, 0x74CF6A34, 0x4CDE0598, 0x04EDB56C, 0x3CFCDAC0,
+        0x51EDDF15, 0x69FCB0B9, 0x21CF004D, 0x19DE6FE1, 0xB1A861A5, 0x89B90E09, 0xC18ABEFD, 0xF99BD151,
+        0x37516AAE, 0x0F400502, 0x4773B5F6, 0x7F62DA5A, 0xD714D41E, 0xEF05BBB2, 0xA7360B46, 0x9F2764EA,
+        0xF236613F, 0xCA270E93, 0x8214BE67, 0xBA05D1CB, 0x1273DF8F, 0x2A62B023, 0x625100D7, 0x5A406F7B,
+        0xB8730B7D, 0x806264D1, 0xC851D425, 0xF040BB89, 0x5836B5CD, 0x6027DA61, 0x28146A95, 0x10050539,
+        0x7D1400EC, 0x45056F40, 0x0D36DFB4, 0x3527B018, 0x9D51BE5C, 0xA540D1F0, 0xED736104, 0xD5620EA8,
+        0x2CF9DFF9, 0x14E8B055, 0x5CDB00A1, 0x64CA6F0D, 0xCCBC6149, 0xF4AD0EE5, 0xBC9EBE11, 0x848FD1BD,
+        0xE99ED468, 0xD18FBBC4, 0x99BC0B30, 0xA1AD649C, 0x09DB6AD8, 0x31CA0574, 0x79F9B580, 0x41E8DA2C,
+        0xA3DBBE2A, 0x9BCAD186, 0xD3F96172, 0xEBE80EDE, 0x439E009A, 0x7B8F6F36, 0x33BCDFC2, 0x0BADB06E,
+        0x66BCB5BB, 0x5EADDA17, 0x169E6AE3, 0x2E8F054F, 0x86F90B0B, 0xBEE864A7, 0xF6DBD453, 0xCECABBFF,
+        0x6EA2D55C, 0x56B3BAF0, 0x1E800A04, 0x269165A8, 0x8EE76BEC, 0xB6F60440, 0xFEC5B4B4, 0xC6D4DB18,
+        0xABC5DECD, 0x93D4B161, 0xDBE70195, 0xE3F66E39, 0x4B80607D, 0x73910FD1, 0x3BA2BF25, 0x03B3D089,
+        0xE180B48F, 0xD991DB23, 0x91A26BD7, 0xA9B3047B, 0x01C50A3F, 0x39D46593, 0x71E7D567, 0x49F6BACB,
+        0x24E7BF1E, 0x1CF6D0B2, 0x54C56046, 0x6CD40FEA, 0xC4A201AE, 0xFCB36E02, 0xB480DEF6, 0x8C91B15A,
+        0x750A600B, 0x4D1B0FA7, 0x0528BF53, 0x3D39D0FF, 0x954FDEBB, 0xAD5EB117, 0xE56D01E3, 0xDD7C6E4F,
+        0xB06D6B9A, 0x887C0436, 0xC04FB4C2, 0xF85EDB6E, 0x5028D52A, 0x6839BA86, 0x200A0A72, 0x181B65DE,
+        0xFA2801D8, 0xC2396E74, 0x8A0ADE80, 0xB21BB12C, 0x1A6DBF68, 0x227CD0C4, 0x6A4F6030, 0x525E0F9C,
+        0x3F4F0A49, 0x075E65E5, 0x4F6DD511, 0x777CBABD, 0xDF0AB4F9, 0xE71BDB55, 0xAF286BA1, 0x9739040D,
+        0x59F3BFF2, 0x61E2D05E, 0x29D160AA, 0x11C00F06, 0xB9B60142, 0x81A76EEE, 0xC994DE1A, 0xF185B1B6,
+        0x9C94B463, 0xA485DBCF, 0xECB66B3B, 0xD4A70497, 0x7CD10AD3, 0x44C0657F, 0x0CF3D58B, 0x34E2BA27,
+        0xD6D1DE21, 0xEEC0B18D, 0xA6F30179, 0x9EE26ED5, 0x36946091, 0x0E850F3D, 0x46B6BFC9, 0x7EA7D065,
+        0x13B6D5B0, 0x2BA7BA1C, 0x63940AE8, 0x5B856544, 0xF3F36B00, 0xCBE204AC, 0x83D1B458, 0xBBC0DBF4,
+        0x425B0AA5, 0x7A4A6509, 0x3279D5FD, 0x0A68BA51, 0xA21EB415, 0x9A0FDBB9, 0xD23C6B4D, 0xEA2D04E1,
+        0x873C0134, 0xBF2D6E98, 0xF71EDE6C, 0xCF0FB1C0, 0x6779BF84, 0x5F68D028, 0x175B60DC, 0x2F4A0F70,
+        0xCD796B76, 0xF56804DA, 0xBD5BB42E, 0x854ADB82, 0x2D3CD5C6, 0x152DBA6A, 0x5D1E0A9E, 0x650F6532,
+        0x081E60E7, 0x300F0F4B, 0x783CBFBF, 0x402DD013, 0xE85BDE57, 0xD04AB1FB, 0x9879010F, 0xA0686EA3,
+    },
+    {
+        0x00000000, 0xEF306B19, 0xDB8CA0C3, 0x34BCCBDA, 0xB2F53777, 0x5DC55C6E, 0x697997B4, 0x8649FCAD,
+        0x6006181F, 0x8F367306, 0xBB8AB8DC, 0x54BAD3C5, 0xD2F32F68, 0x3DC34471, 0x097F8FAB, 0xE64FE4B2,
+        0xC00C303E, 0x2F3C5B27, 0x1B8090FD, 0xF4B0FBE4, 0x72F90749, 0x9DC96C50, 0xA975A78A, 0x4645CC93,
+        0xA00A2821, 0x4F3A4338, 0x7B8688E2, 0x94B6E3FB, 0x12FF1F56, 0xFDCF744F, 0xC973BF95, 0x2643D48C,
+        0x85F4168D, 0x6AC47D94, 0x5E78B64E, 0xB148DD57, 0x370121FA, 0xD8314AE3, 0xEC8D8139, 0x03BDEA20,
+        0xE5F20E92, 0x0AC2658B, 0x3E7EAE51, 0xD14EC548, 0x570739E5, 0xB83752FC, 0x8C8B9926, 0x63BBF23F,
+        0x45F826B3, 0xAAC84DAA, 0x9E748670, 0x7144ED69, 0xF70D11C4, 0x183D7ADD, 0x2C81B107, 0xC3B1DA1E,
+        0x25FE3EAC, 0xCACE55B5, 0xFE729E6F, 0x1142F576, 0x970B09DB, 0x783B62C2, 0x4C87A918, 0xA3B7C201,
+        0x0E045BEB, 0xE13430F2, 0xD588FB28, 0x3AB89031, 0xBCF16C9C, 0x53C10785, 0x677DCC5F, 0x884DA746,
+        0x6E0243F4, 0x813228ED, 0xB58EE337, 0x5ABE882E, 0xDCF77483, 0x33C71F9A, 0x077BD440, 0xE84BBF59,
+        0xCE086BD5, 0x213800CC, 0x1584CB16, 0xFAB4A00F, 0x7CFD5CA2, 0x93CD37BB, 0xA771FC61, 0x48419778,
+        0xAE0E73CA, 0x413E18D3, 0x7582D309, 0x9AB2B810, 0x1CFB44BD, 0xF3CB2FA4, 0xC777E47E, 0x28478F67,
+        0x8BF04D66, 0x64C0267F, 0x507CEDA5, 0xBF4C86BC, 0x39057A11, 0xD6351108, 0xE289DAD2, 0x0DB9B1CB,
+        0xEBF65579, 0x04C63E60, 0x307AF5BA, 0xDF4A9EA3, 0x5903620E, 0xB6330917, 0x828FC2CD, 0x6DBFA9D4,
+        0x4BFC7D58, 0xA4CC1641, 0x9070DD9B, 0x7F40B682, 0xF9094A2F, 0x16392136, 0x2285EAEC, 0xCDB581F5,
+        0x2BFA6547, 0xC4CA0E5E, 0xF076C584, 0x1F46AE9D, 0x990F5230, 0x763F3929, 0x4283F2F3, 0xADB399EA,
+        0x1C08B7D6, 0xF338DCCF, 0xC7841715, 0x28B47C0C, 0xAEFD80A1, 0x41CDEBB8, 0x75712062, 0x9A414B7B,
+        0x7C0EAFC9, 0x933EC4D0, 0xA7820F0A, 0x48B26413, 0xCEFB98BE, 0x21CBF3A7, 0x1577387D, 0xFA475364,
+        0xDC0487E8, 0x3334ECF1, 0x0788272B, 0xE8B84C32, 0x6EF1B09F, 0x81C1DB86, 0xB57D105C, 0x5A4D7B45,
+        0xBC029FF7, 0x5332F4EE, 0x678E3F34, 0x88BE542D, 0x0EF7A880, 0xE1C7C399, 0xD57B0843, 0x3A4B635A,
+        0x99FCA15B, 0x76CCCA42, 0x42700198, 0xAD406A81, 0x2B09962C, 0xC439FD35, 0xF08536EF, 0x1FB55DF6,
+        0xF9FAB944, 0x16CAD25D, 0x22761987, 0xCD46729E, 0x4B0F8E33, 0xA43FE52A, 0x90832EF0, 0x7FB345E9,
+        0x59F09165, 0xB6C0FA7C, 0x827C31A6, 0x6D4C5ABF, 0xEB05A612, 0x0435CD0B, 0x308906D1, 0xDFB96DC8,
+        0x39F6897A, 0xD6C6E263, 0xE27A29B9, 0x0D4A42A0, 0x8B03BE0D, 0x6433D514, 0x508F1ECE, 0xBFBF75D7,
+        0x120CEC3D, 0xFD3C8724, 0xC9804CFE, 0x26B027E7, 0xA0F9DB4A, 0x4FC9B053, 0x7B757B89, 0x94451090,
+        0x720AF422, 0x9D3A9F3B, 0xA98654E1, 0x46B63FF8, 0xC0FFC355, 0x2FCFA84C, 0x1B736396, 0xF443088F,
+        0xD200DC03, 0x3D30B71A, 0x098C7CC0, 0xE6BC17D9, 0x60F5EB74, 0x8FC5806D, 0xBB794BB7, 0x544920AE,
+        0xB206C41C, 0x5D36AF05, 0x698A64DF, 0x86BA0FC6, 0x00F3F36B, 0xEFC39872, 0xDB7F53A8, 0x344F38B1,
+        0x97F8FAB0, 0x78C891A9, 0x4C745A73, 0xA344316A, 0x250DCDC7, 0xCA3DA6DE, 0xFE816D04, 0x11B1061D,
+        0xF7FEE2AF, 0x18CE89B6, 0x2C72426C, 0xC3422975, 0x450BD5D8, 0xAA3BBEC1, 0x9E87751B, 0x71B71E02,
+        0x57F4CA8E, 0xB8C4A197, 0x8C786A4D, 0x63480154, 0xE501FDF9, 0x0A3196E0, 0x3E8D5D3A, 0xD1BD3623,
+        0x37F2D291, 0xD8C2B988, 0xEC7E7252, 0x034E194B, 0x8507E5E6, 0x6A378EFF, 0x5E8B4525, 0xB1BB2E3C,
+    },
+    {
+        0x00000000, 0x68032CC8, 0xD0065990, 0xB8057558, 0xA5E0C5D1, 0xCDE3E919, 0x75E69C41, 0x1DE5B089,
+        0x4E2DFD53, 0x262ED19B, 0x9E2BA4C3, 0xF628880B, 0xEBCD3882, 0x83CE144A, 0x3BCB6112, 0x53C84DDA,
+        0x9C5BFAA6, 0xF458D66E, 0x4C5DA336, 0x245E8FFE, 0x39BB3F77, 0x51B813BF, 0xE9BD66E7, 0x81BE4A2F,
+        0xD27607F5, 0xBA752B3D, 0x02705E65, 0x6A7372AD, 0x7796C224, 0x1F95EEEC, 0xA7909BB4, 0xCF93B77C,
+        0x3D5B83BD, 0x5558AF75, 0xED5DDA2D, 0x855EF6E5, 0x98BB466C, 0xF0B86AA4, 0x48BD1FFC, 0x20BE3334,
+        0x73767EEE, 0x1B755226, 0xA370277E, 0xCB730BB6, 0xD696BB3F, 0xBE9597F7, 0x0690E2AF, 0x6E93CE67,
+        0xA100791B, 0xC90355D3, 0x7106208B, 0x19050C43, 0x04E0BCCA, 0x6CE39002, 0xD4E6E55A, 0xBCE5C992,
+        0xEF2D8448, 0x872EA880, 0x3F2BDDD8, 0x5728F110, 0x4ACD4199, 0x22CE6D51, 0x9ACB1809, 0xF2C834C1,
+        0x7AB7077A, 0x12B42BB2, 0xAAB15EEA, 0xC2B27222, 0xDF57C2AB, 0xB754EE63, 0x0F519B3B, 0x6752B7F3,
+        0x349AFA29, 0x5C99D6E1, 0xE49CA3B9, 0x8C9F8F71, 0x917A3FF8, 0xF9791330, 0x417C6668, 0x297F4AA0,
+        0xE6ECFDDC, 0x8EEFD114, 0x36EAA44C, 0x5EE98884, 0x430C380D, 0x2B0F14C5, 0x930A619D, 0xFB094D55,
+        0xA8C1008F, 0xC0C22C47, 0x78C7591F, 0x10C475D7, 0x0D21C55E, 0x6522E996, 0xDD279CCE, 0xB524B006,
+        0x47EC84C7, 0x2FEFA80F, 0x97EADD57, 0xFFE9F19F, 0xE20C4116, 0x8A0F6DDE, 0x320A1886, 0x5A09344E,
+        0x09C17994, 0x61C2555C, 0xD9C72004, 0xB1C40CCC, 0xAC21BC45, 0xC422908D, 0x7C27E5D5, 0x1424C91D,
+        0xDBB77E61, 0xB3B452A9, 0x0BB127F1, 0x63B20B39, 0x7E57BBB0, 0x16549778, 0xAE51E220, 0xC652CEE8,
+        0x959A8332, 0xFD99AFFA, 0x459CDAA2, 0x2D9FF66A, 0x307A46E3, 0x58796A2B, 0xE07C1F73, 0x887F33BB,
+        0xF56E0EF4, 0x9D6D223C, 0x25685764, 0x4D6B7BAC, 0x508ECB25, 0x388DE7ED, 0x808892B5, 0xE88BBE7D,
+        0xBB43F3A7, 0xD340DF6F, 0x6B45AA37, 0x034686FF, 0x1EA33676, 0x76A01ABE, 0xCEA56FE6, 0xA6A6432E,
+        0x6935F452, 0x0136D89A, 0xB933ADC2, 0xD130810A, 0xCCD53183, 0xA4D61D4B, 0x1CD36813, 0x74D044DB,
+        0x27180901, 0x4F1B25C9, 0xF71E5091, 0x9F1D7C59, 0x82F8CCD0, 0xEAFBE018, 0x52FE9540, 0x3AFDB988,
+        0xC8358D49, 0xA036A181, 0x1833D4D9, 0x7030F811, 0x6DD54898, 0x05D66450, 0xBDD31108, 0xD5D03DC0,
+        0x8618701A, 0xEE1B5CD2, 0x561E298A, 0x3E1D0542, 0x23F8B5CB, 0x4BFB9903, 0xF3FEEC5B, 0x9BFDC093,
+        0x546E77EF, 0x3C6D5B27, 0x84682E7F, 0xEC6B02B7, 0xF18EB23E, 0x998D9EF6, 0x2188EBAE, 0x498BC766,
+        0x1A438ABC, 0x7240A674, 0xCA45D32C, 0xA246FFE4, 0xBFA34F6D, 0xD7A063A5, 0x6FA516FD, 0x07A63A35,
+        0x8FD9098E, 0xE7DA2546, 0x5FDF501E, 0x37DC7CD6, 0x2A39CC5F, 0x423AE097, 0xFA3F95CF, 0x923CB907,
+        0xC1F4F4DD, 0xA9F7D815, 0x11F2AD4D, 0x79F18185, 0x6414310C, 0x0C171DC4, 0xB412689C, 0xDC114454,
+        0x1382F328, 0x7B81DFE0, 0xC384AAB8, 0xAB878670, 0xB66236F9, 0xDE611A31, 0x66646F69, 0x0E6743A1,
+        0x5DAF0E7B, 0x35AC22B3, 0x8DA957EB, 0xE5AA7B23, 0xF84FCBAA, 0x904CE762, 0x2849923A, 0x404ABEF2,
+        0xB2828A33, 0xDA81A6FB, 0x6284D3A3, 0x0A87FF6B, 0x17624FE2, 0x7F61632A, 0xC7641672, 0xAF673ABA,
+        0xFCAF7760, 0x94AC5BA8, 0x2CA92EF0, 0x44AA0238, 0x594FB2B1, 0x314C9E79, 0x8949EB21, 0xE14AC7E9,
+        0x2ED97095, 0x46DA5C5D, 0xFEDF2905, 0x96DC05CD, 0x8B39B544, 0xE33A998C, 0x5B3FECD4, 0x333CC01C,
+        0x60F48DC6, 0x08F7A10E, 0xB0F2D456, 0xD8F1F89E, 0xC5144817, 0xAD1764DF, 0x15121187, 0x7D113D4F,
+    },
+    {
+        0x00000000, 0x493C7D27, 0x9278FA4E, 0xDB448769, 0x211D826D, 0x6821FF4A, 0xB3657823, 0xFA590504,
+        0x423B04DA, 0x0B0779FD, 0xD043FE94, 0x997F83B3, 0x632686B7, 0x2A1AFB90, 0xF15E7CF9, 0xB86201DE,
+        0x847609B4, 0xCD4A7493, 0x160EF3FA, 0x5F328EDD, 0xA56B8BD9, 0xEC57F6FE, 0x37137197, 0x7E2F0CB0,
+        0xC64D0D6E, 0x8F717049, 0x5435F720, 0x1D098A07, 0xE7508F03, 0xAE6CF224, 0x7528754D, 0x3C14086A,
+        0x0D006599, 0x443C18BE, 0x9F789FD7, 0xD644E2F0, 0x2C1DE7F4, 0x65219AD3, 0xBE651DBA, 0xF759609D,
+        0x4F3B6143, 0x06071C64, 0xDD439B0D, 0x947FE62A, 0x6E26E32E, 0x271A9E09, 0xFC5E1960, 0xB5626447,
+        0x89766C2D, 0xC04A110A, 0x1B0E9663, 0x5232EB44, 0xA86BEE40, 0xE1579367, 0x3A13140E, 0x732F6929,
+        0xCB4D68F7, 0x827115D0, 0x593592B9, 0x1009EF9E, 0xEA50EA9A, 0xA36C97BD, 0x782810D4, 0x31146DF3,
+        0x1A00CB32, 0x533CB615, 0x8878317C, 0xC1444C5B, 0x3B1D495F, 0x72213478, 0xA965B311, 0xE059CE36,
+        0x583BCFE8, 0x1107B2CF, 0xCA4335A6, 0x837F4881, 0x79264D85, 0x301A30A2, 0xEB5EB7CB, 0xA262CAEC,
+        0x9E76C286, 0xD74ABFA1, 0x0C0E38C8, 0x453245EF, 0xBF6B40EB, 0xF6573DCC, 0x2D13BAA5, 0x642FC782,
+        0xDC4DC65C, 0x9571BB7B, 0x4E353C12, 0x07094135, 0xFD504431, 0xB46C3916, 0x6F28BE7F, 0x2614C358,
+        0x1700AEAB, 0x5E3CD38C, 0x857854E5, 0xCC4429C2, 0x361D2CC6, 0x7F2151E1, 0xA465D688, 0xED59ABAF,
+        0x553BAA71, 0x1C07D756, 0xC743503F, 0x8E7F2D18, 0x7426281C, 0x3D1A553B, 0xE65ED252, 0xAF62AF75,
+        0x9376A71F, 0xDA4ADA38, 0x010E5D51, 0x48322076, 0xB26B2572, 0xFB575855, 0x2013DF3C, 0x692FA21B,
+        0xD14DA3C5, 0x9871DEE2, 0x4335598B, 0x0A0924AC, 0xF05021A8, 0xB96C5C8F, 0x6228DBE6, 0x2B14A6C1,
+        0x34019664, 0x7D3DEB43, 0xA6796C2A, 0xEF45110D, 0x151C1409, 0x5C20692E, 0x8764EE47, 0xCE589360,
+        0x763A92BE, 0x3F06EF99, 0xE44268F0, 0xAD7E15D7, 0x572710D3, 0x1E1B6DF4, 0xC55FEA9D, 0x8C6397BA,
+        0xB0779FD0, 0xF94BE2F7, 0x220F659E, 0x6B3318B9, 0x916A1DBD, 0xD856609A, 0x0312E7F3, 0x4A2E9AD4,
+        0xF24C9B0A, 0xBB70E62D, 0x60346144, 0x29081C63, 0xD3511967, 0x9A6D6440, 0x4129E329, 0x08159E0E,
+        0x3901F3FD, 0x703D8EDA, 0xAB7909B3, 0xE2457494, 0x181C7190, 0x51200CB7, 0x8A648BDE, 0xC358F6F9,
+        0x7B3AF727, 0x32068A00, 0xE9420D69, 0xA07E704E, 0x5A27754A, 0x131B086D, 0xC85F8F04, 0x8163F223,
+        0xBD77FA49, 0xF44B876E, 0x2F0F0007, 0x66337D20, 0x9C6A7824, 0xD5560503, 0x0E12826A, 0x472EFF4D,
+        0xFF4CFE93, 0xB67083B4, 0x6D3404DD, 0x240879FA, 0xDE517CFE, 0x976D01D9, 0x4C2986B0, 0x0515FB97,
+        0x2E015D56, 0x673D2071, 0xBC79A718, 0xF545DA3F, 0x0F1CDF3B, 0x4620A21C, 0x9D642575, 0xD4585852,
+        0x6C3A598C, 0x250624AB, 0xFE42A3C2, 0xB77EDEE5, 0x4D27DBE1, 0x041BA6C6, 0xDF5F21AF, 0x96635C88,
+        0xAA7754E2, 0xE34B29C5, 0x380FAEAC, 0x7133D38B, 0x8B6AD68F, 0xC256ABA8, 0x19122CC1, 0x502E51E6,
+        0xE84C5038, 0xA1702D1F, 0x7A34AA76, 0x3308D751, 0xC951D255, 0x806DAF72, 0x5B29281B, 0x1215553C,
+        0x230138CF, 0x6A3D45E8, 0xB179C281, 0xF845BFA6, 0x021CBAA2, 0x4B20C785, 0x906440EC, 0xD9583DCB,
+        0x613A3C15, 0x28064132, 0xF342C65B, 0xBA7EBB7C, 0x4027BE78, 0x091BC35F, 0xD25F4436, 0x9B633911,
+        0xA777317B, 0xEE4B4C5C, 0x350FCB35, 0x7C33B612, 0x866AB316, 0xCF56CE31, 0x14124958, 0x5D2E347F,
+        0xE54C35A1, 0xAC704886, 0x7734CFEF, 0x3E08B2C8, 0xC451B7CC, 0x8D6DCAEB, 0x56294D82, 0x1F1530A5,
+    },
+};
+#endif
+
+static u32
+gj_crc32c(u32 crc, const void* data, size_t size)
+{
+    const u8* p = (const u8*)data;
+    crc = ~crc;
+
+#if defined(GJ_SSE42)
+    u64 crc64 = crc;
+    for (; size >= 8; size -= 8, p += 8) crc64 = _mm_crc32_u64(crc64, gj_read_u64(p));
+    crc = (u32)crc64;
+    for (; size > 0; size--, p++) crc = _mm_crc32_u8(crc, *p);
+#else
+    for (; size >= 8; size -= 8, p += 8)
+    {
+        u32 low  = gj_read_u32(p) ^ crc;
+        u32 high = gj_read_u32(p + 4);
+        crc = (g_gj_crc32c_table[7][ low         & 0xFF] ^ g_gj_crc32c_table[6][(low  >> 8)  & 0xFF] ^
+               g_gj_crc32c_table[5][(low  >> 16) & 0xFF] ^ g_gj_crc32c_table[4][ low  >> 24        ] ^
+               g_gj_crc32c_table[3][ high        & 0xFF] ^ g_gj_crc32c_table[2][(high >> 8)  & 0xFF] ^
+               g_gj_crc32c_table[1][(high >> 16) & 0xFF] ^ g_gj_crc32c_table[0][ high >> 24        ]);
+    }
+    for (; size > 0; size--, p++) crc = (crc >> 8) ^ g_gj_crc32c_table[0][(crc ^ *p) & 0xFF];
+#endif
+
+    return ~crc;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Debugger
 ///////////////////////////////////////////////////////////////////////////
@@ -494,11 +1026,110 @@ static void gj_UnoptimizedLine() { }
     return result;
 
 inline b32 u32_equal(u32 x, u32 y) { return x == y; }
-inline b32 gj_InArray(u32 element, u32* array, u32 array_size, s32* index) { __InArray(u32, u32_equal, index); }
 inline b32 gj_InArray(char* element, char** array, u32 array_size, s32* index) { __InArray(char*, gj_strings_equal_null_term, index); }
 inline b32 gj_InArray(char* element, char** array, u32 array_size) { s32* _ignore = NULL; __InArray(char*, gj_strings_equal_null_term, _ignore); }
 #endif
 
+// NOTE: Index of the first element equal to value, -1 if there is none.
+//       Compares 4 vectors per iteration and only looks at the masks when
+//       one of them hit.
+static s32
+gj_find_u32(const u32* array, u32 count, u32 value)
+{
+    u32 i = 0;
+#if defined(GJ_AVX2)
+    __m256i needle = _mm256_set1_epi32((int)value);
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256((__m256i*)(array + i)),      needle);
+        __m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256((__m256i*)(array + i + 8)),  needle);
+        __m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256((__m256i*)(array + i + 16)), needle);
+        __m256i d = _mm256_cmpeq_epi32(_mm256_loadu_si256((__m256i*)(array + i + 24)), needle);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        if (!_mm256_testz_si256(any, any))
+        {
+            u32 mask = ((u32)_mm256_movemask_ps(_mm256_castsi256_ps(a))       |
+                        (u32)_mm256_movemask_ps(_mm256_castsi256_ps(b)) << 8  |
+                        (u32)_mm256_movemask_ps(_mm256_castsi256_ps(c)) << 16 |
+                        (u32)_mm256_movemask_ps(_mm256_castsi256_ps(d)) << 24);
+            return (s32)(i + gj_count_trailing_zeros_u32(mask));
+        }
+    }
+    for (; i + 8 <= count; i += 8)
+    {
+        u32 mask = (u32)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256((__m256i*)(array + i)), needle)));
+        if (mask) return (s32)(i + gj_count_trailing_zeros_u32(mask));
+    }
+#else
+    __m128i needle = _mm_set1_epi32((int)value);
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i a = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i*)(array + i)),      needle);
+        __m128i b = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i*)(array + i + 4)),  needle);
+        __m128i c = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i*)(array + i + 8)),  needle);
+        __m128i d = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i*)(array + i + 12)), needle);
+        __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (_mm_movemask_epi8(any))
+        {
+            u32 mask = ((u32)_mm_movemask_ps(_mm_castsi128_ps(a))       |
+                        (u32)_mm_movemask_ps(_mm_castsi128_ps(b)) << 4  |
+                        (u32)_mm_movemask_ps(_mm_castsi128_ps(c)) << 8  |
+                        (u32)_mm_movemask_ps(_mm_castsi128_ps(d)) << 12);
+            return (s32)(i + gj_count_trailing_zeros_u32(mask));
+        }
+    }
+    for (; i + 4 <= count; i += 4)
+    {
+        u32 mask = (u32)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128((__m128i*)(array + i)), needle)));
+        if (mask) return (s32)(i + gj_count_trailing_zeros_u32(mask));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        if (array[i] == value) return (s32)i;
+    }
+    return -1;
+}
+
+inline s32
+gj_find_s32(const s32* array, u32 count, s32 value) { return gj_find_u32((const u32*)array, count, (u32)value); }
+
+inline b32
+gj_InArray(u32 element, u32* array, u32 array_size, s32* index)
+{
+    s32 found = gj_find_u32(array, array_size, element);
+    if (found >= 0 && index) *index = found;
+    return found >= 0;
+}
+
+// NOTE: Branchless lower bound on a sorted array, the index of the first
+//       element >= value (count if there is none). The loop runs log2(count)
+//       times whatever the data, with a conditional move instead of a branch.
+#define gj__DefineLowerBound(Name, Type)                                \
+    inline u32                                                          \
+    Name(const Type* array, u32 count, Type value)                      \
+    {                                                                   \
+        if (count == 0) return 0;                                       \
+        const Type* base = array;                                       \
+        while (count > 1)                                               \
+        {                                                               \
+            u32 half = count / 2;                                       \
+            base   = base[half] < value ? base + half : base;           \
+            count -= half;                                              \
+        }                                                               \
+        return (u32)(base - array) + (*base < value);                   \
+    }
+
+gj__DefineLowerBound(gj_lower_bound_u32, u32)
+gj__DefineLowerBound(gj_lower_bound_s32, s32)
+gj__DefineLowerBound(gj_lower_bound_f32, f32)
+
+// NOTE: Index of value in a sorted array, -1 if it's not there
+inline s32 gj_binary_search_u32(const u32* array, u32 count, u32 value)
+{ u32 i = gj_lower_bound_u32(array, count, value); return i < count && array[i] == value ? (s32)i : -1; }
+inline s32 gj_binary_search_s32(const s32* array, u32 count, s32 value)
+{ u32 i = gj_lower_bound_s32(array, count, value); return i < count && array[i] == value ? (s32)i : -1; }
+
 ///////////////////////////////////////////////////////////////////////////
 // Memory
 ///////////////////////////////////////////////////////////////////////////
@@ -535,7 +1166,9 @@ void clear_arena(MemoryArena* arena)
 #define push_size(arena, size)_push(arena, size, 4)
 #define push_array(arena, type, count)(type*)push_size(arena, sizeof(type) * count)
 #define push_struct(arena, type) (type*)_push(arena, sizeof(type), 4)
-void* _push(MemoryArena* arena, size_t size, size_t alignment)
+// NOTE: For scratch buffers that are written before they're read
+#define push_array_no_zero(arena, type, count) (type*)_push_no_zero(arena, sizeof(type) * (count), 64)
+void* _push_no_zero(MemoryArena* arena, size_t size, size_t alignment)
 {
     uintptr_t result_pointer = (uintptr_t)arena->base + arena->used;
     
@@ -543,56 +1176,97 @@ void* _push(MemoryArena* arena, size_t size, size_t alignment)
     
     size_t alignment_mask = alignment - 1;
     alignment_offset = (alignment - result_pointer & alignment_mask) & alignment_mask;
-    size += alignment_offset;
     
-    gj_AssertDebug(arena->used + size <= arena->size);
-    arena->used += size;
+    gj_AssertDebug(arena->used + size + alignment_offset <= arena->size);
+    arena->used += size + alignment_offset;
 
-    void* result = (void*)(result_pointer + alignment_offset);
+    return (void*)(result_pointer + alignment_offset);
+}
 
+void* _push(MemoryArena* arena, size_t size, size_t alignment)
+{
+    void* result = _push_no_zero(arena, size, alignment);
     memset(result, 0, size);
-    
     return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////
 // Array
 ///////////////////////////////////////////////////////////////////////////
-#define gj_DefineArray(Type, Name)                                      \
-    struct Name                                                         \
-    {                                                                   \
-        Type##* data;                                                   \
-        u32   count;                                                    \
-        u32   max_count;                                                \
-        Type##& operator[](int i) { gj_AssertDebug((u32)i < count); return data[i]; } \
+// NOTE: Shared by gj_DefineArray and gj_DefineGrowableArray, which provide
+//       data, count and grow(u32 new_count) returning false when the array
+//       can't hold new_count elements
+#define gj__DefineArrayMethods(Type)                                    \
+        Type& operator[](int i) { gj_AssertDebug((u32)i < count); return data[i]; } \
+                                                                        \
+        b32 reserve(u32 new_count) { return grow(new_count); }          \
                                                                         \
+        /* NOTE: Keeps the order, O(n) */                               \
         Type remove(u32 i)                                              \
         {                                                               \
-            Type result = (*this)[i];                                   \
-            gj_Assert(i < max_count && count > 0);                      \
-            for (u32 j = i; j < count; j++)                             \
-            {                                                           \
-                gj_SwapArray(data, Type, j, j + 1);                     \
-            }                                                           \
+            gj_AssertDebug(i < count);                                  \
+            Type result = data[i];                                      \
+            memmove(data + i, data + i + 1, (count - i - 1) * sizeof(Type)); \
             count--;                                                    \
             return result;                                              \
         }                                                               \
                                                                         \
-        Type##* add_new()                                               \
+        /* NOTE: O(1), the last element takes the removed one's place */ \
+        Type unordered_remove(u32 i)                                    \
+        {                                                               \
+            gj_AssertDebug(i < count);                                  \
+            Type result = data[i];                                      \
+            data[i] = data[--count];                                    \
+            return result;                                              \
+        }                                                               \
+                                                                        \
+        void remove_range(u32 first, u32 range_count)                   \
         {                                                               \
-            gj_AssertDebug(count < max_count);                          \
+            gj_AssertDebug(first <= count && range_count <= count - first); \
+            memmove(data + first, data + first + range_count, (count - first - range_count) * sizeof(Type)); \
+            count -= range_count;                                       \
+        }                                                               \
+                                                                        \
+        Type* add_new()                                                 \
+        {                                                               \
+            if (!grow(count + 1)) return NULL;                          \
             return &data[count++];                                      \
         }                                                               \
                                                                         \
-        void add(Type element)                                          \
+        /* NOTE: False when the array can't grow, like add_new's NULL */ \
+        b32 add(Type element)                                           \
         {                                                               \
-            gj_AssertDebug(count < max_count);                          \
+            if (!grow(count + 1)) return gj_False;                      \
             data[count++] = element;                                    \
+            return gj_True;                                             \
+        }                                                               \
+                                                                        \
+        /* NOTE: elements can be NULL to append range_count slots to fill in */ \
+        Type* append_n(const Type* elements, u32 range_count)           \
+        {                                                               \
+            if (!grow(count + range_count)) return NULL;                \
+            Type* result = data + count;                                \
+            if (elements) memcpy(result, elements, range_count * sizeof(Type)); \
+            count += range_count;                                       \
+            return result;                                              \
+        }                                                               \
+                                                                        \
+        Type* insert_n(u32 i, const Type* elements, u32 range_count)    \
+        {                                                               \
+            gj_AssertDebug(i <= count);                                 \
+            if (!grow(count + range_count)) return NULL;                \
+            memmove(data + i + range_count, data + i, (count - i) * sizeof(Type)); \
+            if (elements) memcpy(data + i, elements, range_count * sizeof(Type)); \
+            count += range_count;                                       \
+            return data + i;                                            \
         }                                                               \
                                                                         \
+        b32 insert(u32 i, Type element) { return insert_n(i, &element, 1) != NULL; } \
+                                                                        \
         Type pop()                                                      \
         {                                                               \
-            return remove(count - 1);                                   \
+            gj_AssertDebug(count > 0);                                  \
+            return data[--count];                                       \
         }                                                               \
                                                                         \
         void clear()                                                    \
@@ -600,22 +1274,327 @@ void* _push(MemoryArena* arena, size_t size, size_t alignment)
             count = 0;                                                  \
         }                                                               \
                                                                         \
-        void fill(Type value)                                           \
+        /* NOTE: Sets count to fill_count, copying in doubling chunks */ \
+        void fill(Type value, u32 fill_count)                           \
         {                                                               \
-            for (u32 i = 0; i < max_count; i++) { data[i] = value; }    \
-            count = max_count;                                          \
+            if (fill_count == 0 || !grow(fill_count)) return;           \
+            data[0] = value;                                            \
+            for (u32 filled = 1; filled < fill_count;)                  \
+            {                                                           \
+                u32 copy_count = filled < fill_count - filled ? filled : fill_count - filled; \
+                memcpy(data + filled, data, copy_count * sizeof(Type)); \
+                filled += copy_count;                                   \
+            }                                                           \
+            count = fill_count;                                         \
+        }
+
+#define gj_DefineArray(Type, Name)                                      \
+    struct Name                                                         \
+    {                                                                   \
+        Type* data;                                                     \
+        u32   count;                                                    \
+        u32   max_count;                                                \
+                                                                        \
+        b32 grow(u32 new_count)                                         \
+        {                                                               \
+            gj_AssertDebug(new_count <= max_count);                     \
+            return new_count <= max_count;                              \
         }                                                               \
+                                                                        \
+        gj__DefineArrayMethods(Type)                                    \
+                                                                        \
+        void fill(Type value) { fill(value, max_count); }               \
     };                                                                  \
                                                                         \
-    void Name##_init(Name##* array, MemoryArena* memory_arena, u32 max_count) \
+    void Name##_init(Name* array, MemoryArena* memory_arena, u32 max_count) \
     {                                                                   \
-        array->data = (Type##*)push_size(memory_arena, max_count * sizeof(Type)); \
+        array->data = (Type*)push_size(memory_arena, max_count * sizeof(Type)); \
         array->count = 0;                                               \
         array->max_count = max_count;                                   \
     }                                                                   
     
 gj_DefineArray(u32,   U32Array);
 gj_DefineArray(s32,   S32Array);
+
+inline s32 gj_find(U32Array* array, u32 value) { return gj_find_u32(array->data, array->count, value); }
+inline s32 gj_find(S32Array* array, s32 value) { return gj_find_s32(array->data, array->count, value); }
+inline s32 gj_binary_search(U32Array* array, u32 value) { return gj_binary_search_u32(array->data, array->count, value); }
+inline s32 gj_binary_search(S32Array* array, s32 value) { return gj_binary_search_s32(array->data, array->count, value); }
+
+///////////////////////////////////////////////////////////////////////////
+// Sort
+///////////////////////////////////////////////////////////////////////////
+// NOTE: LSD radix sort, 8 bits per pass, stable. payloads (ids, indices) can
+//       be NULL, otherwise they're moved along with their keys. Needs
+//       count * 8 bytes of scratch, given back before returning. All four
+//       histograms are built in one pass and a pass is skipped when every key
+//       has the same digit, so e.g. keys below 65536 take two passes.
+static void
+gj__radix_sort_u32_bits(u32* keys, u32* payloads, u32 count, MemoryArena* scratch)
+{
+    if (count < 2) return;
+
+    BeginTemporaryMemoryBlock(scratch);
+    u32* histograms   = push_array(scratch, u32, 4 * 256);
+    u32* tmp_keys     = push_array_no_zero(scratch, u32, count);
+    u32* tmp_payloads = payloads ? push_array_no_zero(scratch, u32, count) : NULL;
+
+    for (u32 i = 0; i < count; i++)
+    {
+        u32 key = keys[i];
+        histograms[0 * 256 + ( key        & 0xFF)]++;
+        histograms[1 * 256 + ((key >> 8)  & 0xFF)]++;
+        histograms[2 * 256 + ((key >> 16) & 0xFF)]++;
+        histograms[3 * 256 + ( key >> 24        )]++;
+    }
+
+    u32* src_keys     = keys;
+    u32* src_payloads = payloads;
+    u32* dst_keys     = tmp_keys;
+    u32* dst_payloads = tmp_payloads;
+    for (u32 pass = 0; pass < 4; pass++)
+    {
+        u32  shift     = pass * 8;
+        u32* histogram = histograms + pass * 256;
+        if (histogram[(src_keys[0] >> shift) & 0xFF] == count) continue;
+
+        u32 offset = 0;
+        for (u32 digit = 0; digit < 256; digit++)
+        {
+            u32 digit_count = histogram[digit];
+            histogram[digit] = offset;
+            offset += digit_count;
+        }
+
+        if (payloads)
+        {
+            for (u32 i = 0; i < count; i++)
+            {
+                u32 key = src_keys[i];
+                u32 destination = histogram[(key >> shift) & 0xFF]++;
+                dst_keys[destination]     = key;
+                dst_payloads[destination] = src_payloads[i];
+            }
+        }
+        else
+        {
+            for (u32 i = 0; i < count; i++)
+            {
+                u32 key = src_keys[i];
+                dst_keys[histogram[(key >> shift) & 0xFF]++] = key;
+            }
+        }
+
+        gj_SwapVar(u32*, src_keys, dst_keys);
+        gj_SwapVar(u32*, src_payloads, dst_payloads);
+    }
+
+    if (src_keys != keys)
+    {
+        memcpy(keys, src_keys, count * sizeof(u32));
+        if (payloads) memcpy(payloads, src_payloads, count * sizeof(u32));
+    }
+    EndTemporaryMemoryBlock(scratch);
+}
+
+inline void
+gj_radix_sort_u32(u32* keys, u32* payloads, u32 count, MemoryArena* scratch)
+{ gj__radix_sort_u32_bits(keys, payloads, count, scratch); }
+
+// NOTE: Flipping the sign bit makes signed order match unsigned order
+static void
+gj_radix_sort_s32(s32* keys, u32* payloads, u32 count, MemoryArena* scratch)
+{
+    u32* bits = (u32*)keys;
+    for (u32 i = 0; i < count; i++) bits[i] ^= 0x80000000;
+    gj__radix_sort_u32_bits(bits, payloads, count, scratch);
+    for (u32 i = 0; i < count; i++) bits[i] ^= 0x80000000;
+}
+
+// NOTE: Negative floats get all bits flipped, positive ones only the sign
+//       bit, after which they sort as unsigned. -0.0 sorts before 0.0, NaNs
+//       go to the ends by sign.
+static void
+gj_radix_sort_f32(f32* keys, u32* payloads, u32 count, MemoryArena* scratch)
+{
+    u32* bits = (u32*)keys;
+    for (u32 i = 0; i < count; i++) bits[i] ^= (0 - (bits[i] >> 31)) | 0x80000000;
+    gj__radix_sort_u32_bits(bits, payloads, count, scratch);
+    for (u32 i = 0; i < count; i++) bits[i] ^= ((bits[i] >> 31) - 1) | 0x80000000;
+}
+
+inline void gj_radix_sort(U32Array* array, MemoryArena* scratch) { gj_radix_sort_u32(array->data, NULL, array->count, scratch); }
+inline void gj_radix_sort(S32Array* array, MemoryArena* scratch) { gj_radix_sort_s32(array->data, NULL, array->count, scratch); }
+
+///////////////////////////////////////////////////////////////////////////
+// Bitset
+///////////////////////////////////////////////////////////////////////////
+// NOTE: Fixed size bitset on an arena. word_count is padded to a multiple of
+//       4 (one AVX2 register) so the word-level ops have no tail loop, the
+//       bits past bit_count are always kept 0. Ops between two bitsets need
+//       them to be the same size.
+#define GJ_BITSET_WORD_ALIGNMENT 4
+
+typedef struct GJBitset
+{
+    u64* words;
+    u32  bit_count;
+    u32  word_count;
+} GJBitset;
+
+static GJBitset
+gj_bitset_create(MemoryArena* arena, u32 bit_count)
+{
+    GJBitset result;
+    result.bit_count  = bit_count;
+    result.word_count = ((bit_count + 63) / 64 + GJ_BITSET_WORD_ALIGNMENT - 1) & ~(u32)(GJ_BITSET_WORD_ALIGNMENT - 1);
+    result.words      = (u64*)_push(arena, result.word_count * sizeof(u64), 32);
+    return result;
+}
+
+inline b32  gj_bitset_get   (GJBitset* bitset, u32 i) { gj_AssertDebug(i < bitset->bit_count); return (bitset->words[i / 64] >> (i % 64)) & 1; }
+inline void gj_bitset_set   (GJBitset* bitset, u32 i) { gj_AssertDebug(i < bitset->bit_count); bitset->words[i / 64] |=  (1ull << (i % 64)); }
+inline void gj_bitset_unset (GJBitset* bitset, u32 i) { gj_AssertDebug(i < bitset->bit_count); bitset->words[i / 64] &= ~(1ull << (i % 64)); }
+inline void gj_bitset_toggle(GJBitset* bitset, u32 i) { gj_AssertDebug(i < bitset->bit_count); bitset->words[i / 64] ^=  (1ull << (i % 64)); }
+inline void
+gj_bitset_assign(GJBitset* bitset, u32 i, b32 value)
+{
+    gj_AssertDebug(i < bitset->bit_count);
+    u64 bit = 1ull << (i % 64);
+    bitset->words[i / 64] = (bitset->words[i / 64] & ~bit) | (value ? bit : 0);
+}
+
+inline void
+gj_bitset_clear_all(GJBitset* bitset) { memset(bitset->words, 0, bitset->word_count * sizeof(u64)); }
+
+static void
+gj_bitset_set_all(GJBitset* bitset)
+{
+    u32 full_words = bitset->bit_count / 64;
+    memset(bitset->words, 0xFF, full_words * sizeof(u64));
+    memset(bitset->words + full_words, 0, (bitset->word_count - full_words) * sizeof(u64));
+    if (bitset->bit_count % 64) bitset->words[full_words] = (1ull << (bitset->bit_count % 64)) - 1;
+}
+
+typedef enum GJBitsetOp
+{
+    GJBitsetOp_And,
+    GJBitsetOp_Or,
+    GJBitsetOp_AndNot,
+    GJBitsetOp_Xor
+} GJBitsetOp;
+
+// NOTE: dst can be a or b
+static void
+gj__bitset_op(GJBitset* dst, GJBitset* a, GJBitset* b, GJBitsetOp op)
+{
+    gj_AssertDebug(dst->word_count == a->word_count && a->word_count == b->word_count);
+    u64* d = dst->words;
+    u64* x = a->words;
+    u64* y = b->words;
+    u32  word_count = dst->word_count;
+
+#if defined(GJ_AVX2)
+    for (u32 i = 0; i < word_count; i += 4)
+    {
+        __m256i va = _mm256_load_si256((__m256i*)(x + i));
+        __m256i vb = _mm256_load_si256((__m256i*)(y + i));
+        __m256i vr;
+        switch (op)
+        {
+            case GJBitsetOp_And:    vr = _mm256_and_si256(va, vb);    break;
+            case GJBitsetOp_Or:     vr = _mm256_or_si256(va, vb);     break;
+            case GJBitsetOp_AndNot: vr = _mm256_andnot_si256(vb, va); break;
+            default:                 vr = _mm256_xor_si256(va, vb);    break;
+        }
+        _mm256_store_si256((__m256i*)(d + i), vr);
+    }
+#else
+    for (u32 i = 0; i < word_count; i += 2)
+    {
+        __m128i va = _mm_load_si128((__m128i*)(x + i));
+        __m128i vb = _mm_load_si128((__m128i*)(y + i));
+        __m128i vr;
+        switch (op)
+        {
+            case GJBitsetOp_And:    vr = _mm_and_si128(va, vb);    break;
+            case GJBitsetOp_Or:     vr = _mm_or_si128(va, vb);     break;
+            case GJBitsetOp_AndNot: vr = _mm_andnot_si128(vb, va); break;
+            default:                 vr = _mm_xor_si128(va, vb);    break;
+        }
+        _mm_store_si128((__m128i*)(d + i), vr);
+    }
+#endif
+}
+
+inline void gj_bitset_and    (GJBitset* dst, GJBitset* a, GJBitset* b) { gj__bitset_op(dst, a, b, GJBitsetOp_And); }
+inline void gj_bitset_or     (GJBitset* dst, GJBitset* a, GJBitset* b) { gj__bitset_op(dst, a, b, GJBitsetOp_Or); }
+inline void gj_bitset_xor    (GJBitset* dst, GJBitset* a, GJBitset* b) { gj__bitset_op(dst, a, b, GJBitsetOp_Xor); }
+// NOTE: dst = a & ~b
+inline void gj_bitset_and_not(GJBitset* dst, GJBitset* a, GJBitset* b) { gj__bitset_op(dst, a, b, GJBitsetOp_AndNot); }
+
+static u32
+gj_bitset_count(GJBitset* bitset)
+{
+    // NOTE: Four accumulators so the popcnts don't wait on each other
+    u32 counts[4] = {};
+    for (u32 i = 0; i < bitset->word_count; i += 4)
+    {
+        counts[0] += gj_popcount_u64(bitset->words[i]);
+        counts[1] += gj_popcount_u64(bitset->words[i + 1]);
+        counts[2] += gj_popcount_u64(bitset->words[i + 2]);
+        counts[3] += gj_popcount_u64(bitset->words[i + 3]);
+    }
+    return counts[0] + counts[1] + counts[2] + counts[3];
+}
+
+static b32
+gj_bitset_any(GJBitset* bitset)
+{
+    u64 any = 0;
+    for (u32 i = 0; i < bitset->word_count; i++) any |= bitset->words[i];
+    return any != 0;
+}
+
+// NOTE: Index of the first set bit >= from, bit_count if there is none
+static u32
+gj_bitset_next(GJBitset* bitset, u32 from)
+{
+    if (from >= bitset->bit_count) return bitset->bit_count;
+    u32 word_index = from / 64;
+    u64 bits = bitset->words[word_index] & (~0ull << (from % 64));
+    while (!bits)
+    {
+        if (++word_index == bitset->word_count) return bitset->bit_count;
+        bits = bitset->words[word_index];
+    }
+    return word_index * 64 + gj_count_trailing_zeros_u64(bits);
+}
+
+// NOTE: Writes the indices of the set bits in order, indices must hold
+//       gj_bitset_count() of them. Returns how many were written.
+static u32
+gj_bitset_to_indices(GJBitset* bitset, u32* indices)
+{
+    u32 count = 0;
+    for (u32 word_index = 0; word_index < bitset->word_count; word_index++)
+    {
+        for (u64 bits = bitset->words[word_index]; bits; bits &= bits - 1)
+        {
+            indices[count++] = word_index * 64 + gj_count_trailing_zeros_u64(bits);
+        }
+    }
+    return count;
+}
+
+// NOTE: Visits set bits in order, clearing the lowest one each step.
+//       break only leaves the inner loop, use gj_bitset_next to stop early.
+//  gj_BitsetForEach(&visible, entity_index) { draw(entity_index); }
+#define gj_BitsetForEach(BitsetPointer, Index)                                                         \
+    for (u32 Index##_word = 0; Index##_word < (BitsetPointer)->word_count; Index##_word++)             \
+        for (u64 Index##_bits = (BitsetPointer)->words[Index##_word]; Index##_bits; Index##_bits &= Index##_bits - 1) \
+            for (u32 Index = Index##_word * 64 + gj_count_trailing_zeros_u64(Index##_bits), Index##_once = 1; \
+                 Index##_once; Index##_once = 0)
 ///////////////////////////////////////////////////////////////////////////
 // OS API
 ///////////////////////////////////////////////////////////////////////////
@@ -623,24 +1602,141 @@ typedef enum PlatformOpenFileModeFlags
 {
     PlatformOpenFileModeFlags_Read      = 0b001,
     PlatformOpenFileModeFlags_Write     = 0b010,
-    PlatformOpenFileModeFlags_Overwrite = 0b100
+    PlatformOpenFileModeFlags_Overwrite = 0b100,
+    // NOTE: Bypasses the OS file cache (FILE_FLAG_NO_BUFFERING, O_DIRECT).
+    //       Offsets, sizes and buffer addresses then have to be multiples of
+    //       PLATFORM_UNBUFFERED_ALIGNMENT. On Linux, file systems that can't
+    //       do O_DIRECT silently open the file buffered.
+    PlatformOpenFileModeFlags_Unbuffered = 0b1000
 } PlatformOpenFileModeFlags;
 
 #define PLATFORM_INVALID_FILE_HANDLE NULL
+#define PLATFORM_UNBUFFERED_ALIGNMENT 4096
 typedef struct PlatformFileHandle
 {
     void* handle;
-    u32 file_size;
+    u64 file_size;
     // TODO: Remove?
     char* full_file_name;
 } PlatformFileHandle;
 
+// NOTE: Read-only view of a whole file, the file can be closed by the
+//       platform layer as soon as it's mapped
+typedef struct PlatformMappedFile
+{
+    void* memory;
+    u64   size;
+} PlatformMappedFile;
+
 typedef struct PlatformFileListing
 {
     char* file_name;
     struct PlatformFileListing* next;
 } PlatformFileListing;
 
+// NOTE: Names are paths relative to the walked directory, '/'-separated and
+//       null-terminated, packed into PlatformDirectoryListing::names.
+//       last_write_time uses the same unit as FileTime::compare_value.
+typedef struct PlatformDirectoryEntry
+{
+    u32 name_offset;
+    u32 name_length;
+    u64 size;
+    u64 last_write_time;
+    b32 is_directory;
+} PlatformDirectoryEntry;
+
+typedef struct PlatformDirectoryListing
+{
+    PlatformDirectoryEntry* entries;
+    u32   entry_count;
+    char* names;
+    u32   names_size;
+    b32   out_of_memory;
+} PlatformDirectoryListing;
+
+// NOTE: Used by the platform layers to fill a PlatformDirectoryListing in a
+//       single caller-provided memory block. Entries grow from the front and
+//       names from the back, while building name_offset is the distance from
+//       the end of the block and gets rebased in platform_directory_listing_end.
+typedef struct PlatformDirectoryListingBuilder
+{
+    u8*    memory;
+    size_t memory_size;
+    size_t names_used;
+    PlatformDirectoryListing listing;
+} PlatformDirectoryListingBuilder;
+
+inline void
+platform_directory_listing_begin(PlatformDirectoryListingBuilder* builder, void* memory, size_t memory_size)
+{
+    uintptr_t alignment_offset = (8 - ((uintptr_t)memory & 7)) & 7;
+    gj__ZeroStruct(*builder);
+    builder->memory      = (u8*)memory;
+    builder->memory_size = memory_size;
+    builder->listing.entries = (PlatformDirectoryEntry*)((u8*)memory + alignment_offset);
+    builder->names_used  = alignment_offset > memory_size ? memory_size : 0;
+}
+
+inline char*
+platform_directory_listing_get_name(PlatformDirectoryListingBuilder* builder, u32 entry_index)
+{
+    return (char*)(builder->memory + builder->memory_size - builder->listing.entries[entry_index].name_offset);
+}
+
+// NOTE: parent can be NULL for entries directly in the walked directory
+static PlatformDirectoryEntry*
+platform_directory_listing_push(PlatformDirectoryListingBuilder* builder,
+                                const char* parent, u32 parent_length,
+                                const char* name, u32 name_length)
+{
+    PlatformDirectoryEntry* result = NULL;
+
+    u32 full_length = parent ? parent_length + 1 + name_length : name_length;
+    size_t entries_end = ((u8*)(builder->listing.entries + builder->listing.entry_count + 1) - builder->memory);
+    size_t names_used  = builder->names_used + full_length + 1;
+    if (!builder->listing.out_of_memory && entries_end + names_used <= builder->memory_size)
+    {
+        char* dst = (char*)(builder->memory + builder->memory_size - names_used);
+        if (parent)
+        {
+            memcpy(dst, parent, parent_length);
+            dst[parent_length] = '/';
+            memcpy(dst + parent_length + 1, name, name_length);
+        }
+        else
+        {
+            memcpy(dst, name, name_length);
+        }
+        dst[full_length] = '\0';
+        builder->names_used = names_used;
+
+        result = &builder->listing.entries[builder->listing.entry_count++];
+        gj__ZeroStruct(*result);
+        result->name_offset = (u32)names_used;
+        result->name_length = full_length;
+    }
+    else
+    {
+        builder->listing.out_of_memory = gj_True;
+    }
+
+    return result;
+}
+
+inline PlatformDirectoryListing
+platform_directory_listing_end(PlatformDirectoryListingBuilder* builder)
+{
+    PlatformDirectoryListing result = builder->listing;
+    result.names      = (char*)(builder->memory + builder->memory_size - builder->names_used);
+    result.names_size = (u32)builder->names_used;
+    for (u32 entry_index = 0; entry_index < result.entry_count; entry_index++)
+    {
+        result.entries[entry_index].name_offset = result.names_size - result.entries[entry_index].name_offset;
+    }
+    return result;
+}
+
 typedef struct FileTime
 {
     struct
@@ -656,6 +1752,130 @@ typedef struct FileTime
     u64 compare_value;
 } FileTime;
 
+typedef enum PlatformFileChangeFlags
+{
+    PlatformFileChangeFlags_Modified = 0b00001,
+    PlatformFileChangeFlags_Created  = 0b00010,
+    PlatformFileChangeFlags_Deleted  = 0b00100,
+    PlatformFileChangeFlags_Renamed  = 0b01000,
+    // NOTE: Events were dropped (OS queue or PlatformFileChangeQueue full),
+    //       anything under the watch may have changed
+    PlatformFileChangeFlags_Overflow = 0b10000
+} PlatformFileChangeFlags;
+
+// NOTE: add_file_watch returns a watch id (0 on failure). Watching a file
+//       watches its directory filtered to that name so that editors saving
+//       through a rename are still picked up, recursive only applies to
+//       directories. file_name is relative to the watched directory
+//       ('/'-separated), for a watched file it is that file's name. It stays
+//       valid until the next call to poll_file_changes.
+typedef struct PlatformFileChange
+{
+    u32   watch_id;
+    u32   flags;
+    char* file_name;
+} PlatformFileChange;
+
+#define PLATFORM_FILE_CHANGE_QUEUE_MAX_CHANGES 1024
+#define PLATFORM_FILE_CHANGE_QUEUE_NAMES_SIZE  Kilobytes(64)
+
+// NOTE: Used by the platform layers to batch OS events between polls. Several
+//       events for the same file and watch are merged into one change with
+//       the flags or:ed together. The last slot is kept for an overflow change
+//       with watch_id 0, which means every watch may have changed.
+typedef struct PlatformFileChangeQueue
+{
+    PlatformFileChange changes[PLATFORM_FILE_CHANGE_QUEUE_MAX_CHANGES];
+    u32  change_count;
+    char names[PLATFORM_FILE_CHANGE_QUEUE_NAMES_SIZE];
+    u32  names_used;
+} PlatformFileChangeQueue;
+
+static void
+platform_file_change_queue_push_overflow(PlatformFileChangeQueue* queue)
+{
+    for (u32 change_index = 0; change_index < queue->change_count; change_index++)
+    {
+        if (queue->changes[change_index].flags & PlatformFileChangeFlags_Overflow) return;
+    }
+    gj_AssertDebug(queue->change_count < PLATFORM_FILE_CHANGE_QUEUE_MAX_CHANGES);
+    PlatformFileChange* change = &queue->changes[queue->change_count++];
+    change->watch_id  = 0;
+    change->flags     = PlatformFileChangeFlags_Overflow;
+    change->file_name = (char*)"";
+}
+
+// NOTE: The change's name is prefix/name, prefix can be empty
+static void
+platform_file_change_queue_push(PlatformFileChangeQueue* queue, u32 watch_id, u32 flags,
+                                const char* prefix, u32 prefix_length,
+                                const char* name, u32 name_length)
+{
+    u32 full_length = prefix_length > 0 ? prefix_length + 1 + name_length : name_length;
+
+    PlatformFileChange* change = NULL;
+    for (u32 change_index = 0; change_index < queue->change_count; change_index++)
+    {
+        PlatformFileChange* queued = &queue->changes[change_index];
+        if (queued->watch_id == watch_id &&
+            strlen(queued->file_name) == full_length &&
+            (prefix_length == 0 || (gj_strings_equal(queued->file_name, prefix, prefix_length) &&
+                                    queued->file_name[prefix_length] == '/')) &&
+            gj_strings_equal(queued->file_name + full_length - name_length, name, name_length))
+        {
+            change = queued;
+            break;
+        }
+    }
+
+    if (change)
+    {
+        change->flags |= flags;
+    }
+    else if (queue->change_count < PLATFORM_FILE_CHANGE_QUEUE_MAX_CHANGES - 1 &&
+             queue->names_used + full_length + 1 <= PLATFORM_FILE_CHANGE_QUEUE_NAMES_SIZE)
+    {
+        change = &queue->changes[queue->change_count++];
+        change->watch_id  = watch_id;
+        change->flags     = flags;
+        change->file_name = queue->names + queue->names_used;
+        if (prefix_length > 0)
+        {
+            memcpy(change->file_name, prefix, prefix_length);
+            change->file_name[prefix_length] = '/';
+            memcpy(change->file_name + prefix_length + 1, name, name_length);
+        }
+        else
+        {
+            memcpy(change->file_name, name, name_length);
+        }
+        change->file_name[full_length] = '\0';
+        queue->names_used += full_length + 1;
+    }
+    else
+    {
+        platform_file_change_queue_push_overflow(queue);
+    }
+}
+
+// NOTE: Called at the start of a poll, names handed out by the previous poll
+//       are released once every queued change has been taken.
+inline void
+platform_file_change_queue_begin(PlatformFileChangeQueue* queue)
+{
+    if (queue->change_count == 0) queue->names_used = 0;
+}
+
+inline u32
+platform_file_change_queue_take(PlatformFileChangeQueue* queue, PlatformFileChange* changes, u32 max_change_count)
+{
+    u32 result = queue->change_count < max_change_count ? queue->change_count : max_change_count;
+    memcpy(changes, queue->changes, result * sizeof(PlatformFileChange));
+    queue->change_count -= result;
+    memmove(queue->changes, queue->changes + result, queue->change_count * sizeof(PlatformFileChange));
+    return result;
+}
+
 typedef struct PlatformThreadContext
 {
     void (*thread_func)(void*);
@@ -675,25 +1895,98 @@ typedef struct TicketMutex
     u64 volatile serving;
 } TicketMutex;
 
+// NOTE: Counting semaphore, wait blocks the thread instead of spinning
+typedef struct PlatformSemaphore
+{
+    void* handle;
+} PlatformSemaphore;
+
 struct PlatformAPI;
 
+// NOTE: Flags for allocate_pages. The returned PlatformPages::flags only keeps
+//       the ones that took effect, e.g. LargePages is dropped when no large
+//       pages could be had (no SeLockMemoryPrivilege, no reserved hugetlbfs
+//       pages) and the allocation fell back to normal or transparent huge pages.
+typedef enum PlatformPageFlags
+{
+    // NOTE: Explicit huge pages, MEM_LARGE_PAGES / MAP_HUGETLB
+    PlatformPageFlags_LargePages           = 0b001,
+    // NOTE: Linux only, 2MB aligned and MADV_HUGEPAGE
+    PlatformPageFlags_TransparentHugePages = 0b010,
+    // NOTE: Spread pages round robin over every NUMA node
+    PlatformPageFlags_NumaInterleave       = 0b100
+} PlatformPageFlags;
+
+typedef struct PlatformPages
+{
+    void*  memory;
+    size_t size;
+    u32    flags;
+} PlatformPages;
+
+#define PLATFORM_NUMA_NODE_ANY (-1)
+
+// NOTE: Guarded allocations are a debugging aid that works in release builds
+//       too. When the environment variable is set to 1 at init,
+//       allocate_memory puts every allocation right before a no-access page
+//       so that overflows fault. PlatformAPI::memory gets the same
+//       treatment, so writing past its end faults too.
+//       The bytes between the start of the allocation's first page and the
+//       allocation, and between its size and the 16 byte aligned end, are
+//       filled with PLATFORM_GUARD_CANARY and checked on free. Freed memory is
+//       filled with PLATFORM_GUARD_POISON, made read only and only released
+//       after PLATFORM_GUARD_QUARANTINE_COUNT more frees, so writes after
+//       free fault and reads see the poison.
+#define PLATFORM_GUARDED_ALLOCATIONS_ENV  "GJ_GUARDED_ALLOCATIONS"
+#define PLATFORM_GUARD_CANARY             0xCA
+#define PLATFORM_GUARD_POISON             0xDD
+#define PLATFORM_GUARD_QUARANTINE_COUNT   1024
+#define PLATFORM_GUARD_MAGIC              0x4A47475541524430ull
+#define PLATFORM_GUARD_FREED_MAGIC        0x4A47465245454430ull
+
+typedef struct PlatformGuardedHeader
+{
+    u64    magic;
+    size_t mapping_size;
+    size_t size;
+    u8*    data;
+} PlatformGuardedHeader;
+
 typedef PlatformFileHandle   GetFileHandle(const char* file_name, u8 mode_flags);
 typedef void                 ReadDataFromFileHandle(PlatformFileHandle file_handle, u64 offset, u64 size, void* dst);
 typedef void                 WriteDataToFileHandle(PlatformFileHandle file_handle, u64 offset, size_t size, void* src);
 typedef void                 CloseFileHandle(PlatformFileHandle file_handle);
+typedef b32                  FlushFileHandle(PlatformFileHandle file_handle);
+typedef b32                  SetFileSize(PlatformFileHandle file_handle, u64 size);
 typedef u32                  ReadWholeFile(const char* file_name, void* dst);
+typedef PlatformMappedFile   MapFile(const char* file_name);
+typedef void                 UnmapFile(PlatformMappedFile mapped_file);
 typedef PlatformFileListing* ListFiles(void* memory, size_t memory_max_size, const char* file_name_pattern);
+typedef PlatformDirectoryListing WalkDirectory(void* memory, size_t memory_max_size, const char* directory, b32 recursive);
 typedef FileTime             GetFileLastWriteTime(const char* file_name);
 typedef b32                  CheckFileExists(const char* file_name);
+typedef u32                  AddFileWatch(const char* path, b32 recursive);
+typedef void                 RemoveFileWatch(u32 watch_id);
+typedef u32                  PollFileChanges(PlatformFileChange* changes, u32 max_change_count);
 typedef void*                AllocateMemory(size_t size);
 typedef void                 DeallocateMemory(void* memory);
+typedef void*                ReserveMemory(size_t size);
+typedef b32                  CommitMemory(void* memory, size_t size);
+typedef void                 ReleaseMemory(void* memory, size_t size);
+typedef PlatformPages        AllocatePages(size_t size, u32 flags, s32 numa_node);
+typedef void                 DeallocatePages(PlatformPages pages);
+typedef u32                  GetNumaNodeCount();
 typedef void                 NewThread(PlatformAPI* platform_api, PlatformThreadContext* thread_context);
 typedef b32                  WaitForThreads(PlatformAPI* platform_api, PlatformThreadContext* threads, u32 thread_count);
 typedef ThreadStatus         CheckThreadStatus(PlatformThreadContext thread_context);
 typedef void                 BeginTicketMutex(TicketMutex* ticket_mutex);
 typedef void                 EndTicketMutex(TicketMutex* ticket_mutex);
-typedef void                 LogError(char* file, char* function, s32 line, char* format, ...);
-typedef void                 LogInfo(char* file, char* function, s32 line, char* format, ...);
+typedef PlatformSemaphore    NewSemaphore(u32 initial_count, u32 max_count);
+typedef void                 SignalSemaphore(PlatformSemaphore semaphore);
+typedef void                 WaitForSemaphore(PlatformSemaphore semaphore);
+typedef void                 DeleteSemaphore(PlatformSemaphore semaphore);
+typedef void                 LogError(const char* file, const char* function, s32 line, const char* format, ...);
+typedef void                 LogInfo(const char* file, const char* function, s32 line, const char* format, ...);
 #if GJ_DEBUG
 typedef void                 DebugPrint(const char* format, ...);
 #endif
@@ -729,7 +2022,7 @@ typedef u64         GetSamplesLeft(SoundBuffer sound_buffer);
         char test[gj_FunctionPointerSize] = {};                         \
         for (int i = 0; i < sizeof(PlatformAPI._os_api); i += gj_FunctionPointerSize) \
         {                                                               \
-            _dummy_f* f = (_dummy_f*)((void*)(PlatformAPI._os_api + i)); \
+            void* f = (void*)(PlatformAPI._os_api + i);                 \
             gj_Assert(memcmp(f, test, gj_FunctionPointerSize)); \
         }                                                               \
     } while(0)
@@ -750,17 +2043,35 @@ typedef struct PlatformAPI
             ReadDataFromFileHandle* read_data_from_file_handle;
             WriteDataToFileHandle*  write_data_to_file_handle;
             CloseFileHandle*        close_file_handle;
+            FlushFileHandle*        flush_file_handle;
+            SetFileSize*            set_file_size;
             ReadWholeFile*          read_whole_file;
+            MapFile*                map_file;
+            UnmapFile*              unmap_file;
             ListFiles*              list_files;
+            WalkDirectory*          walk_directory;
             GetFileLastWriteTime*   get_file_last_write_time;
             CheckFileExists*        check_file_exists;
+            AddFileWatch*           add_file_watch;
+            RemoveFileWatch*        remove_file_watch;
+            PollFileChanges*        poll_file_changes;
             AllocateMemory*         allocate_memory;
             DeallocateMemory*       deallocate_memory;
+            ReserveMemory*          reserve_memory;
+            CommitMemory*           commit_memory;
+            ReleaseMemory*          release_memory;
+            AllocatePages*          allocate_pages;
+            DeallocatePages*        deallocate_pages;
+            GetNumaNodeCount*       get_numa_node_count;
             NewThread*              new_thread;
             WaitForThreads*         wait_for_threads;
             CheckThreadStatus*      check_thread_status;
             BeginTicketMutex*       begin_ticket_mutex;
             EndTicketMutex*         end_ticket_mutex;
+            NewSemaphore*           new_semaphore;
+            SignalSemaphore*        signal_semaphore;
+            WaitForSemaphore*       wait_for_semaphore;
+            DeleteSemaphore*        delete_semaphore;
             LogError*               log_error;
             LogInfo*                log_info;
 #if GJ_DEBUG
@@ -769,9 +2080,9 @@ typedef struct PlatformAPI
         };
 
 #if GJ_DEBUG
-        u8 _os_api[18 * sizeof(GetFileHandle*)];
+        u8 _os_api[36 * sizeof(GetFileHandle*)];
 #else
-        u8 _os_api[17 * sizeof(GetFileHandle*)];
+        u8 _os_api[35 * sizeof(GetFileHandle*)];
 #endif
     };
 
@@ -788,6 +2099,8 @@ typedef struct PlatformAPI
     //
     void*  memory;
     size_t memory_size;
+    u32    memory_flags;
+    b32    guarded_allocations;
 
     //
     // Window dimensions
@@ -805,4 +2118,139 @@ typedef struct PlatformAPI
 static PlatformAPI g_platform_api;
 #endif
 
+///////////////////////////////////////////////////////////////////////////
+// Parallel ranges
+///////////////////////////////////////////////////////////////////////////
+// NOTE: Splits a loop over [0, count) into one range per thread. The calling
+//       thread takes the first range, thread_count - 1 threads are started
+//       for the rest and gj_parallel_for returns once all of them are done.
+#define GJ_MAX_THREADS        64
+// NOTE: Items, fewer than this per thread isn't worth starting threads for
+//       when the work per item is small
+#define GJ_PARALLEL_MIN_RANGE 16384
+
+typedef void GJParallelRangeFunc(void* data, u32 thread_index, u64 first, u64 count);
+
+typedef struct GJParallelRange
+{
+    GJParallelRangeFunc* func;
+    void*                data;
+    u32                  thread_index;
+    u64                  first;
+    u64                  count;
+} GJParallelRange;
+
+// NOTE: The thread count gj_parallel_for uses for count items when asked
+//       for thread_count, with at least min_range items per thread. 1
+//       without a platform_api. Callers that keep per thread state size it
+//       with this.
+inline u32
+gj_parallel_thread_count(PlatformAPI* platform_api, u32 thread_count, u64 count, u64 min_range = 1)
+{
+    if (!platform_api) return 1;
+    u64 result = thread_count < GJ_MAX_THREADS ? thread_count : GJ_MAX_THREADS;
+    if (min_range && result > count / min_range) result = count / min_range;
+    return result ? (u32)result : 1;
+}
+
+static void
+gj__parallel_range_thread(void* param)
+{
+    GJParallelRange* range = (GJParallelRange*)param;
+    range->func(range->data, range->thread_index, range->first, range->count);
+}
+
+// NOTE: Range boundaries are even shares of count rounded down to a multiple
+//       of granularity, so only the last range ends on a partial group. The
+//       split only depends on thread_count, count and granularity, calls
+//       with the same ones get the same ranges.
+static void
+gj_parallel_for(PlatformAPI* platform_api, u32 thread_count, u64 count, GJParallelRangeFunc* func, void* data,
+                u64 granularity = 1)
+{
+    thread_count = gj_parallel_thread_count(platform_api, thread_count, count);
+    GJParallelRange       ranges[GJ_MAX_THREADS];
+    PlatformThreadContext threads[GJ_MAX_THREADS];
+    for (u32 thread_index = 0; thread_index < thread_count; thread_index++)
+    {
+        u64 first = count * thread_index / thread_count / granularity * granularity;
+        u64 end   = thread_index + 1 == thread_count ? count : count * (thread_index + 1) / thread_count / granularity * granularity;
+        GJParallelRange* range = &ranges[thread_index];
+        range->func         = func;
+        range->data         = data;
+        range->thread_index = thread_index;
+        range->first        = first;
+        range->count        = end - first;
+
+        if (thread_index > 0)
+        {
+            PlatformThreadContext* thread = &threads[thread_index - 1];
+            thread->thread_func = gj__parallel_range_thread;
+            thread->param       = range;
+            thread->platform    = NULL;
+            platform_api->new_thread(platform_api, thread);
+        }
+    }
+
+    gj__parallel_range_thread(&ranges[0]);
+    if (thread_count > 1) platform_api->wait_for_threads(platform_api, threads, thread_count - 1);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Growable array
+///////////////////////////////////////////////////////////////////////////
+// NOTE: Reserves address space for max_count elements up front and commits it
+//       as the array grows, so the data never moves and pointers into it stay
+//       valid. Reserving is cheap, max_count can be far more than will ever be
+//       used.
+#define GJ_GROWABLE_ARRAY_MIN_COMMIT Kilobytes(64)
+
+#define gj_DefineGrowableArray(Type, Name)                              \
+    struct Name                                                         \
+    {                                                                   \
+        Type* data;                                                     \
+        u32   count;                                                    \
+        u32   capacity;                                                 \
+        u32   max_count;                                                \
+        PlatformAPI* platform_api;                                      \
+                                                                        \
+        /* NOTE: Commits at least double what's committed */            \
+        b32 grow(u32 new_count)                                         \
+        {                                                               \
+            if (new_count <= capacity) return gj_True;                  \
+            gj_AssertDebug(new_count <= max_count);                     \
+            if (new_count > max_count) return gj_False;                 \
+                                                                        \
+            size_t committed = (size_t)capacity * sizeof(Type);         \
+            size_t wanted    = committed * 2;                           \
+            if (wanted < GJ_GROWABLE_ARRAY_MIN_COMMIT)  wanted = GJ_GROWABLE_ARRAY_MIN_COMMIT; \
+            if (wanted < new_count * sizeof(Type))      wanted = new_count * sizeof(Type); \
+            if (wanted > max_count * sizeof(Type))      wanted = max_count * sizeof(Type); \
+                                                                        \
+            if (!platform_api->commit_memory((u8*)data + committed, wanted - committed)) return gj_False; \
+            capacity = (u32)(wanted / sizeof(Type));                    \
+            return gj_True;                                             \
+        }                                                               \
+                                                                        \
+        gj__DefineArrayMethods(Type)                                    \
+    };                                                                  \
+                                                                        \
+    void Name##_init(Name* array, PlatformAPI* platform_api, u32 max_count) \
+    {                                                                   \
+        array->data         = (Type*)platform_api->reserve_memory((size_t)max_count * sizeof(Type)); \
+        array->count        = 0;                                        \
+        array->capacity     = 0;                                        \
+        array->max_count    = array->data ? max_count : 0;              \
+        array->platform_api = platform_api;                             \
+    }                                                                   \
+                                                                        \
+    void Name##_free(Name* array)                                       \
+    {                                                                   \
+        if (array->data) array->platform_api->release_memory(array->data, (size_t)array->max_count * sizeof(Type)); \
+        gj__ZeroStruct(*array);                                         \
+    }
+
+gj_DefineGrowableArray(u32, U32GrowableArray);
+gj_DefineGrowableArray(s32, S32GrowableArray);
+
 #endif
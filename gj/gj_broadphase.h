@@ -0,0 +1,190 @@
+#if !defined(GJ_BROADPHASE_H)
+#define GJ_BROADPHASE_H
+
+// Sort and sweep broad phase over 2D AABBs. Boxes are kept sorted by min x,
+// the sweep then only compares each box against the following ones until
+// their min x passes its max x, GJ_WIDE_LANES of them at a time, and emits
+// every pair whose boxes overlap (touching counts) into one compact list
+// for the narrow phase.
+//
+// The order is kept between updates. Boxes usually move little from one
+// tick to the next so the old order is almost sorted and an insertion sort
+// fixes it in about linear time. The first update, a change in box count
+// or too much shuffling falls back to a radix sort on min x.
+//
+//  GJBroadphase broadphase;
+//  gj_broadphase_create(&broadphase, &arena, entity_max, pair_max);
+//  // every tick
+//  u32 pair_count = gj_broadphase_update(&broadphase, &entities[0].min, &entities[0].max, sizeof(Entity), entity_count, &scratch);
+//  for (u32 i = 0; i < broadphase.pair_count; i++) narrow_phase(broadphase.pairs[i].a, broadphase.pairs[i].b);
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+
+// NOTE: An insertion sort moving boxes more than this many places per box on
+//       average is given up for a radix sort
+#define GJ_BROADPHASE_INSERTION_LIMIT 4
+
+// NOTE: a < b
+typedef struct GJBroadphasePair
+{
+    u32 a;
+    u32 b;
+} GJBroadphasePair;
+
+typedef struct GJBroadphase
+{
+    u32  capacity;
+    u32  count;
+
+    // NOTE: Box indices sorted by min x, and the bounds in that order. The
+    //       bound arrays have GJ_WIDE_LANES NaN entries past count so the
+    //       sweep needs no bounds checks, NaN never compares true.
+    u32* order;
+    f32* min_x;
+    f32* max_x;
+    f32* min_y;
+    f32* max_y;
+
+    // NOTE: Up to pair_capacity pairs, pair_count <= pair_capacity
+    GJBroadphasePair* pairs;
+    u32  pair_count;
+    u32  pair_capacity;
+
+    // NOTE: Stats of the last update
+    b32  radix_sorted;
+    u32  insertion_shifts;
+} GJBroadphase;
+
+static void
+gj_broadphase_create(GJBroadphase* broadphase, MemoryArena* arena, u32 capacity, u32 pair_capacity)
+{
+    u32 padded = capacity + GJ_WIDE_LANES;
+    broadphase->capacity         = capacity;
+    broadphase->count            = 0;
+    broadphase->order            = push_array(arena, u32, capacity);
+    broadphase->min_x            = (f32*)_push(arena, padded * sizeof(f32), 32);
+    broadphase->max_x            = (f32*)_push(arena, padded * sizeof(f32), 32);
+    broadphase->min_y            = (f32*)_push(arena, padded * sizeof(f32), 32);
+    broadphase->max_y            = (f32*)_push(arena, padded * sizeof(f32), 32);
+    broadphase->pairs            = push_array(arena, GJBroadphasePair, pair_capacity);
+    broadphase->pair_count       = 0;
+    broadphase->pair_capacity    = pair_capacity;
+    broadphase->radix_sorted     = gj_False;
+    broadphase->insertion_shifts = 0;
+}
+
+// NOTE: Sorts order/min_x by min_x, returns false when it gave up after
+//       GJ_BROADPHASE_INSERTION_LIMIT * count shifts. Both arrays are still a
+//       permutation of what they were then.
+static b32
+gj__broadphase_insertion_sort(GJBroadphase* broadphase)
+{
+    u32* order = broadphase->order;
+    f32* min_x = broadphase->min_x;
+    u32 count = broadphase->count;
+    u32 shift_limit = GJ_BROADPHASE_INSERTION_LIMIT * count;
+    u32 shifts = 0;
+    for (u32 i = 1; i < count; i++)
+    {
+        f32 key = min_x[i];
+        if (!(key < min_x[i - 1])) continue;
+        u32 box = order[i];
+        u32 j = i;
+        for (; j > 0 && key < min_x[j - 1]; j--)
+        {
+            min_x[j] = min_x[j - 1];
+            order[j] = order[j - 1];
+        }
+        min_x[j] = key;
+        order[j] = box;
+        shifts += i - j;
+        if (shifts > shift_limit)
+        {
+            broadphase->insertion_shifts = shifts;
+            return gj_False;
+        }
+    }
+    broadphase->insertion_shifts = shifts;
+    return gj_True;
+}
+
+// NOTE: box_min/box_max are read with stride bytes between boxes, box i gets
+//       index i in the pairs. Returns the number of overlapping pairs, when
+//       that's above pair_capacity only the first pair_capacity are kept.
+static u32
+gj_broadphase_update(GJBroadphase* broadphase, V2f* box_min, V2f* box_max, u64 stride, u32 count, MemoryArena* scratch)
+{
+    gj_AssertDebug(count <= broadphase->capacity);
+    u32* order = broadphase->order;
+    f32* min_x = broadphase->min_x;
+    f32* max_x = broadphase->max_x;
+    f32* min_y = broadphase->min_y;
+    f32* max_y = broadphase->max_y;
+    byte* mins = (byte*)box_min;
+    byte* maxs = (byte*)box_max;
+
+    // NOTE: Re-sort in the old order, or from scratch
+    b32 sorted = gj_False;
+    if (count == broadphase->count && count)
+    {
+        for (u32 i = 0; i < count; i++) min_x[i] = ((V2f*)(mins + order[i] * stride))->x;
+        sorted = gj__broadphase_insertion_sort(broadphase);
+    }
+    else
+    {
+        broadphase->count = count;
+        for (u32 i = 0; i < count; i++)
+        {
+            order[i] = i;
+            min_x[i] = ((V2f*)(mins + i * stride))->x;
+        }
+    }
+    broadphase->radix_sorted = !sorted;
+    if (!sorted) gj_radix_sort_f32(min_x, order, count, scratch);
+
+    for (u32 i = 0; i < count; i++)
+    {
+        u32 box = order[i];
+        V2f bmin = *(V2f*)(mins + box * stride);
+        V2f bmax = *(V2f*)(maxs + box * stride);
+        max_x[i] = bmax.x;
+        min_y[i] = bmin.y;
+        max_y[i] = bmax.y;
+    }
+    for (u32 i = count; i < count + GJ_WIDE_LANES; i++) min_x[i] = max_x[i] = min_y[i] = max_y[i] = NAN;
+
+    // NOTE: Sweep, the lanes passing the x test are always a prefix since
+    //       min_x is sorted, so the first lane failing it ends the box
+    u32 full_mask = (1u << GJ_WIDE_LANES) - 1;
+    u32 pair_count = 0;
+    for (u32 i = 0; i < count; i++)
+    {
+        WideF32 box_max_x = gj_wide_set1(max_x[i]);
+        WideF32 box_min_y = gj_wide_set1(min_y[i]);
+        WideF32 box_max_y = gj_wide_set1(max_y[i]);
+        u32 a = order[i];
+        for (u32 j = i + 1;; j += GJ_WIDE_LANES)
+        {
+            u32 in_x = gj_wide_movemask(gj_wide_cmple(gj_wide_load(min_x + j), box_max_x));
+            u32 hit = in_x & gj_wide_movemask(gj_wide_and(gj_wide_cmple(gj_wide_load(min_y + j), box_max_y),
+                                                          gj_wide_cmple(box_min_y, gj_wide_load(max_y + j))));
+            while (hit)
+            {
+                u32 b = order[j + gj_count_trailing_zeros_u32(hit)];
+                if (pair_count < broadphase->pair_capacity)
+                {
+                    broadphase->pairs[pair_count].a = gj_Min(a, b);
+                    broadphase->pairs[pair_count].b = gj_Max(a, b);
+                }
+                pair_count++;
+                hit &= hit - 1;
+            }
+            if (in_x != full_mask) break;
+        }
+    }
+    broadphase->pair_count = gj_Min(pair_count, broadphase->pair_capacity);
+    return pair_count;
+}
+
+#endif
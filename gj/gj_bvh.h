@@ -0,0 +1,639 @@
+#if !defined(GJ_BVH_H)
+#define GJ_BVH_H
+
+// Bounding volume hierarchy over an indexed triangle mesh, for picking and
+// raycasts against meshes too big to test every triangle (the positions and
+// indices gj_obj_loader_load outputs, three indices per triangle).
+//
+// Build is binned SAH. The top of the tree is split on the calling thread
+// until there is enough independent work, the subtrees are then built on
+// worker threads into their own node ranges and compacted into one array.
+// Nodes are 32 bytes and siblings are stored next to each other, so both
+// children of a node are in the same cache line.
+//
+// Queries walk the tree with a small stack, nearest child first, and return
+// the original triangle index (index / 3 into indices).
+//
+//  GJBVH bvh;
+//  gj_bvh_build(&bvh, &arena, positions, sizeof(Vertex), indices, index_count, &platform_api, 8);
+//  RayHit hit;
+//  if (gj_bvh_closest_hit(&bvh, ray_origin, ray_direction, &hit)) select(hit.triangle);
+//  b32 shadowed = gj_bvh_any_hit(&bvh, position, light_direction, light_distance);
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+
+#define GJ_BVH_BIN_COUNT        16
+// NOTE: Leaves are only made bigger than this if the depth limit is hit
+#define GJ_BVH_MAX_LEAF_SIZE    8
+// NOTE: Also the traversal stack size
+#define GJ_BVH_MAX_DEPTH        64
+// NOTE: SAH cost of visiting a node relative to testing a triangle
+#define GJ_BVH_TRAVERSAL_COST   1.0f
+#define GJ_BVH_TASKS_PER_THREAD 4
+// NOTE: Subtrees smaller than this are not worth handing to another thread
+#define GJ_BVH_MIN_TASK_SIZE    4096
+
+// NOTE: count == 0 is an inner node with children first and first + 1,
+//       otherwise a leaf with triangles [first, first + count)
+typedef struct GJBVHNode
+{
+    V3f min;
+    u32 first;
+    V3f max;
+    u32 count;
+} GJBVHNode;
+
+// NOTE: Triangles in leaf order, stored the way Moller-Trumbore wants them
+typedef struct GJBVHTriangle
+{
+    V3f v0;
+    V3f edge1;
+    V3f edge2;
+    u32 index;
+} GJBVHTriangle;
+
+typedef struct GJBVH
+{
+    GJBVHNode*     nodes;
+    u32            node_count;
+    GJBVHTriangle* triangles;
+    u32            triangle_count;
+} GJBVH;
+
+///////////////////////////////////////////////////////////////////////////
+// Build
+///////////////////////////////////////////////////////////////////////////
+// NOTE: Triangle bounds, the centroid is the center of the bounds
+typedef struct GJBVHPrimitive
+{
+    V3f min;
+    u32 index;
+    V3f max;
+    u32 pad;
+} GJBVHPrimitive;
+
+typedef struct GJBVHBuilder
+{
+    GJBVHNode*      nodes;
+    // NOTE: Partitioned in place as the tree is built, moving the records
+    //       instead of indices to them keeps every pass linear. Subtrees own
+    //       disjoint ranges so threads don't share any.
+    GJBVHPrimitive* primitives;
+} GJBVHBuilder;
+
+typedef struct GJBVHBuildTask
+{
+    u32 node;
+    u32 first;
+    u32 count;
+    u32 depth;
+    // NOTE: Node range the subtree allocates its children from
+    u32 node_base;
+    u32 node_used;
+} GJBVHBuildTask;
+
+typedef struct GJBVHBuildJob
+{
+    GJBVHBuilder*   builder;
+    GJBVHBuildTask* tasks;
+    u32             task_count;
+} GJBVHBuildJob;
+
+inline V3f gj__bvh_min(V3f a, V3f b) { return {gj_Min(a.x, b.x), gj_Min(a.y, b.y), gj_Min(a.z, b.z)}; }
+inline V3f gj__bvh_max(V3f a, V3f b) { return {gj_Max(a.x, b.x), gj_Max(a.y, b.y), gj_Max(a.z, b.z)}; }
+
+// NOTE: Half the surface area, only ever compared
+inline f32
+gj__bvh_area(__m128 min, __m128 max)
+{
+    __m128 e   = _mm_sub_ps(max, min);
+    __m128 yzx = _mm_shuffle_ps(e, e, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 products = _mm_mul_ps(e, yzx);
+    return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(products, _mm_shuffle_ps(products, products, 1)), _mm_movehl_ps(products, products)));
+}
+
+typedef struct GJBVHBin
+{
+    __m128 min;
+    __m128 max;
+    u32    count;
+} GJBVHBin;
+
+// NOTE: Writes the node bounds and decides between a leaf and a split.
+//       Returns the size of the left half, 0 for a leaf.
+//       Bounds are kept in SSE registers with the w lane (which holds index
+//       and pad in the primitive) cleared.
+static u32
+gj__bvh_split(GJBVHBuilder* builder, u32 node_index, u32 first, u32 count, u32 depth)
+{
+    GJBVHPrimitive* primitives = builder->primitives + first;
+    __m128 xyz          = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    __m128 half         = _mm_set1_ps(0.5f);
+    __m128 min          = _mm_set1_ps( FLT_MAX);
+    __m128 max          = _mm_set1_ps(-FLT_MAX);
+    __m128 centroid_min = min;
+    __m128 centroid_max = max;
+    for (u32 i = 0; i < count; i++)
+    {
+        __m128 primitive_min = _mm_and_ps(_mm_loadu_ps(&primitives[i].min.x), xyz);
+        __m128 primitive_max = _mm_and_ps(_mm_loadu_ps(&primitives[i].max.x), xyz);
+        __m128 centroid      = _mm_mul_ps(_mm_add_ps(primitive_min, primitive_max), half);
+        min          = _mm_min_ps(min, primitive_min);
+        max          = _mm_max_ps(max, primitive_max);
+        centroid_min = _mm_min_ps(centroid_min, centroid);
+        centroid_max = _mm_max_ps(centroid_max, centroid);
+    }
+    f32 node_bounds[8];
+    _mm_storeu_ps(node_bounds,     min);
+    _mm_storeu_ps(node_bounds + 4, max);
+    GJBVHNode* node = builder->nodes + node_index;
+    node->min   = {node_bounds[0], node_bounds[1], node_bounds[2]};
+    node->max   = {node_bounds[4], node_bounds[5], node_bounds[6]};
+    node->first = first;
+    node->count = count;
+    if (count <= 2 || depth >= GJ_BVH_MAX_DEPTH - 1) return 0;
+
+    // NOTE: All three axes binned in one pass, bin = (centroid - min) * scale
+    //       per lane. Small nodes get fewer bins, setting up and sweeping all
+    //       of them would cost more than the triangles themselves.
+    u32 bin_count = gj_Min(count, GJ_BVH_BIN_COUNT);
+    GJBVHBin bins[3][GJ_BVH_BIN_COUNT];
+    f32 extent[4];
+    f32 scales[4] = {};
+    _mm_storeu_ps(extent, _mm_sub_ps(centroid_max, centroid_min));
+    for (u32 axis = 0; axis < 3; axis++)
+    {
+        scales[axis] = extent[axis] > 0.0f ? (f32)bin_count / extent[axis] : 0.0f;
+        for (u32 b = 0; b < bin_count; b++)
+        {
+            bins[axis][b].min   = _mm_set1_ps( FLT_MAX);
+            bins[axis][b].max   = _mm_set1_ps(-FLT_MAX);
+            bins[axis][b].count = 0;
+        }
+    }
+    __m128i last_bin = _mm_set1_epi32(bin_count - 1);
+    __m128  scale    = _mm_loadu_ps(scales);
+    for (u32 i = 0; i < count; i++)
+    {
+        __m128 primitive_min = _mm_and_ps(_mm_loadu_ps(&primitives[i].min.x), xyz);
+        __m128 primitive_max = _mm_and_ps(_mm_loadu_ps(&primitives[i].max.x), xyz);
+        __m128 centroid      = _mm_mul_ps(_mm_add_ps(primitive_min, primitive_max), half);
+        __m128i b = _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(centroid, centroid_min), scale));
+        // NOTE: SSE2 has no epi32 min
+        __m128i over = _mm_cmpgt_epi32(b, last_bin);
+        b = _mm_or_si128(_mm_andnot_si128(over, b), _mm_and_si128(over, last_bin));
+        u32 indices[4];
+        _mm_storeu_si128((__m128i*)indices, b);
+        for (u32 axis = 0; axis < 3; axis++)
+        {
+            GJBVHBin* bin = &bins[axis][indices[axis]];
+            bin->min = _mm_min_ps(bin->min, primitive_min);
+            bin->max = _mm_max_ps(bin->max, primitive_max);
+            bin->count++;
+        }
+    }
+
+    f32 best_cost  = FLT_MAX;
+    u32 best_axis  = 0;
+    u32 best_split = 0;
+    for (u32 axis = 0; axis < 3; axis++)
+    {
+        if (scales[axis] == 0.0f) continue;
+
+        // NOTE: Sweep from the right, then from the left evaluating the
+        //       split after each bin
+        GJBVHBin* axis_bins = bins[axis];
+        f32 right_area[GJ_BVH_BIN_COUNT];
+        u32 right_count[GJ_BVH_BIN_COUNT];
+        __m128 right_min = axis_bins[bin_count - 1].min;
+        __m128 right_max = axis_bins[bin_count - 1].max;
+        u32    right_n   = 0;
+        for (u32 b = bin_count - 1; b > 0; b--)
+        {
+            right_min = _mm_min_ps(right_min, axis_bins[b].min);
+            right_max = _mm_max_ps(right_max, axis_bins[b].max);
+            right_n  += axis_bins[b].count;
+            right_area[b]  = right_n ? gj__bvh_area(right_min, right_max) : 0.0f;
+            right_count[b] = right_n;
+        }
+        __m128 left_min = axis_bins[0].min;
+        __m128 left_max = axis_bins[0].max;
+        u32    left_n   = 0;
+        for (u32 b = 0; b < bin_count - 1; b++)
+        {
+            left_min = _mm_min_ps(left_min, axis_bins[b].min);
+            left_max = _mm_max_ps(left_max, axis_bins[b].max);
+            left_n  += axis_bins[b].count;
+            if (!left_n || !right_count[b + 1]) continue;
+            f32 cost = left_n * gj__bvh_area(left_min, left_max) + right_count[b + 1] * right_area[b + 1];
+            if (cost < best_cost)
+            {
+                best_cost  = cost;
+                best_axis  = axis;
+                best_split = b;
+            }
+        }
+    }
+
+    f32 node_area = gj__bvh_area(min, max);
+    f32 leaf_cost = count * node_area;
+    if (best_cost == FLT_MAX)
+    {
+        // NOTE: All centroids in one spot, binning can't separate them
+        return count <= GJ_BVH_MAX_LEAF_SIZE ? 0 : count / 2;
+    }
+    best_cost += GJ_BVH_TRAVERSAL_COST * node_area;
+    if (best_cost >= leaf_cost && count <= GJ_BVH_MAX_LEAF_SIZE) return 0;
+
+    // NOTE: Same bin computation as above so the split matches the cost
+    f32 centroid_mins[4];
+    _mm_storeu_ps(centroid_mins, centroid_min);
+    f32 axis_min = centroid_mins[best_axis];
+    f32 axis_scale = scales[best_axis];
+    u32 left = 0;
+    u32 right = count;
+    while (left < right)
+    {
+        f32 centroid = (primitives[left].min.a[best_axis] + primitives[left].max.a[best_axis]) * 0.5f;
+        u32 b = (u32)((centroid - axis_min) * axis_scale);
+        if (gj_Min(b, bin_count - 1) <= best_split) left++;
+        else
+        {
+            right--;
+            GJBVHPrimitive swap = primitives[left]; primitives[left] = primitives[right]; primitives[right] = swap;
+        }
+    }
+    gj_AssertDebug(left > 0 && left < count);
+    return left;
+}
+
+static void
+gj__bvh_build_task(GJBVHBuilder* builder, GJBVHBuildTask* task)
+{
+    GJBVHBuildTask stack[GJ_BVH_MAX_DEPTH * 2];
+    u32 stack_count = 0;
+    stack[stack_count++] = *task;
+    u32 cursor = task->node_base;
+    while (stack_count)
+    {
+        GJBVHBuildTask entry = stack[--stack_count];
+        u32 left_count = gj__bvh_split(builder, entry.node, entry.first, entry.count, entry.depth);
+        if (!left_count) continue;
+
+        u32 children = cursor;
+        cursor += 2;
+        GJBVHNode* node = builder->nodes + entry.node;
+        node->first = children;
+        node->count = 0;
+        gj_AssertDebug(stack_count + 2 <= GJ_BVH_MAX_DEPTH * 2);
+        stack[stack_count++] = {children + 1, entry.first + left_count, entry.count - left_count, entry.depth + 1, 0, 0};
+        stack[stack_count++] = {children,     entry.first,              left_count,                entry.depth + 1, 0, 0};
+    }
+    task->node_used = cursor - task->node_base;
+}
+
+static void
+gj__bvh_build_job(GJBVHBuildJob* job)
+{
+    for (u32 i = 0; i < job->task_count; i++) gj__bvh_build_task(job->builder, job->tasks + i);
+}
+
+static void
+gj__bvh_build_range(void* data, u32, u64 first, u64 count)
+{
+    GJBVHBuildJob* jobs = (GJBVHBuildJob*)data;
+    for (u64 i = first; i < first + count; i++) gj__bvh_build_job(jobs + i);
+}
+
+static void
+gj_bvh_build(GJBVH* bvh, MemoryArena* arena, V3f* positions, u64 stride, s32* indices, u32 index_count,
+             PlatformAPI* platform_api = NULL, u32 thread_count = 1)
+{
+    u32 triangle_count = index_count / 3;
+    bvh->triangle_count = triangle_count;
+    bvh->node_count     = 0;
+    // NOTE: A binary tree over n leaves has at most 2n - 1 nodes, plus node
+    //       1 which is skipped so sibling pairs start on even indices
+    bvh->nodes          = (GJBVHNode*)_push(arena, gj_Max(2 * triangle_count, 2) * sizeof(GJBVHNode), 64);
+    bvh->triangles      = (GJBVHTriangle*)_push(arena, triangle_count * sizeof(GJBVHTriangle), 32);
+    if (!triangle_count) return;
+
+    BeginTemporaryMemoryBlock(arena);
+    GJBVHBuilder builder;
+    builder.nodes        = bvh->nodes;
+    builder.primitives   = (GJBVHPrimitive*)_push(arena, triangle_count * sizeof(GJBVHPrimitive), 32);
+    for (u32 triangle = 0; triangle < triangle_count; triangle++)
+    {
+        V3f v0 = *(V3f*)((byte*)positions + indices[3 * triangle + 0] * stride);
+        V3f v1 = *(V3f*)((byte*)positions + indices[3 * triangle + 1] * stride);
+        V3f v2 = *(V3f*)((byte*)positions + indices[3 * triangle + 2] * stride);
+        GJBVHPrimitive* primitive = builder.primitives + triangle;
+        primitive->min   = gj__bvh_min(v0, gj__bvh_min(v1, v2));
+        primitive->max   = gj__bvh_max(v0, gj__bvh_max(v1, v2));
+        primitive->index = triangle;
+
+        GJBVHTriangle* t = bvh->triangles + triangle;
+        t->v0    = v0;
+        t->edge1 = V3_sub(v1, v0);
+        t->edge2 = V3_sub(v2, v0);
+    }
+
+    // NOTE: Split the largest pending subtree on this thread until every
+    //       thread has a few to pick from
+    thread_count = gj_parallel_thread_count(platform_api, thread_count, triangle_count);
+    GJBVHBuildTask tasks[GJ_MAX_THREADS * GJ_BVH_TASKS_PER_THREAD];
+    u32 task_count = 0;
+    u32 cursor = 2;
+    tasks[task_count++] = {0, 0, triangle_count, 0, 0, 0};
+    if (thread_count > 1)
+    {
+        while (task_count < thread_count * GJ_BVH_TASKS_PER_THREAD)
+        {
+            u32 largest = 0;
+            for (u32 i = 1; i < task_count; i++) if (tasks[i].count > tasks[largest].count) largest = i;
+            GJBVHBuildTask task = tasks[largest];
+            if (task.count < GJ_BVH_MIN_TASK_SIZE) break;
+
+            tasks[largest] = tasks[--task_count];
+            u32 left_count = gj__bvh_split(&builder, task.node, task.first, task.count, task.depth);
+            if (!left_count) continue;
+            u32 children = cursor;
+            cursor += 2;
+            bvh->nodes[task.node].first = children;
+            bvh->nodes[task.node].count = 0;
+            tasks[task_count++] = {children,     task.first,              left_count,              task.depth + 1, 0, 0};
+            tasks[task_count++] = {children + 1, task.first + left_count, task.count - left_count, task.depth + 1, 0, 0};
+        }
+    }
+
+    // NOTE: Each subtree's children fit in 2 * count - 2 nodes
+    u32 top_count = cursor;
+    for (u32 i = 0; i < task_count; i++)
+    {
+        tasks[i].node_base = cursor;
+        cursor += 2 * tasks[i].count - 2;
+    }
+    gj_AssertDebug(cursor <= gj_Max(2 * triangle_count, 2));
+
+    u32 job_count = gj_Min(thread_count, task_count);
+    if (job_count <= 1)
+    {
+        GJBVHBuildJob job = {&builder, tasks, task_count};
+        gj__bvh_build_job(&job);
+    }
+    else
+    {
+        // NOTE: Largest first onto the least loaded thread
+        GJBVHBuildTask job_tasks[GJ_MAX_THREADS * GJ_BVH_TASKS_PER_THREAD];
+        u32            job_task_thread[GJ_MAX_THREADS * GJ_BVH_TASKS_PER_THREAD];
+        u64            job_load[GJ_MAX_THREADS] = {};
+        GJBVHBuildJob  jobs[GJ_MAX_THREADS];
+        for (u32 i = 0; i < task_count; i++)
+        {
+            for (u32 j = i + 1; j < task_count; j++)
+            {
+                if (tasks[j].count > tasks[i].count) { GJBVHBuildTask swap = tasks[i]; tasks[i] = tasks[j]; tasks[j] = swap; }
+            }
+            u32 least = 0;
+            for (u32 j = 1; j < job_count; j++) if (job_load[j] < job_load[least]) least = j;
+            job_task_thread[i] = least;
+            job_load[least]   += tasks[i].count;
+        }
+        u32 job_task_count = 0;
+        for (u32 j = 0; j < job_count; j++)
+        {
+            jobs[j].builder    = &builder;
+            jobs[j].tasks      = job_tasks + job_task_count;
+            jobs[j].task_count = 0;
+            for (u32 i = 0; i < task_count; i++)
+            {
+                if (job_task_thread[i] == j) job_tasks[job_task_count + jobs[j].task_count++] = tasks[i];
+            }
+            job_task_count += jobs[j].task_count;
+        }
+        // NOTE: One job per range
+        gj_parallel_for(platform_api, job_count, job_count, gj__bvh_build_range, jobs);
+        memcpy(tasks, job_tasks, task_count * sizeof(GJBVHBuildTask));
+        for (u32 i = 1; i < task_count; i++)
+        {
+            GJBVHBuildTask task = tasks[i];
+            u32 j = i;
+            for (; j > 0 && tasks[j - 1].node_base > task.node_base; j--) tasks[j] = tasks[j - 1];
+            tasks[j] = task;
+        }
+    }
+
+    // NOTE: Close the gaps between the subtree ranges in node_base order,
+    //       only links into a moved range need fixing and those come from
+    //       the range itself or from the subtree root
+    GJBVHNode* nodes = bvh->nodes;
+    u32 node_count = top_count;
+    for (u32 i = 0; i < task_count; i++)
+    {
+        GJBVHBuildTask* task = tasks + i;
+        u32 base  = task->node_base;
+        u32 end   = base + task->node_used;
+        u32 delta = base - node_count;
+        if (task->node_used)
+        {
+            for (u32 n = base; n < end; n++) if (!nodes[n].count) nodes[n].first -= delta;
+            if (!nodes[task->node].count) nodes[task->node].first -= delta;
+            memmove(nodes + node_count, nodes + base, task->node_used * sizeof(GJBVHNode));
+        }
+        node_count += task->node_used;
+    }
+    bvh->node_count = node_count;
+
+    // NOTE: Triangles into leaf order
+    GJBVHTriangle* unordered = push_array(arena, GJBVHTriangle, triangle_count);
+    memcpy(unordered, bvh->triangles, triangle_count * sizeof(GJBVHTriangle));
+    for (u32 i = 0; i < triangle_count; i++)
+    {
+        u32 triangle = builder.primitives[i].index;
+        bvh->triangles[i]       = unordered[triangle];
+        bvh->triangles[i].index = triangle;
+    }
+    EndTemporaryMemoryBlock(arena);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Queries
+///////////////////////////////////////////////////////////////////////////
+typedef struct GJBVHRay
+{
+    V3f origin;
+    V3f direction;
+    // NOTE: 1 / direction, +-inf for axis parallel rays
+    V3f inverse_direction;
+} GJBVHRay;
+
+typedef struct GJBVHStackEntry
+{
+    u32 node;
+    f32 t;
+} GJBVHStackEntry;
+
+// NOTE: Slab test against [0, t_max]. An axis parallel ray starting on a
+//       slab gives 0 * inf = NaN there, RaySlab__axis skips that axis so
+//       rays along a face or edge still hit the node.
+inline b32
+gj__bvh_ray_node(GJBVHRay* ray, GJBVHNode* node, f32 t_max, f32* t_enter_out)
+{
+    f32 t_enter = 0.0f;
+    f32 t_exit  = t_max;
+    for (u32 axis = 0; axis < 3; axis++)
+    {
+        RaySlab__axis(node->min.a[axis], node->max.a[axis], ray->origin.a[axis], ray->inverse_direction.a[axis], &t_enter, &t_exit);
+    }
+    *t_enter_out = t_enter;
+    return t_enter <= t_exit;
+}
+
+// NOTE: Same epsilon and accept rules as ray_triangle_intersection
+inline b32
+gj__bvh_ray_triangle(GJBVHRay* ray, GJBVHTriangle* triangle, f32 t_max, f32* t_out, f32* u_out, f32* v_out)
+{
+    f32 epsilon = 0.000001f;
+    V3f pvec = V3_cross(ray->direction, triangle->edge2);
+    f32 det = V3_dot(triangle->edge1, pvec);
+    if (det > -epsilon && det < epsilon) return gj_False;
+    f32 inv_det = 1.0f / det;
+
+    V3f tvec = V3_sub(ray->origin, triangle->v0);
+    f32 u = V3_dot(tvec, pvec) * inv_det;
+    if (u < 0.0f || u > 1.0f) return gj_False;
+
+    V3f qvec = V3_cross(tvec, triangle->edge1);
+    f32 v = V3_dot(ray->direction, qvec) * inv_det;
+    if (v < 0.0f || u + v > 1.0f) return gj_False;
+
+    f32 t = V3_dot(triangle->edge2, qvec) * inv_det;
+    if (t < 0.0f || t >= t_max) return gj_False;
+    *t_out = t;
+    *u_out = u;
+    *v_out = v;
+    return gj_True;
+}
+
+inline GJBVHRay
+gj__bvh_ray(V3f ray_origin, V3f ray_direction)
+{
+    GJBVHRay ray;
+    ray.origin            = ray_origin;
+    ray.direction         = ray_direction;
+    ray.inverse_direction = {1.0f / ray_direction.x, 1.0f / ray_direction.y, 1.0f / ray_direction.z};
+    return ray;
+}
+
+// NOTE: Nearest hit with t < t_max. hit->triangle is the original triangle
+//       index, GJ_RAY_NO_HIT (and false returned) if nothing was hit.
+static b32
+gj_bvh_closest_hit(GJBVH* bvh, V3f ray_origin, V3f ray_direction, RayHit* hit, f32 t_max = FLT_MAX)
+{
+    hit->t        = t_max;
+    hit->u        = 0.0f;
+    hit->v        = 0.0f;
+    hit->triangle = GJ_RAY_NO_HIT;
+    f32 t_root;
+    GJBVHRay ray = gj__bvh_ray(ray_origin, ray_direction);
+    if (!bvh->node_count || !gj__bvh_ray_node(&ray, bvh->nodes, t_max, &t_root)) return gj_False;
+
+    GJBVHStackEntry stack[GJ_BVH_MAX_DEPTH];
+    u32 stack_count = 0;
+    GJBVHNode* node = bvh->nodes;
+    for (;;)
+    {
+        if (node->count)
+        {
+            GJBVHTriangle* triangle = bvh->triangles + node->first;
+            for (u32 i = 0; i < node->count; i++, triangle++)
+            {
+                f32 t, u, v;
+                if (gj__bvh_ray_triangle(&ray, triangle, hit->t, &t, &u, &v))
+                {
+                    hit->t        = t;
+                    hit->u        = u;
+                    hit->v        = v;
+                    hit->triangle = triangle->index;
+                }
+            }
+        }
+        else
+        {
+            GJBVHNode* left  = bvh->nodes + node->first;
+            GJBVHNode* right = left + 1;
+            f32 t_left, t_right;
+            b32 hit_left  = gj__bvh_ray_node(&ray, left,  hit->t, &t_left);
+            b32 hit_right = gj__bvh_ray_node(&ray, right, hit->t, &t_right);
+            if (hit_left && hit_right)
+            {
+                if (t_right < t_left)
+                {
+                    GJBVHNode* swap = left; left = right; right = swap;
+                    t_right = t_left;
+                }
+                gj_AssertDebug(stack_count < GJ_BVH_MAX_DEPTH);
+                stack[stack_count++] = {(u32)(right - bvh->nodes), t_right};
+                node = left;
+                continue;
+            }
+            if (hit_left)  { node = left;  continue; }
+            if (hit_right) { node = right; continue; }
+        }
+
+        // NOTE: Skip whatever is now behind the closest hit
+        for (;;)
+        {
+            if (!stack_count) return hit->triangle != GJ_RAY_NO_HIT;
+            GJBVHStackEntry entry = stack[--stack_count];
+            if (entry.t < hit->t)
+            {
+                node = bvh->nodes + entry.node;
+                break;
+            }
+        }
+    }
+}
+
+// NOTE: Any hit with t < t_max, for occlusion and shadow rays
+static b32
+gj_bvh_any_hit(GJBVH* bvh, V3f ray_origin, V3f ray_direction, f32 t_max = FLT_MAX)
+{
+    f32 t_node;
+    GJBVHRay ray = gj__bvh_ray(ray_origin, ray_direction);
+    if (!bvh->node_count || !gj__bvh_ray_node(&ray, bvh->nodes, t_max, &t_node)) return gj_False;
+
+    u32 stack[GJ_BVH_MAX_DEPTH];
+    u32 stack_count = 0;
+    u32 node_index = 0;
+    for (;;)
+    {
+        GJBVHNode* node = bvh->nodes + node_index;
+        if (node->count)
+        {
+            GJBVHTriangle* triangle = bvh->triangles + node->first;
+            for (u32 i = 0; i < node->count; i++, triangle++)
+            {
+                f32 t, u, v;
+                if (gj__bvh_ray_triangle(&ray, triangle, t_max, &t, &u, &v)) return gj_True;
+            }
+        }
+        else
+        {
+            b32 hit_left  = gj__bvh_ray_node(&ray, bvh->nodes + node->first,     t_max, &t_node);
+            b32 hit_right = gj__bvh_ray_node(&ray, bvh->nodes + node->first + 1, t_max, &t_node);
+            if (hit_left && hit_right)
+            {
+                gj_AssertDebug(stack_count < GJ_BVH_MAX_DEPTH);
+                stack[stack_count++] = node->first + 1;
+            }
+            if (hit_left)  { node_index = node->first;     continue; }
+            if (hit_right) { node_index = node->first + 1; continue; }
+        }
+        if (!stack_count) return gj_False;
+        node_index = stack[--stack_count];
+    }
+}
+
+#endif
@@ -0,0 +1,417 @@
+#if !defined(GJ_COMPRESS_H)
+#define GJ_COMPRESS_H
+
+// LZ77 block compression, LZ4 style: byte aligned sequences of
+// (literals, 16 bit offset, match length), no entropy coding.
+//
+// The input is split into independent blocks of block_size bytes, so any
+// block can be decoded on its own and blocks can be spread across threads or
+// decoded as soon as they're read.
+//
+// Layout:
+//  GJCompressHeader
+//  u64 block_offsets[block_count + 1], relative to the start of block data
+//  block data, a block that didn't shrink is stored as is
+//
+// Compressing:
+//  u64 compressed_size;
+//  void* compressed = gj_compress(&arena, data, size, GJ_COMPRESS_DEFAULT_BLOCK_SIZE, &compressed_size);
+//
+// Decompressing:
+//  u64 size = gj_decompressed_size(compressed, compressed_size);
+//  void* data = push_size(&arena, size);
+//  gj_decompress(platform_api, compressed, compressed_size, data, size, 4);
+
+#include <gj/gj_base.h>
+
+#define GJ_COMPRESS_MAGIC              0x5A4C4A47 // "GJLZ"
+#define GJ_COMPRESS_DEFAULT_BLOCK_SIZE Kilobytes(256)
+
+#define GJ_LZ_HASH_BITS    12
+#define GJ_LZ_MIN_MATCH    4
+#define GJ_LZ_MAX_OFFSET   65535
+// NOTE: The last match has to start this far from the end of the block and
+//       the last bytes are always literals, which lets the decoder copy in
+//       8/16 byte chunks without checking every byte
+#define GJ_LZ_MF_LIMIT     12
+#define GJ_LZ_LAST_LITERALS 5
+
+struct GJCompressHeader
+{
+    u32 magic;
+    u32 block_size;
+    u64 uncompressed_size;
+    u64 block_count;
+};
+
+///////////////////////////////////////////////////////////////////////////
+// Block
+///////////////////////////////////////////////////////////////////////////
+inline u32
+gj_lz_compress_bound(u32 size) { return size + size / 255 + 16; }
+
+inline u32
+gj_lz_hash(u32 sequence) { return (sequence * 2654435761u) >> (32 - GJ_LZ_HASH_BITS); }
+
+inline u32
+gj_lz_match_length(const u8* a, const u8* b, const u8* a_end)
+{
+    const u8* a_start = a;
+    while (a + 8 <= a_end)
+    {
+        u64 diff = gj_read_u64(a) ^ gj_read_u64(b);
+        if (diff) return (u32)(a - a_start) + (gj_count_trailing_zeros_u64(diff) >> 3);
+        a += 8; b += 8;
+    }
+    while (a < a_end && *a == *b) { a++; b++; }
+    return (u32)(a - a_start);
+}
+
+inline u8*
+gj_lz_write_length(u8* op, u32 length)
+{
+    for (; length >= 255; length -= 255) *op++ = 255;
+    *op++ = (u8)length;
+    return op;
+}
+
+static u8*
+gj_lz_write_sequence(u8* op, const u8* literals, u32 literal_count, u32 offset, u32 match_length)
+{
+    u8* token = op++;
+    u32 match_code = match_length - GJ_LZ_MIN_MATCH;
+
+    *token = (u8)((literal_count >= 15 ? 15 : literal_count) << 4);
+    if (literal_count >= 15) op = gj_lz_write_length(op, literal_count - 15);
+    memcpy(op, literals, literal_count);
+    op += literal_count;
+
+    if (match_length == 0) return op;
+
+    *op++ = (u8)(offset & 0xFF);
+    *op++ = (u8)(offset >> 8);
+    *token |= (u8)(match_code >= 15 ? 15 : match_code);
+    if (match_code >= 15) op = gj_lz_write_length(op, match_code - 15);
+
+    return op;
+}
+
+// NOTE: dst must hold gj_lz_compress_bound(src_size) bytes, 0 is returned
+//       otherwise. Greedy matching, the search skips ahead faster the longer
+//       it goes without a match.
+static u32
+gj_lz_compress_block(const void* src, u32 src_size, void* dst, u32 dst_capacity)
+{
+    if (dst_capacity < gj_lz_compress_bound(src_size)) return 0;
+
+    const u8* ip     = (const u8*)src;
+    const u8* base   = ip;
+    const u8* anchor = ip;
+    const u8* end    = ip + src_size;
+    u8* op = (u8*)dst;
+
+    if (src_size > GJ_LZ_MF_LIMIT)
+    {
+        const u8* match_limit  = end - GJ_LZ_LAST_LITERALS;
+        const u8* search_limit = end - GJ_LZ_MF_LIMIT;
+        u32 hash_table[1 << GJ_LZ_HASH_BITS];
+        memset(hash_table, 0, sizeof(hash_table));
+
+        ip++;
+        while (ip < search_limit)
+        {
+            u32 sequence = gj_read_u32(ip);
+            u32 hash     = gj_lz_hash(sequence);
+            const u8* ref = base + hash_table[hash];
+            hash_table[hash] = (u32)(ip - base);
+
+            if (ref >= ip || ip - ref > GJ_LZ_MAX_OFFSET || gj_read_u32(ref) != sequence)
+            {
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]) { ip--; ref--; }
+
+            u32 match_length = GJ_LZ_MIN_MATCH + gj_lz_match_length(ip + GJ_LZ_MIN_MATCH, ref + GJ_LZ_MIN_MATCH, match_limit);
+            op = gj_lz_write_sequence(op, anchor, (u32)(ip - anchor), (u32)(ip - ref), match_length);
+
+            ip += match_length;
+            anchor = ip;
+            if (ip - 2 > base && ip < search_limit) hash_table[gj_lz_hash(gj_read_u32(ip - 2))] = (u32)(ip - 2 - base);
+        }
+    }
+
+    op = gj_lz_write_sequence(op, anchor, (u32)(end - anchor), 0, 0);
+    return (u32)(op - (u8*)dst);
+}
+
+inline b32
+gj_lz_read_length(const u8** ip, const u8* end, u32* length)
+{
+    u32 byte;
+    do
+    {
+        if (*ip >= end) return gj_False;
+        byte = *(*ip)++;
+        *length += byte;
+    } while (byte == 255);
+    return gj_True;
+}
+
+// NOTE: Fails on malformed input instead of reading or writing out of bounds,
+//       dst_size has to be the exact decompressed size
+static b32
+gj_lz_decompress_block(const void* src, u32 src_size, void* dst, u32 dst_size)
+{
+    const u8* ip     = (const u8*)src;
+    const u8* ip_end = ip + src_size;
+    u8* op     = (u8*)dst;
+    u8* op_end = op + dst_size;
+
+    for (;;)
+    {
+        if (ip >= ip_end) return gj_False;
+        u32 token = *ip++;
+
+        // NOTE: Fast path for the common short sequence, fixed size copies and
+        //       no length bytes. Needs room for 16 literal bytes plus the offset
+        //       on the input side and 16 + 18 bytes on the output side.
+        if (token < (15 << 4) && (token & 15) < 15 && ip_end - ip >= 16 + 2 && op_end - op >= 16 + 18)
+        {
+            u32 literal_count = token >> 4;
+            memcpy(op, ip, 16);
+            ip += literal_count;
+            op += literal_count;
+
+            if (ip_end - ip >= 2)
+            {
+                u32 offset = ip[0] | (ip[1] << 8);
+                u32 match_length = (token & 15) + GJ_LZ_MIN_MATCH;
+                if (offset >= 8 && offset <= (u64)(op - (u8*)dst) && match_length <= (u64)(op_end - op))
+                {
+                    const u8* match = op - offset;
+                    ip += 2;
+                    memcpy(op,      match,      8);
+                    memcpy(op + 8,  match + 8,  8);
+                    memcpy(op + 16, match + 16, 2);
+                    op += match_length;
+                    continue;
+                }
+            }
+
+            // NOTE: Not a plain match, back up and take the careful path
+            ip -= literal_count;
+            op -= literal_count;
+        }
+
+        u32 literal_count = token >> 4;
+        if (literal_count == 15 && !gj_lz_read_length(&ip, ip_end, &literal_count)) return gj_False;
+        if (literal_count > (u64)(ip_end - ip) || literal_count > (u64)(op_end - op)) return gj_False;
+
+        if ((u64)(ip_end - ip) >= literal_count + 16 && (u64)(op_end - op) >= literal_count + 16)
+        {
+            const u8* copy_from = ip;
+            u8* copy_to = op;
+            do { memcpy(copy_to, copy_from, 16); copy_to += 16; copy_from += 16; } while (copy_to < op + literal_count);
+        }
+        else
+        {
+            memcpy(op, ip, literal_count);
+        }
+        ip += literal_count;
+        op += literal_count;
+
+        if (ip == ip_end) break;
+
+        if (ip_end - ip < 2) return gj_False;
+        u32 offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (u64)(op - (u8*)dst)) return gj_False;
+
+        u32 match_length = token & 15;
+        if (match_length == 15 && !gj_lz_read_length(&ip, ip_end, &match_length)) return gj_False;
+        match_length += GJ_LZ_MIN_MATCH;
+        if (match_length > (u64)(op_end - op)) return gj_False;
+
+        const u8* match = op - offset;
+        u8* match_end = op + match_length;
+        if (offset >= 16 && (u64)(op_end - op) >= match_length + 16)
+        {
+            do { memcpy(op, match, 16); op += 16; match += 16; } while (op < match_end);
+        }
+        else if (offset >= 8 && (u64)(op_end - op) >= match_length + 8)
+        {
+            do { memcpy(op, match, 8); op += 8; match += 8; } while (op < match_end);
+        }
+        else
+        {
+            // NOTE: Overlapping copy, short offsets repeat the last bytes
+            while (op < match_end) *op++ = *match++;
+        }
+        op = match_end;
+    }
+
+    return op == op_end;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Stream of blocks
+///////////////////////////////////////////////////////////////////////////
+inline u64
+gj_compress_block_count(u64 size, u32 block_size) { return (size + block_size - 1) / block_size; }
+
+inline u64
+gj_compress_bound(u64 size, u32 block_size)
+{
+    u64 block_count = gj_compress_block_count(size, block_size);
+    return sizeof(GJCompressHeader) + (block_count + 1) * sizeof(u64) + size + block_count * 16 + size / 255;
+}
+
+// NOTE: Returns the compressed size, or 0 when it doesn't fit in
+//       dst_capacity bytes. gj_compress_bound(src_size, block_size) bytes
+//       always fit.
+static u64
+gj_compress(const void* src, u64 src_size, void* dst, u64 dst_capacity, u32 block_size)
+{
+    if (block_size == 0) return 0;
+    u64 block_count = gj_compress_block_count(src_size, block_size);
+    u64 table_size  = sizeof(GJCompressHeader) + (block_count + 1) * sizeof(u64);
+    if (dst_capacity < table_size) return 0;
+    u64 blocks_capacity = dst_capacity - table_size;
+
+    GJCompressHeader* header = (GJCompressHeader*)dst;
+    header->magic             = GJ_COMPRESS_MAGIC;
+    header->block_size        = block_size;
+    header->uncompressed_size = src_size;
+    header->block_count       = block_count;
+
+    u64* block_offsets = (u64*)(header + 1);
+    u8*  blocks        = (u8*)(block_offsets + block_count + 1);
+    u64  offset        = 0;
+
+    for (u64 block_index = 0; block_index < block_count; block_index++)
+    {
+        const u8* block = (const u8*)src + block_index * block_size;
+        u32 size = (u32)(block_index + 1 < block_count ? block_size : src_size - block_index * block_size);
+
+        block_offsets[block_index] = offset;
+        // NOTE: A block is stored as is when there's no room for its worst case
+        u64 room = blocks_capacity - offset;
+        if (room < size) return 0;
+        u32 block_bound = gj_lz_compress_bound(size);
+        u32 compressed_size = room >= block_bound ? gj_lz_compress_block(block, size, blocks + offset, block_bound) : size;
+        if (compressed_size == 0 || compressed_size >= size)
+        {
+            memcpy(blocks + offset, block, size);
+            compressed_size = size;
+        }
+        offset += compressed_size;
+    }
+    block_offsets[block_count] = offset;
+
+    return (u8*)(blocks + offset) - (u8*)dst;
+}
+
+// NOTE: Pushes the worst case size and gives back what wasn't used, so the
+//       result has to be the last thing pushed for that to work
+static void*
+gj_compress(MemoryArena* arena, const void* src, u64 src_size, u32 block_size, u64* compressed_size)
+{
+    u64 bound = gj_compress_bound(src_size, block_size);
+    u8* result = (u8*)_push_no_zero(arena, bound, 8);
+    *compressed_size = gj_compress(src, src_size, result, bound, block_size);
+    arena->used = (result - arena->base) + *compressed_size;
+    return result;
+}
+
+static b32
+gj_compress_check_header(const void* src, u64 src_size)
+{
+    GJCompressHeader* header = (GJCompressHeader*)src;
+    return (src_size >= sizeof(GJCompressHeader) &&
+            header->magic == GJ_COMPRESS_MAGIC &&
+            header->block_size > 0 &&
+            header->block_count == gj_compress_block_count(header->uncompressed_size, header->block_size) &&
+            (header->block_count + 1) <= (src_size - sizeof(GJCompressHeader)) / sizeof(u64));
+}
+
+// NOTE: 0 if src isn't a valid stream
+inline u64
+gj_decompressed_size(const void* src, u64 src_size)
+{ return gj_compress_check_header(src, src_size) ? ((GJCompressHeader*)src)->uncompressed_size : 0; }
+
+// NOTE: Decompresses blocks [first_block, first_block + block_count) into their
+//       place in dst, which has the full decompressed size. Safe to call from
+//       several threads on disjoint ranges. False for a bad stream or a range
+//       past the last block.
+static b32
+gj_decompress_blocks(const void* src, u64 src_size, void* dst, u64 first_block, u64 block_count)
+{
+    if (!gj_compress_check_header(src, src_size)) return gj_False;
+    GJCompressHeader* header = (GJCompressHeader*)src;
+    if (first_block > header->block_count || block_count > header->block_count - first_block) return gj_False;
+    u64* block_offsets = (u64*)(header + 1);
+    u8*  blocks        = (u8*)(block_offsets + header->block_count + 1);
+    u64  blocks_size   = src_size - (blocks - (u8*)src);
+
+    for (u64 block_index = first_block; block_index < first_block + block_count; block_index++)
+    {
+        u64 start = block_offsets[block_index];
+        u64 end   = block_offsets[block_index + 1];
+        if (start > end || end > blocks_size) return gj_False;
+
+        u64 dst_offset = block_index * header->block_size;
+        u32 size = (u32)(block_index + 1 < header->block_count ? header->block_size : header->uncompressed_size - dst_offset);
+        u8* block_dst = (u8*)dst + dst_offset;
+
+        if (end - start == size)
+        {
+            memcpy(block_dst, blocks + start, size);
+        }
+        else if (!gj_lz_decompress_block(blocks + start, (u32)(end - start), block_dst, size))
+        {
+            return gj_False;
+        }
+    }
+    return gj_True;
+}
+
+struct GJDecompressJob
+{
+    const void* src;
+    u64         src_size;
+    void*       dst;
+    b32         ok[GJ_MAX_THREADS];
+};
+
+static void
+gj_decompress_range(void* data, u32 thread_index, u64 first_block, u64 block_count)
+{
+    GJDecompressJob* job = (GJDecompressJob*)data;
+    job->ok[thread_index] = gj_decompress_blocks(job->src, job->src_size, job->dst, first_block, block_count);
+}
+
+// NOTE: dst_size must be gj_decompressed_size(src, src_size). The blocks are
+//       split over up to thread_count threads with gj_parallel_for.
+static b32
+gj_decompress(PlatformAPI* platform_api, const void* src, u64 src_size, void* dst, u64 dst_size, u32 thread_count = 1)
+{
+    GJCompressHeader* header = (GJCompressHeader*)src;
+    if (!gj_compress_check_header(src, src_size) || header->uncompressed_size != dst_size) return gj_False;
+
+    u64 block_count = header->block_count;
+    thread_count = gj_parallel_thread_count(platform_api, thread_count, block_count);
+
+    GJDecompressJob job;
+    job.src      = src;
+    job.src_size = src_size;
+    job.dst      = dst;
+    gj_parallel_for(platform_api, thread_count, block_count, gj_decompress_range, &job);
+
+    b32 result = gj_True;
+    for (u32 thread_index = 0; thread_index < thread_count; thread_index++) result = result && job.ok[thread_index];
+    return result;
+}
+
+#endif
@@ -409,6 +409,246 @@ V2_rectangle_contains_rectangle(V2f r1_min_pos, V2f r1_max_pos,
             V2_rectangle_contains_point(r1_min_pos, r1_max_pos, r2_min_max_pos) ||
             V2_rectangle_contains_point(r1_min_pos, r1_max_pos, r2_max_min_pos));
 }
+///////////////////////////////////////////////////////////////////////////
+// Wide Floats
+///////////////////////////////////////////////////////////////////////////
+// NOTE: 8 lanes with AVX, 4 with SSE. Only plain IEEE ops (no FMA/rcp) so
+//       the batch kernels give the same bits as the scalar functions.
+#if defined(GJ_AVX)
+#define GJ_WIDE_LANES 8
+typedef __m256 WideF32;
+inline WideF32 gj_wide_set1 (f32 x)                  { return _mm256_set1_ps(x); }
+inline WideF32 gj_wide_load (const f32* p)           { return _mm256_loadu_ps(p); }
+inline void    gj_wide_store(f32* p, WideF32 x)      { _mm256_storeu_ps(p, x); }
+inline WideF32 gj_wide_add  (WideF32 a, WideF32 b)   { return _mm256_add_ps(a, b); }
+inline WideF32 gj_wide_sub  (WideF32 a, WideF32 b)   { return _mm256_sub_ps(a, b); }
+inline WideF32 gj_wide_mul  (WideF32 a, WideF32 b)   { return _mm256_mul_ps(a, b); }
+inline WideF32 gj_wide_div  (WideF32 a, WideF32 b)   { return _mm256_div_ps(a, b); }
+inline WideF32 gj_wide_sqrt (WideF32 a)              { return _mm256_sqrt_ps(a); }
+inline WideF32 gj_wide_min  (WideF32 a, WideF32 b)   { return _mm256_min_ps(a, b); }
+inline WideF32 gj_wide_max  (WideF32 a, WideF32 b)   { return _mm256_max_ps(a, b); }
+// NOTE: mask ? b : a
+inline WideF32 gj_wide_select(WideF32 a, WideF32 b, WideF32 mask) { return _mm256_blendv_ps(a, b, mask); }
+inline WideF32 gj_wide_cmpeq (WideF32 a, WideF32 b)  { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+inline WideF32 gj_wide_cmplt (WideF32 a, WideF32 b)  { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline WideF32 gj_wide_cmple (WideF32 a, WideF32 b)  { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+// NOTE: Either is NaN
+inline WideF32 gj_wide_cmpunord(WideF32 a, WideF32 b) { return _mm256_cmp_ps(a, b, _CMP_UNORD_Q); }
+inline WideF32 gj_wide_and   (WideF32 a, WideF32 b)  { return _mm256_and_ps(a, b); }
+inline WideF32 gj_wide_or    (WideF32 a, WideF32 b)  { return _mm256_or_ps(a, b); }
+inline u32     gj_wide_movemask(WideF32 a)           { return (u32)_mm256_movemask_ps(a); }
+inline WideF32 gj_wide_abs  (WideF32 a)              { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+#else
+#define GJ_WIDE_LANES 4
+typedef __m128 WideF32;
+inline WideF32 gj_wide_set1 (f32 x)                  { return _mm_set1_ps(x); }
+inline WideF32 gj_wide_load (const f32* p)           { return _mm_loadu_ps(p); }
+inline void    gj_wide_store(f32* p, WideF32 x)      { _mm_storeu_ps(p, x); }
+inline WideF32 gj_wide_add  (WideF32 a, WideF32 b)   { return _mm_add_ps(a, b); }
+inline WideF32 gj_wide_sub  (WideF32 a, WideF32 b)   { return _mm_sub_ps(a, b); }
+inline WideF32 gj_wide_mul  (WideF32 a, WideF32 b)   { return _mm_mul_ps(a, b); }
+inline WideF32 gj_wide_div  (WideF32 a, WideF32 b)   { return _mm_div_ps(a, b); }
+inline WideF32 gj_wide_sqrt (WideF32 a)              { return _mm_sqrt_ps(a); }
+inline WideF32 gj_wide_min  (WideF32 a, WideF32 b)   { return _mm_min_ps(a, b); }
+inline WideF32 gj_wide_max  (WideF32 a, WideF32 b)   { return _mm_max_ps(a, b); }
+inline WideF32 gj_wide_select(WideF32 a, WideF32 b, WideF32 mask) { return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b)); }
+inline WideF32 gj_wide_cmpeq (WideF32 a, WideF32 b)  { return _mm_cmpeq_ps(a, b); }
+inline WideF32 gj_wide_cmplt (WideF32 a, WideF32 b)  { return _mm_cmplt_ps(a, b); }
+inline WideF32 gj_wide_cmple (WideF32 a, WideF32 b)  { return _mm_cmple_ps(a, b); }
+inline WideF32 gj_wide_cmpunord(WideF32 a, WideF32 b) { return _mm_cmpunord_ps(a, b); }
+inline WideF32 gj_wide_and   (WideF32 a, WideF32 b)  { return _mm_and_ps(a, b); }
+inline WideF32 gj_wide_or    (WideF32 a, WideF32 b)  { return _mm_or_ps(a, b); }
+inline u32     gj_wide_movemask(WideF32 a)           { return (u32)_mm_movemask_ps(a); }
+inline WideF32 gj_wide_abs  (WideF32 a)              { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+#endif
+
+///////////////////////////////////////////////////////////////////////////
+// Structure of Arrays
+///////////////////////////////////////////////////////////////////////////
+// NOTE: Batch versions of the V3 functions over V3fSoA, GJ_WIDE_LANES at a
+//       time with a scalar tail using the same operations in the same order.
+//       dst can be one of the inputs, all of them need at least dst->count.
+typedef struct V3fSoA
+{
+    f32* x;
+    f32* y;
+    f32* z;
+    u32  count;
+} V3fSoA;
+
+static V3fSoA
+V3fSoA_create(MemoryArena* arena, u32 count)
+{
+    V3fSoA result;
+    result.count = count;
+    result.x     = (f32*)_push(arena, count * sizeof(f32), 32);
+    result.y     = (f32*)_push(arena, count * sizeof(f32), 32);
+    result.z     = (f32*)_push(arena, count * sizeof(f32), 32);
+    return result;
+}
+
+inline V3f  V3fSoA_get(V3fSoA* soa, u32 i)        { gj_AssertDebug(i < soa->count); return {soa->x[i], soa->y[i], soa->z[i]}; }
+inline void V3fSoA_set(V3fSoA* soa, u32 i, V3f v) { gj_AssertDebug(i < soa->count); soa->x[i] = v.x; soa->y[i] = v.y; soa->z[i] = v.z; }
+
+static void
+V3fSoA_from_V3f(V3fSoA* dst, V3f* src, u32 count)
+{
+    gj_AssertDebug(count <= dst->count);
+    for (u32 i = 0; i < count; i++) { dst->x[i] = src[i].x; dst->y[i] = src[i].y; dst->z[i] = src[i].z; }
+}
+
+static void
+V3fSoA_to_V3f(V3f* dst, V3fSoA* src, u32 count)
+{
+    gj_AssertDebug(count <= src->count);
+    for (u32 i = 0; i < count; i++) { dst[i].x = src->x[i]; dst[i].y = src->y[i]; dst[i].z = src->z[i]; }
+}
+
+// NOTE: Body is instantiated once with WideF32 and once with f32 for the
+//       tail. The gj_wide_ ops have f32 overloads so only load/store/set1
+//       differ between the two.
+inline f32  gj_wide_add (f32 a, f32 b) { return a + b; }
+inline f32  gj_wide_sub (f32 a, f32 b) { return a - b; }
+inline f32  gj_wide_mul (f32 a, f32 b) { return a * b; }
+inline f32  gj_wide_div (f32 a, f32 b) { return a / b; }
+inline f32  gj_wide_sqrt(f32 a)        { return gj_sqrt(a); }
+inline f32  gj__scalar_set1 (f32 x)          { return x; }
+inline f32  gj__scalar_load (const f32* p)   { return *p; }
+inline void gj__scalar_store(f32* p, f32 x)  { *p = x; }
+
+#define gj__SoALoop(count, Body)                                                        \
+    {                                                                                   \
+        u32 i = 0;                                                                      \
+        for (; i + GJ_WIDE_LANES <= (count); i += GJ_WIDE_LANES)                        \
+        {                                                                               \
+            Body(WideF32, gj_wide_load, gj_wide_store, gj_wide_set1)                    \
+        }                                                                               \
+        for (; i < (count); i++)                                                        \
+        {                                                                               \
+            Body(f32, gj__scalar_load, gj__scalar_store, gj__scalar_set1)               \
+        }                                                                               \
+    }
+
+static void
+V3_add(V3fSoA* dst, V3fSoA* a, V3fSoA* b)
+{
+#define Body(T, load, store, set1)                                                          \
+    store(dst->x + i, gj_wide_add(load(a->x + i), load(b->x + i)));                         \
+    store(dst->y + i, gj_wide_add(load(a->y + i), load(b->y + i)));                         \
+    store(dst->z + i, gj_wide_add(load(a->z + i), load(b->z + i)));
+    gj__SoALoop(dst->count, Body)
+#undef Body
+}
+
+static void
+V3_sub(V3fSoA* dst, V3fSoA* a, V3fSoA* b)
+{
+#define Body(T, load, store, set1)                                                          \
+    store(dst->x + i, gj_wide_sub(load(a->x + i), load(b->x + i)));                         \
+    store(dst->y + i, gj_wide_sub(load(a->y + i), load(b->y + i)));                         \
+    store(dst->z + i, gj_wide_sub(load(a->z + i), load(b->z + i)));
+    gj__SoALoop(dst->count, Body)
+#undef Body
+}
+
+static void
+V3_mul(V3fSoA* dst, V3fSoA* a, V3fSoA* b)
+{
+#define Body(T, load, store, set1)                                                          \
+    store(dst->x + i, gj_wide_mul(load(a->x + i), load(b->x + i)));                         \
+    store(dst->y + i, gj_wide_mul(load(a->y + i), load(b->y + i)));                         \
+    store(dst->z + i, gj_wide_mul(load(a->z + i), load(b->z + i)));
+    gj__SoALoop(dst->count, Body)
+#undef Body
+}
+
+static void
+V3_mul(V3fSoA* dst, f32 c, V3fSoA* a)
+{
+#define Body(T, load, store, set1)                                                          \
+    T vc = set1(c);                                                                         \
+    store(dst->x + i, gj_wide_mul(vc, load(a->x + i)));                                     \
+    store(dst->y + i, gj_wide_mul(vc, load(a->y + i)));                                     \
+    store(dst->z + i, gj_wide_mul(vc, load(a->z + i)));
+    gj__SoALoop(dst->count, Body)
+#undef Body
+}
+
+// NOTE: dst[i] = dot(a[i], b[i])
+static void
+V3_dot(f32* dst, V3fSoA* a, V3fSoA* b, u32 count)
+{
+#define Body(T, load, store, set1)                                                          \
+    T d = gj_wide_add(gj_wide_add(gj_wide_mul(load(a->x + i), load(b->x + i)),              \
+                                  gj_wide_mul(load(a->y + i), load(b->y + i))),             \
+                      gj_wide_mul(load(a->z + i), load(b->z + i)));                         \
+    store(dst + i, d);
+    gj__SoALoop(count, Body)
+#undef Body
+}
+
+static void
+V3_cross(V3fSoA* dst, V3fSoA* a, V3fSoA* b)
+{
+#define Body(T, load, store, set1)                                                          \
+    T ax = load(a->x + i), ay = load(a->y + i), az = load(a->z + i);                        \
+    T bx = load(b->x + i), by = load(b->y + i), bz = load(b->z + i);                        \
+    store(dst->x + i, gj_wide_sub(gj_wide_mul(ay, bz), gj_wide_mul(az, by)));               \
+    store(dst->y + i, gj_wide_sub(gj_wide_mul(az, bx), gj_wide_mul(ax, bz)));               \
+    store(dst->z + i, gj_wide_sub(gj_wide_mul(ax, by), gj_wide_mul(ay, bx)));
+    gj__SoALoop(dst->count, Body)
+#undef Body
+}
+
+// NOTE: dst[i] = |a[i] - b[i]|
+static void
+V3_distance(f32* dst, V3fSoA* a, V3fSoA* b, u32 count)
+{
+#define Body(T, load, store, set1)                                                          \
+    T dx = gj_wide_sub(load(a->x + i), load(b->x + i));                                     \
+    T dy = gj_wide_sub(load(a->y + i), load(b->y + i));                                     \
+    T dz = gj_wide_sub(load(a->z + i), load(b->z + i));                                     \
+    store(dst + i, gj_wide_sqrt(gj_wide_add(gj_wide_add(gj_wide_mul(dx, dx), gj_wide_mul(dy, dy)), gj_wide_mul(dz, dz))));
+    gj__SoALoop(count, Body)
+#undef Body
+}
+
+// NOTE: (1 - t) * a + t * b like gj_lerp
+static void
+V3_lerp(V3fSoA* dst, V3fSoA* a, V3fSoA* b, f32 t)
+{
+    f32 one_minus_t = 1.0f - t;
+#define Body(T, load, store, set1)                                                          \
+    T vt  = set1(t);                                                                        \
+    T vt1 = set1(one_minus_t);                                                              \
+    store(dst->x + i, gj_wide_add(gj_wide_mul(vt1, load(a->x + i)), gj_wide_mul(vt, load(b->x + i)))); \
+    store(dst->y + i, gj_wide_add(gj_wide_mul(vt1, load(a->y + i)), gj_wide_mul(vt, load(b->y + i)))); \
+    store(dst->z + i, gj_wide_add(gj_wide_mul(vt1, load(a->z + i)), gj_wide_mul(vt, load(b->z + i))));
+    gj__SoALoop(dst->count, Body)
+#undef Body
+}
+
+// NOTE: Zero length vectors are left as they are, same as V3_normalize
+static void
+V3_normalize(V3fSoA* dst, V3fSoA* a)
+{
+    u32 i = 0;
+    WideF32 zero = gj_wide_set1(0.0f);
+    for (; i + GJ_WIDE_LANES <= dst->count; i += GJ_WIDE_LANES)
+    {
+        WideF32 x = gj_wide_load(a->x + i), y = gj_wide_load(a->y + i), z = gj_wide_load(a->z + i);
+        WideF32 l = gj_wide_sqrt(gj_wide_add(gj_wide_add(gj_wide_mul(x, x), gj_wide_mul(y, y)), gj_wide_mul(z, z)));
+        WideF32 is_zero = gj_wide_cmpeq(l, zero);
+        gj_wide_store(dst->x + i, gj_wide_select(gj_wide_div(x, l), x, is_zero));
+        gj_wide_store(dst->y + i, gj_wide_select(gj_wide_div(y, l), y, is_zero));
+        gj_wide_store(dst->z + i, gj_wide_select(gj_wide_div(z, l), z, is_zero));
+    }
+    for (; i < dst->count; i++)
+    {
+        V3fSoA_set(dst, i, V3_normalize(V3fSoA_get(a, i)));
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Matrices
 ///////////////////////////////////////////////////////////////////////////
@@ -461,11 +701,21 @@ V3f M4x4_get_z_row(M4x4 m)
 inline M4x4 M4x4_identity()
 { M4x4 m; gj__ZeroStruct(m); m.a[0] = 1.0f; m.a[5] = 1.0f; m.a[10] = 1.0f; m.a[15] = 1.0f; return m; }
 
-#if defined(__cplusplus)
-inline M4x4 M4x4_mul(M4x4 m, M4x4 n)
-#else
-inline M4x4 M4x4_mul_M4x4(M4x4 m, M4x4 n)
+// NOTE: The multiplies use SSE (two rows at a time with AVX) unless
+//       GJ_MATH_NO_SIMD is defined. Both sum the products in the same order
+//       as the _scalar versions so they give the same bits, which only holds
+//       as long as the compiler doesn't contract the scalar ones into FMAs
+//       (-ffp-contract=off when building with -mfma/-march=native).
+//       GJ_MATH_NO_SIMD only switches the single matrix functions (the
+//       M4x4_mul overloads, M4x4_inverse and M4x4_inverse_affine) to scalar
+//       code, e.g. to compare against them. It doesn't turn off SSE
+//       elsewhere: WideF32 and the V3fSoA kernels, the batched transforms
+//       and RandomXoshiro128x4 still need it, x64 always has SSE2.
+#if !defined(GJ_MATH_NO_SIMD)
+#define GJ_MATH_SIMD 1
 #endif
+
+inline M4x4 M4x4_mul_scalar(M4x4 m, M4x4 n)
 {
     M4x4 result = {};
     
@@ -492,11 +742,7 @@ inline M4x4 M4x4_mul_M4x4(M4x4 m, M4x4 n)
     return result;
 }
 
-#if defined(__cplusplus)
-inline V4f M4x4_mul(M4x4 m, V4f v)
-#else
-inline V4f M4x4_mul_V4f(M4x4 m, V4f v)
-#endif
+inline V4f M4x4_mul_scalar(M4x4 m, V4f v)
 {
     V4f result;
     result.x = m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z + m.m[0][3] * v.w;
@@ -506,11 +752,7 @@ inline V4f M4x4_mul_V4f(M4x4 m, V4f v)
     return result;
 }
 
-#if defined(__cplusplus)
-inline V3f M4x4_mul(M4x4 m, V3f v)
-#else
-inline V3f M4x4_mul_V3f(M4x4 m, V3f v)
-#endif
+inline V3f M4x4_mul_scalar(M4x4 m, V3f v)
 {
     V3f result;
     result.x = m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z + m.m[0][3];
@@ -519,6 +761,139 @@ inline V3f M4x4_mul_V3f(M4x4 m, V3f v)
     return result;
 }
 
+#if defined(GJ_MATH_SIMD)
+// NOTE: Row i of m * n is m[i][0] * n_row0 + ... + m[i][3] * n_row3.
+//       result can be m or n.
+inline void
+M4x4_mul_simd(M4x4* result, M4x4* m, M4x4* n)
+{
+#if defined(GJ_AVX)
+    __m256 n0 = _mm256_broadcast_ps((__m128*)(n->a + 0));
+    __m256 n1 = _mm256_broadcast_ps((__m128*)(n->a + 4));
+    __m256 n2 = _mm256_broadcast_ps((__m128*)(n->a + 8));
+    __m256 n3 = _mm256_broadcast_ps((__m128*)(n->a + 12));
+    // NOTE: Two rows of m at a time, the shuffles splat within each row
+    __m256 rows01 = _mm256_loadu_ps(m->a + 0);
+    __m256 rows23 = _mm256_loadu_ps(m->a + 8);
+    __m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(rows01, rows01, 0x00), n0);
+    __m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(rows23, rows23, 0x00), n0);
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(rows01, rows01, 0x55), n1));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(rows23, rows23, 0x55), n1));
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(rows01, rows01, 0xAA), n2));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(rows23, rows23, 0xAA), n2));
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(rows01, rows01, 0xFF), n3));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(rows23, rows23, 0xFF), n3));
+    _mm256_storeu_ps(result->a + 0, r01);
+    _mm256_storeu_ps(result->a + 8, r23);
+#else
+    __m128 n0 = _mm_loadu_ps(n->a + 0);
+    __m128 n1 = _mm_loadu_ps(n->a + 4);
+    __m128 n2 = _mm_loadu_ps(n->a + 8);
+    __m128 n3 = _mm_loadu_ps(n->a + 12);
+    __m128 r[4];
+    for (u32 i = 0; i < 4; i++)
+    {
+        __m128 row = _mm_loadu_ps(m->a + 4 * i);
+        r[i] = _mm_mul_ps(_mm_shuffle_ps(row, row, 0x00), n0);
+        r[i] = _mm_add_ps(r[i], _mm_mul_ps(_mm_shuffle_ps(row, row, 0x55), n1));
+        r[i] = _mm_add_ps(r[i], _mm_mul_ps(_mm_shuffle_ps(row, row, 0xAA), n2));
+        r[i] = _mm_add_ps(r[i], _mm_mul_ps(_mm_shuffle_ps(row, row, 0xFF), n3));
+    }
+    for (u32 i = 0; i < 4; i++) _mm_storeu_ps(result->a + 4 * i, r[i]);
+#endif
+}
+
+inline M4x4
+M4x4_mul_simd(M4x4 m, M4x4 n)
+{
+    M4x4 result;
+    M4x4_mul_simd(&result, &m, &n);
+    return result;
+}
+
+// NOTE: m * v is the columns of m scaled by v, so transpose first
+inline __m128
+M4x4__mul_columns(M4x4* m, __m128 x, __m128 y, __m128 z, __m128 w)
+{
+    __m128 c0 = _mm_loadu_ps(m->a + 0);
+    __m128 c1 = _mm_loadu_ps(m->a + 4);
+    __m128 c2 = _mm_loadu_ps(m->a + 8);
+    __m128 c3 = _mm_loadu_ps(m->a + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    __m128 r = _mm_mul_ps(c0, x);
+    r = _mm_add_ps(r, _mm_mul_ps(c1, y));
+    r = _mm_add_ps(r, _mm_mul_ps(c2, z));
+    return _mm_add_ps(r, _mm_mul_ps(c3, w));
+}
+
+inline V4f
+M4x4_mul_simd(M4x4 m, V4f v)
+{
+    V4f result;
+    _mm_storeu_ps(result.array, M4x4__mul_columns(&m, _mm_set1_ps(v.x), _mm_set1_ps(v.y), _mm_set1_ps(v.z), _mm_set1_ps(v.w)));
+    return result;
+}
+
+inline V3f
+M4x4_mul_simd(M4x4 m, V3f v)
+{
+    // NOTE: w = 1 and the scalar version adds m[i][3] without multiplying, x * 1 is exact
+    f32 r[4];
+    _mm_storeu_ps(r, M4x4__mul_columns(&m, _mm_set1_ps(v.x), _mm_set1_ps(v.y), _mm_set1_ps(v.z), _mm_set1_ps(1.0f)));
+    return {r[0], r[1], r[2]};
+}
+#endif
+
+// NOTE: Pointer version for concatenating in place, result can be m or n
+inline void
+M4x4_mul(M4x4* result, M4x4* m, M4x4* n)
+{
+#if defined(GJ_MATH_SIMD)
+    M4x4_mul_simd(result, m, n);
+#else
+    *result = M4x4_mul_scalar(*m, *n);
+#endif
+}
+
+#if defined(__cplusplus)
+inline M4x4 M4x4_mul(M4x4 m, M4x4 n)
+#else
+inline M4x4 M4x4_mul_M4x4(M4x4 m, M4x4 n)
+#endif
+{
+#if defined(GJ_MATH_SIMD)
+    return M4x4_mul_simd(m, n);
+#else
+    return M4x4_mul_scalar(m, n);
+#endif
+}
+
+#if defined(__cplusplus)
+inline V4f M4x4_mul(M4x4 m, V4f v)
+#else
+inline V4f M4x4_mul_V4f(M4x4 m, V4f v)
+#endif
+{
+#if defined(GJ_MATH_SIMD)
+    return M4x4_mul_simd(m, v);
+#else
+    return M4x4_mul_scalar(m, v);
+#endif
+}
+
+#if defined(__cplusplus)
+inline V3f M4x4_mul(M4x4 m, V3f v)
+#else
+inline V3f M4x4_mul_V3f(M4x4 m, V3f v)
+#endif
+{
+#if defined(GJ_MATH_SIMD)
+    return M4x4_mul_simd(m, v);
+#else
+    return M4x4_mul_scalar(m, v);
+#endif
+}
+
 static inline M4x4
 M4x4_translation_matrix(V3f translation)
 {
@@ -781,6 +1156,200 @@ M4x4 M4x4_inverse_orthographic_matrix(f32 width, f32 height, f32 near_plane, f32
     return result;
 }
 
+// NOTE: General inverse. Returns the determinant, the result is garbage
+//       (inf/nan) when it is 0 so check it if m can be singular.
+//       result can be m. Uses the SSE 2x2 block method unless GJ_MATH_NO_SIMD,
+//       the two agree to rounding but not bit for bit.
+static f32
+M4x4_inverse_scalar(M4x4* result, M4x4* m)
+{
+    f32 a00 = m->_00, a01 = m->_01, a02 = m->_02, a03 = m->_03;
+    f32 a10 = m->_10, a11 = m->_11, a12 = m->_12, a13 = m->_13;
+    f32 a20 = m->_20, a21 = m->_21, a22 = m->_22, a23 = m->_23;
+    f32 a30 = m->_30, a31 = m->_31, a32 = m->_32, a33 = m->_33;
+
+    // NOTE: 2x2 determinants of the top and bottom two rows
+    f32 s0 = a00 * a11 - a10 * a01, s1 = a00 * a12 - a10 * a02, s2 = a00 * a13 - a10 * a03;
+    f32 s3 = a01 * a12 - a11 * a02, s4 = a01 * a13 - a11 * a03, s5 = a02 * a13 - a12 * a03;
+    f32 c5 = a22 * a33 - a32 * a23, c4 = a21 * a33 - a31 * a23, c3 = a21 * a32 - a31 * a22;
+    f32 c2 = a20 * a33 - a30 * a23, c1 = a20 * a32 - a30 * a22, c0 = a20 * a31 - a30 * a21;
+
+    f32 det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    f32 inv_det = 1.0f / det;
+
+    result->_00 = ( a11 * c5 - a12 * c4 + a13 * c3) * inv_det;
+    result->_01 = (-a01 * c5 + a02 * c4 - a03 * c3) * inv_det;
+    result->_02 = ( a31 * s5 - a32 * s4 + a33 * s3) * inv_det;
+    result->_03 = (-a21 * s5 + a22 * s4 - a23 * s3) * inv_det;
+    result->_10 = (-a10 * c5 + a12 * c2 - a13 * c1) * inv_det;
+    result->_11 = ( a00 * c5 - a02 * c2 + a03 * c1) * inv_det;
+    result->_12 = (-a30 * s5 + a32 * s2 - a33 * s1) * inv_det;
+    result->_13 = ( a20 * s5 - a22 * s2 + a23 * s1) * inv_det;
+    result->_20 = ( a10 * c4 - a11 * c2 + a13 * c0) * inv_det;
+    result->_21 = (-a00 * c4 + a01 * c2 - a03 * c0) * inv_det;
+    result->_22 = ( a30 * s4 - a31 * s2 + a33 * s0) * inv_det;
+    result->_23 = (-a20 * s4 + a21 * s2 - a23 * s0) * inv_det;
+    result->_30 = (-a10 * c3 + a11 * c1 - a12 * c0) * inv_det;
+    result->_31 = ( a00 * c3 - a01 * c1 + a02 * c0) * inv_det;
+    result->_32 = (-a30 * s3 + a31 * s1 - a32 * s0) * inv_det;
+    result->_33 = ( a20 * s3 - a21 * s1 + a22 * s0) * inv_det;
+    return det;
+}
+
+#if defined(GJ_MATH_SIMD)
+#define gj__Shuffle(x, y, z, w)    ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define gj__Swizzle(v, x, y, z, w) _mm_shuffle_ps(v, v, gj__Shuffle(x, y, z, w))
+
+// NOTE: 2x2 row major blocks in one register: a * b, adj(a) * b and a * adj(b)
+inline __m128 M4x4__mat2_mul    (__m128 a, __m128 b) { return _mm_add_ps(_mm_mul_ps(a, gj__Swizzle(b, 0, 3, 0, 3)), _mm_mul_ps(gj__Swizzle(a, 1, 0, 3, 2), gj__Swizzle(b, 2, 1, 2, 1))); }
+inline __m128 M4x4__mat2_adj_mul(__m128 a, __m128 b) { return _mm_sub_ps(_mm_mul_ps(gj__Swizzle(a, 3, 3, 0, 0), b), _mm_mul_ps(gj__Swizzle(a, 1, 1, 2, 2), gj__Swizzle(b, 2, 3, 0, 1))); }
+inline __m128 M4x4__mat2_mul_adj(__m128 a, __m128 b) { return _mm_sub_ps(_mm_mul_ps(a, gj__Swizzle(b, 3, 0, 3, 0)), _mm_mul_ps(gj__Swizzle(a, 1, 0, 3, 2), gj__Swizzle(b, 2, 1, 2, 1))); }
+
+// NOTE: With m = |A B| the inverse is 1/|m| * |X Y| where
+//                |C D|                        |Z W|
+//       X# = |D|A - B(D#C), Y# = |B|C - D(A#B)#, Z# = |C|B - A(D#C)#, W# = |A|D - C(A#B)
+//       and |m| = |A||D| + |B||C| - tr((A#B)(D#C)), # being the adjugate.
+static f32
+M4x4_inverse_simd(M4x4* result, M4x4* m)
+{
+    __m128 row0 = _mm_loadu_ps(m->a + 0);
+    __m128 row1 = _mm_loadu_ps(m->a + 4);
+    __m128 row2 = _mm_loadu_ps(m->a + 8);
+    __m128 row3 = _mm_loadu_ps(m->a + 12);
+
+    __m128 A = _mm_movelh_ps(row0, row1);
+    __m128 B = _mm_movehl_ps(row1, row0);
+    __m128 C = _mm_movelh_ps(row2, row3);
+    __m128 D = _mm_movehl_ps(row3, row2);
+
+    // NOTE: (|A| |B| |C| |D|)
+    __m128 det_sub = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(row0, row2, gj__Shuffle(0, 2, 0, 2)), _mm_shuffle_ps(row1, row3, gj__Shuffle(1, 3, 1, 3))),
+                                _mm_mul_ps(_mm_shuffle_ps(row0, row2, gj__Shuffle(1, 3, 1, 3)), _mm_shuffle_ps(row1, row3, gj__Shuffle(0, 2, 0, 2))));
+    __m128 det_A = gj__Swizzle(det_sub, 0, 0, 0, 0);
+    __m128 det_B = gj__Swizzle(det_sub, 1, 1, 1, 1);
+    __m128 det_C = gj__Swizzle(det_sub, 2, 2, 2, 2);
+    __m128 det_D = gj__Swizzle(det_sub, 3, 3, 3, 3);
+
+    __m128 D_C = M4x4__mat2_adj_mul(D, C);
+    __m128 A_B = M4x4__mat2_adj_mul(A, B);
+    __m128 X_  = _mm_sub_ps(_mm_mul_ps(det_D, A), M4x4__mat2_mul(B, D_C));
+    __m128 W_  = _mm_sub_ps(_mm_mul_ps(det_A, D), M4x4__mat2_mul(C, A_B));
+    __m128 Y_  = _mm_sub_ps(_mm_mul_ps(det_B, C), M4x4__mat2_mul_adj(D, A_B));
+    __m128 Z_  = _mm_sub_ps(_mm_mul_ps(det_C, B), M4x4__mat2_mul_adj(A, D_C));
+
+    __m128 det_M = _mm_add_ps(_mm_mul_ps(det_A, det_D), _mm_mul_ps(det_B, det_C));
+    __m128 tr = _mm_mul_ps(A_B, gj__Swizzle(D_C, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, gj__Swizzle(tr, 2, 3, 0, 1));
+    tr = _mm_add_ps(tr, gj__Swizzle(tr, 1, 0, 3, 2));
+    det_M = _mm_sub_ps(det_M, tr);
+
+    // NOTE: (1/|m|, -1/|m|, -1/|m|, 1/|m|) applies the adjugate signs too
+    __m128 r_det_M = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_M);
+    X_ = _mm_mul_ps(X_, r_det_M);
+    Y_ = _mm_mul_ps(Y_, r_det_M);
+    Z_ = _mm_mul_ps(Z_, r_det_M);
+    W_ = _mm_mul_ps(W_, r_det_M);
+
+    // NOTE: The adjugate swap folded into the shuffles back to rows
+    _mm_storeu_ps(result->a + 0,  _mm_shuffle_ps(X_, Y_, gj__Shuffle(3, 1, 3, 1)));
+    _mm_storeu_ps(result->a + 4,  _mm_shuffle_ps(X_, Y_, gj__Shuffle(2, 0, 2, 0)));
+    _mm_storeu_ps(result->a + 8,  _mm_shuffle_ps(Z_, W_, gj__Shuffle(3, 1, 3, 1)));
+    _mm_storeu_ps(result->a + 12, _mm_shuffle_ps(Z_, W_, gj__Shuffle(2, 0, 2, 0)));
+    return _mm_cvtss_f32(det_M);
+}
+#endif
+
+inline f32
+M4x4_inverse(M4x4* result, M4x4* m)
+{
+#if defined(GJ_MATH_SIMD)
+    return M4x4_inverse_simd(result, m);
+#else
+    return M4x4_inverse_scalar(result, m);
+#endif
+}
+
+inline M4x4 M4x4_inverse(M4x4 m) { M4x4 result; M4x4_inverse(&result, &m); return result; }
+
+// NOTE: Only for m with a last row of (0, 0, 0, 1): any rotation, scale and
+//       shear plus translation. The 3x3 part is inverted with cross products
+//       (the columns of the inverse are r1 x r2, r2 x r0, r0 x r1 over the
+//       determinant) and the translation is -inverse * t. Returns the
+//       determinant of the 3x3 part.
+static f32
+M4x4_inverse_affine(M4x4* result, M4x4* m)
+{
+    gj_AssertDebug(m->_30 == 0.0f && m->_31 == 0.0f && m->_32 == 0.0f && m->_33 == 1.0f);
+#if defined(GJ_MATH_SIMD)
+    __m128 xyz_mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    __m128 row0 = _mm_loadu_ps(m->a + 0);
+    __m128 row1 = _mm_loadu_ps(m->a + 4);
+    __m128 row2 = _mm_loadu_ps(m->a + 8);
+    __m128 tx = gj__Swizzle(row0, 3, 3, 3, 3);
+    __m128 ty = gj__Swizzle(row1, 3, 3, 3, 3);
+    __m128 tz = gj__Swizzle(row2, 3, 3, 3, 3);
+    row0 = _mm_and_ps(row0, xyz_mask);
+    row1 = _mm_and_ps(row1, xyz_mask);
+    row2 = _mm_and_ps(row2, xyz_mask);
+
+#define gj__Cross(a, b) _mm_sub_ps(_mm_mul_ps(gj__Swizzle(a, 1, 2, 0, 3), gj__Swizzle(b, 2, 0, 1, 3)), \
+                                   _mm_mul_ps(gj__Swizzle(a, 2, 0, 1, 3), gj__Swizzle(b, 1, 2, 0, 3)))
+    __m128 c0 = gj__Cross(row1, row2);
+    __m128 c1 = gj__Cross(row2, row0);
+    __m128 c2 = gj__Cross(row0, row1);
+#undef gj__Cross
+
+    __m128 det = _mm_mul_ps(row0, c0);
+    det = _mm_add_ps(det, gj__Swizzle(det, 1, 0, 3, 2));
+    det = _mm_add_ps(det, gj__Swizzle(det, 2, 2, 0, 0));
+    __m128 r_det = _mm_div_ps(_mm_set1_ps(1.0f), det);
+    c0 = _mm_mul_ps(c0, r_det);
+    c1 = _mm_mul_ps(c1, r_det);
+    c2 = _mm_mul_ps(c2, r_det);
+
+    __m128 t = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, tx), _mm_mul_ps(c1, ty)), _mm_mul_ps(c2, tz)));
+    _MM_TRANSPOSE4_PS(c0, c1, c2, t);
+    _mm_storeu_ps(result->a + 0,  c0);
+    _mm_storeu_ps(result->a + 4,  c1);
+    _mm_storeu_ps(result->a + 8,  c2);
+    _mm_storeu_ps(result->a + 12, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+    return _mm_cvtss_f32(det);
+#else
+    V3f r0 = M4x4_get_x_row(*m), r1 = M4x4_get_y_row(*m), r2 = M4x4_get_z_row(*m);
+    V3f t  = M4x4_get_translation(*m);
+    V3f c0 = V3_cross(r1, r2), c1 = V3_cross(r2, r0), c2 = V3_cross(r0, r1);
+    f32 det   = V3_dot(r0, c0);
+    f32 r_det = 1.0f / det;
+    c0 = V3_mul(c0, r_det);
+    c1 = V3_mul(c1, r_det);
+    c2 = V3_mul(c2, r_det);
+    V3f inv_t = V3_add(V3_add(V3_mul(c0, t.x), V3_mul(c1, t.y)), V3_mul(c2, t.z));
+    M4x4 inverse = {
+        c0.x, c1.x, c2.x, -inv_t.x,
+        c0.y, c1.y, c2.y, -inv_t.y,
+        c0.z, c1.z, c2.z, -inv_t.z,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+    *result = inverse;
+    return det;
+#endif
+}
+
+inline M4x4 M4x4_inverse_affine(M4x4 m) { M4x4 result; M4x4_inverse_affine(&result, &m); return result; }
+
+// NOTE: Batch versions, dst can be src
+static void
+M4x4_inverse(M4x4* dst, M4x4* src, u32 count)
+{
+    for (u32 i = 0; i < count; i++) M4x4_inverse(dst + i, src + i);
+}
+
+static void
+M4x4_inverse_affine(M4x4* dst, M4x4* src, u32 count)
+{
+    for (u32 i = 0; i < count; i++) M4x4_inverse_affine(dst + i, src + i);
+}
+
 M4x4 M4x4_from_axis_angle(V3f axis, f32 angle)
 {
     M4x4 result;
@@ -816,6 +1385,180 @@ M4x4 M4x4_from_axis_angle(V3f axis, f32 angle)
     return result;
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Batched Transforms
+///////////////////////////////////////////////////////////////////////////
+// NOTE: m * (p, 1) for points and m * (d, 0) for directions over a whole
+//       buffer. Strided buffers hold a V3f every stride bytes (interleaved
+//       vertex data like gj_obj_loader_load writes), 4 of them are loaded
+//       and transposed to x/y/z registers, transformed and transposed back.
+//       Results have the same bits as M4x4_mul(m, v) per vertex.
+//       dst == src (same stride) transforms in place, other overlaps don't work.
+//       Normals need the inverse transpose of m passed in as the matrix.
+//       With a platform_api and thread_count > 1 large inputs are split into
+//       ranges with gj_parallel_for.
+
+typedef struct GJTransformJob
+{
+    M4x4*   m;
+    b32     directions;
+    // NOTE: Strided
+    byte*   dst;
+    u64     dst_stride;
+    byte*   src;
+    u64     src_stride;
+    // NOTE: SoA, used when dst_soa is set
+    V3fSoA* dst_soa;
+    V3fSoA* src_soa;
+    u32     first;
+    u32     count;
+} GJTransformJob;
+
+// NOTE: 12 byte loads/stores so the last vertex never touches memory past it
+inline __m128 M4x4__load_V3f(byte* p)          { return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*)p), _mm_load_ss((f32*)(p + 8))); }
+inline void   M4x4__store_V3f(byte* p, __m128 v) { _mm_storel_pi((__m64*)p, v); _mm_store_ss((f32*)(p + 8), _mm_movehl_ps(v, v)); }
+
+static void
+M4x4__transform_strided_range(GJTransformJob* job)
+{
+    M4x4* m = job->m;
+    f32 w = job->directions ? 0.0f : 1.0f;
+    __m128 m00 = _mm_set1_ps(m->_00), m01 = _mm_set1_ps(m->_01), m02 = _mm_set1_ps(m->_02), m03 = _mm_set1_ps(m->_03 * w);
+    __m128 m10 = _mm_set1_ps(m->_10), m11 = _mm_set1_ps(m->_11), m12 = _mm_set1_ps(m->_12), m13 = _mm_set1_ps(m->_13 * w);
+    __m128 m20 = _mm_set1_ps(m->_20), m21 = _mm_set1_ps(m->_21), m22 = _mm_set1_ps(m->_22), m23 = _mm_set1_ps(m->_23 * w);
+
+    byte* src = job->src + job->first * job->src_stride;
+    byte* dst = job->dst + job->first * job->dst_stride;
+    u64 src_stride = job->src_stride;
+    u64 dst_stride = job->dst_stride;
+    u32 i = 0;
+    for (; i + 4 <= job->count; i += 4)
+    {
+        __m128 x = M4x4__load_V3f(src);
+        __m128 y = M4x4__load_V3f(src + src_stride);
+        __m128 z = M4x4__load_V3f(src + 2 * src_stride);
+        __m128 t = M4x4__load_V3f(src + 3 * src_stride);
+        _MM_TRANSPOSE4_PS(x, y, z, t);
+
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)), _mm_mul_ps(m02, z)), m03);
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m12, z)), m13);
+        __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, x), _mm_mul_ps(m21, y)), _mm_mul_ps(m22, z)), m23);
+        __m128 rw = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+
+        M4x4__store_V3f(dst,                  rx);
+        M4x4__store_V3f(dst + dst_stride,     ry);
+        M4x4__store_V3f(dst + 2 * dst_stride, rz);
+        M4x4__store_V3f(dst + 3 * dst_stride, rw);
+        src += 4 * src_stride;
+        dst += 4 * dst_stride;
+    }
+    for (; i < job->count; i++, src += src_stride, dst += dst_stride)
+    {
+        V3f v = *(V3f*)src;
+        V3f r;
+        r.x = m->_00 * v.x + m->_01 * v.y + m->_02 * v.z + m->_03 * w;
+        r.y = m->_10 * v.x + m->_11 * v.y + m->_12 * v.z + m->_13 * w;
+        r.z = m->_20 * v.x + m->_21 * v.y + m->_22 * v.z + m->_23 * w;
+        *(V3f*)dst = r;
+    }
+}
+
+static void
+M4x4__transform_soa_range(GJTransformJob* job)
+{
+    M4x4* m = job->m;
+    f32 w = job->directions ? 0.0f : 1.0f;
+    f32 t0 = m->_03 * w, t1 = m->_13 * w, t2 = m->_23 * w;
+    f32* sx = job->src_soa->x + job->first; f32* sy = job->src_soa->y + job->first; f32* sz = job->src_soa->z + job->first;
+    f32* dx = job->dst_soa->x + job->first; f32* dy = job->dst_soa->y + job->first; f32* dz = job->dst_soa->z + job->first;
+#define Body(T, load, store, set1)                                                                          \
+    T x = load(sx + i), y = load(sy + i), z = load(sz + i);                                                 \
+    T rx = gj_wide_add(gj_wide_add(gj_wide_add(gj_wide_mul(set1(m->_00), x), gj_wide_mul(set1(m->_01), y)),  \
+                                   gj_wide_mul(set1(m->_02), z)), set1(t0));                                \
+    T ry = gj_wide_add(gj_wide_add(gj_wide_add(gj_wide_mul(set1(m->_10), x), gj_wide_mul(set1(m->_11), y)),  \
+                                   gj_wide_mul(set1(m->_12), z)), set1(t1));                                \
+    T rz = gj_wide_add(gj_wide_add(gj_wide_add(gj_wide_mul(set1(m->_20), x), gj_wide_mul(set1(m->_21), y)),  \
+                                   gj_wide_mul(set1(m->_22), z)), set1(t2));                                \
+    store(dx + i, rx); store(dy + i, ry); store(dz + i, rz);
+    gj__SoALoop(job->count, Body)
+#undef Body
+}
+
+static void
+M4x4__transform_range(void* data, u32, u64 first, u64 count)
+{
+    GJTransformJob job = *(GJTransformJob*)data;
+    job.first += (u32)first;
+    job.count  = (u32)count;
+    if (job.dst_soa) M4x4__transform_soa_range(&job);
+    else             M4x4__transform_strided_range(&job);
+}
+
+static void
+M4x4__transform(GJTransformJob* job, PlatformAPI* platform_api, u32 thread_count)
+{
+    thread_count = gj_parallel_thread_count(platform_api, thread_count, job->count, GJ_PARALLEL_MIN_RANGE);
+    // NOTE: Ranges are multiples of 4 so only the last one has a scalar tail
+    gj_parallel_for(platform_api, thread_count, job->count, M4x4__transform_range, job, 4);
+}
+
+static void
+M4x4__transform_strided(M4x4* m, b32 directions, V3f* dst, u64 dst_stride, V3f* src, u64 src_stride, u32 count,
+                        PlatformAPI* platform_api, u32 thread_count)
+{
+    GJTransformJob job = {};
+    job.m          = m;
+    job.directions = directions;
+    job.dst        = (byte*)dst;
+    job.dst_stride = dst_stride;
+    job.src        = (byte*)src;
+    job.src_stride = src_stride;
+    job.count      = count;
+    M4x4__transform(&job, platform_api, thread_count);
+}
+
+static void
+M4x4__transform_soa(M4x4* m, b32 directions, V3fSoA* dst, V3fSoA* src, PlatformAPI* platform_api, u32 thread_count)
+{
+    gj_AssertDebug(src->count >= dst->count);
+    GJTransformJob job = {};
+    job.m          = m;
+    job.directions = directions;
+    job.dst_soa    = dst;
+    job.src_soa    = src;
+    job.count      = dst->count;
+    M4x4__transform(&job, platform_api, thread_count);
+}
+
+inline void
+M4x4_transform_points(M4x4* m, V3f* dst, u64 dst_stride, V3f* src, u64 src_stride, u32 count,
+                      PlatformAPI* platform_api = NULL, u32 thread_count = 1)
+{ M4x4__transform_strided(m, gj_False, dst, dst_stride, src, src_stride, count, platform_api, thread_count); }
+
+inline void
+M4x4_transform_directions(M4x4* m, V3f* dst, u64 dst_stride, V3f* src, u64 src_stride, u32 count,
+                          PlatformAPI* platform_api = NULL, u32 thread_count = 1)
+{ M4x4__transform_strided(m, gj_True, dst, dst_stride, src, src_stride, count, platform_api, thread_count); }
+
+// NOTE: In place
+inline void
+M4x4_transform_points(M4x4* m, V3f* points, u64 stride, u32 count, PlatformAPI* platform_api = NULL, u32 thread_count = 1)
+{ M4x4__transform_strided(m, gj_False, points, stride, points, stride, count, platform_api, thread_count); }
+
+inline void
+M4x4_transform_directions(M4x4* m, V3f* directions, u64 stride, u32 count, PlatformAPI* platform_api = NULL, u32 thread_count = 1)
+{ M4x4__transform_strided(m, gj_True, directions, stride, directions, stride, count, platform_api, thread_count); }
+
+// NOTE: dst->count elements, dst can be src
+inline void
+M4x4_transform_points(M4x4* m, V3fSoA* dst, V3fSoA* src, PlatformAPI* platform_api = NULL, u32 thread_count = 1)
+{ M4x4__transform_soa(m, gj_False, dst, src, platform_api, thread_count); }
+
+inline void
+M4x4_transform_directions(M4x4* m, V3fSoA* dst, V3fSoA* src, PlatformAPI* platform_api = NULL, u32 thread_count = 1)
+{ M4x4__transform_soa(m, gj_True, dst, src, platform_api, thread_count); }
+
 ///////////////////////////////////////////////////////////////////////////
 // Quaternion
 ///////////////////////////////////////////////////////////////////////////
@@ -1153,6 +1896,579 @@ b32 ray_box_intersection(V3f ray_origin, V3f ray_direction,
     return ray_box_intersection(ray_origin, ray_direction, box_min, box_max, NULL);
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Wide Ray Box
+///////////////////////////////////////////////////////////////////////////
+// NOTE: Slab test of one ray against SoA box bounds, GJ_WIDE_LANES boxes at
+//       a time with the inverse direction computed once per ray.
+//       Axis parallel rays get +-inf inverse directions. When such a ray
+//       starts exactly on a slab plane (box - origin) * inverse_direction is
+//       0 * inf = NaN, that axis is then skipped so boxes are closed on
+//       every side. Unlike ray_box_intersection a box containing the origin
+//       is a hit with t_enter = 0.
+typedef struct RaySlab
+{
+    V3f origin;
+    V3f inverse_direction;
+} RaySlab;
+
+inline RaySlab
+RaySlab_create(V3f ray_origin, V3f ray_direction)
+{
+    RaySlab result;
+    result.origin            = ray_origin;
+    result.inverse_direction = {1.0f / ray_direction.x, 1.0f / ray_direction.y, 1.0f / ray_direction.z};
+    return result;
+}
+
+inline void
+RaySlab__axis(WideF32 box_min, WideF32 box_max, WideF32 origin, WideF32 inverse_direction, WideF32* t_enter, WideF32* t_exit)
+{
+    WideF32 t0  = gj_wide_mul(gj_wide_sub(box_min, origin), inverse_direction);
+    WideF32 t1  = gj_wide_mul(gj_wide_sub(box_max, origin), inverse_direction);
+    WideF32 nan = gj_wide_cmpunord(t0, t1);
+    *t_enter = gj_wide_select(gj_wide_max(*t_enter, gj_wide_min(t0, t1)), *t_enter, nan);
+    *t_exit  = gj_wide_select(gj_wide_min(*t_exit,  gj_wide_max(t0, t1)), *t_exit,  nan);
+}
+
+inline void
+RaySlab__axis(f32 box_min, f32 box_max, f32 origin, f32 inverse_direction, f32* t_enter, f32* t_exit)
+{
+    f32 t0 = (box_min - origin) * inverse_direction;
+    f32 t1 = (box_max - origin) * inverse_direction;
+    if (t0 != t0 || t1 != t1) return;
+    *t_enter = gj_Max(*t_enter, gj_Min(t0, t1));
+    *t_exit  = gj_Min(*t_exit,  gj_Max(t0, t1));
+}
+
+// NOTE: Boxes [first, first + GJ_WIDE_LANES) over [0, t_max], returns the
+//       hit mask (bit i for box first + i) and the entry distances
+inline u32
+ray_boxes_intersection_wide(RaySlab* ray, V3fSoA* box_min, V3fSoA* box_max, u32 first, WideF32* t_enter, f32 t_max = FLT_MAX)
+{
+    gj_AssertDebug(first + GJ_WIDE_LANES <= box_min->count && box_min->count == box_max->count);
+    WideF32 enter = gj_wide_set1(0.0f);
+    WideF32 exit  = gj_wide_set1(t_max);
+    RaySlab__axis(gj_wide_load(box_min->x + first), gj_wide_load(box_max->x + first),
+                  gj_wide_set1(ray->origin.x), gj_wide_set1(ray->inverse_direction.x), &enter, &exit);
+    RaySlab__axis(gj_wide_load(box_min->y + first), gj_wide_load(box_max->y + first),
+                  gj_wide_set1(ray->origin.y), gj_wide_set1(ray->inverse_direction.y), &enter, &exit);
+    RaySlab__axis(gj_wide_load(box_min->z + first), gj_wide_load(box_max->z + first),
+                  gj_wide_set1(ray->origin.z), gj_wide_set1(ray->inverse_direction.z), &enter, &exit);
+    *t_enter = enter;
+    return gj_wide_movemask(gj_wide_cmple(enter, exit));
+}
+
+// NOTE: All box_min->count boxes over [0, t_max]. Sets bit i of hits for
+//       every box hit and returns how many, only the words covering the
+//       boxes are written. t_enter (optional) gets the entry distance for
+//       hits and FLT_MAX for misses.
+static u32
+ray_boxes_intersection(RaySlab* ray, V3fSoA* box_min, V3fSoA* box_max, GJBitset* hits, f32* t_enter = NULL, f32 t_max = FLT_MAX)
+{
+    gj_AssertDebug(box_min->count == box_max->count && hits->bit_count >= box_min->count);
+    WideF32 ox = gj_wide_set1(ray->origin.x),            oy = gj_wide_set1(ray->origin.y),            oz = gj_wide_set1(ray->origin.z);
+    WideF32 ix = gj_wide_set1(ray->inverse_direction.x), iy = gj_wide_set1(ray->inverse_direction.y), iz = gj_wide_set1(ray->inverse_direction.z);
+    WideF32 zero = gj_wide_set1(0.0f);
+    WideF32 far  = gj_wide_set1(t_max);
+    WideF32 miss = gj_wide_set1(FLT_MAX);
+    u32 count = box_min->count;
+    u32 hit_count = 0;
+    u64 word = 0;
+    u32 i = 0;
+    for (; i + GJ_WIDE_LANES <= count; i += GJ_WIDE_LANES)
+    {
+        WideF32 enter = zero;
+        WideF32 exit  = far;
+        RaySlab__axis(gj_wide_load(box_min->x + i), gj_wide_load(box_max->x + i), ox, ix, &enter, &exit);
+        RaySlab__axis(gj_wide_load(box_min->y + i), gj_wide_load(box_max->y + i), oy, iy, &enter, &exit);
+        RaySlab__axis(gj_wide_load(box_min->z + i), gj_wide_load(box_max->z + i), oz, iz, &enter, &exit);
+        WideF32 hit = gj_wide_cmple(enter, exit);
+        if (t_enter) gj_wide_store(t_enter + i, gj_wide_select(miss, enter, hit));
+
+        // NOTE: The lane count divides 64 so groups never straddle words
+        u32 mask = gj_wide_movemask(hit);
+        hit_count += gj_popcount_u64(mask);
+        word |= (u64)mask << (i % 64);
+        if ((i + GJ_WIDE_LANES) % 64 == 0)
+        {
+            hits->words[i / 64] = word;
+            word = 0;
+        }
+    }
+    for (; i < count; i++)
+    {
+        f32 enter = 0.0f;
+        f32 exit  = t_max;
+        RaySlab__axis(box_min->x[i], box_max->x[i], ray->origin.x, ray->inverse_direction.x, &enter, &exit);
+        RaySlab__axis(box_min->y[i], box_max->y[i], ray->origin.y, ray->inverse_direction.y, &enter, &exit);
+        RaySlab__axis(box_min->z[i], box_max->z[i], ray->origin.z, ray->inverse_direction.z, &enter, &exit);
+        b32 hit = enter <= exit;
+        if (t_enter) t_enter[i] = hit ? enter : FLT_MAX;
+        hit_count += hit;
+        word |= (u64)hit << (i % 64);
+    }
+    if (count % 64) hits->words[count / 64] = word;
+    return hit_count;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Wide Ray Triangle
+///////////////////////////////////////////////////////////////////////////
+// NOTE: ray_triangle_intersection (Moller-Trumbore) for GJ_WIDE_LANES
+//       triangles or rays at once. Triangles are stored as v0 and the two
+//       edges in SoA, padded with degenerate triangles (zero edges, never
+//       hit) up to a multiple of the lane count so there is no tail.
+//       Same epsilon and the same accept rules as the scalar version.
+#define GJ_RAY_NO_HIT 0xFFFFFFFF
+
+typedef struct TriangleSoA
+{
+    V3fSoA v0;
+    V3fSoA edge1;
+    V3fSoA edge2;
+    u32    count;
+} TriangleSoA;
+
+typedef struct RayHit
+{
+    f32 t;
+    // NOTE: Barycentrics, the hit is v0 + u * edge1 + v * edge2
+    f32 u;
+    f32 v;
+    u32 triangle;
+} RayHit;
+
+static TriangleSoA
+TriangleSoA_create(MemoryArena* arena, u32 count)
+{
+    TriangleSoA result;
+    u32 padded_count = (count + GJ_WIDE_LANES - 1) & ~(u32)(GJ_WIDE_LANES - 1);
+    result.count = count;
+    result.v0    = V3fSoA_create(arena, padded_count);
+    result.edge1 = V3fSoA_create(arena, padded_count);
+    result.edge2 = V3fSoA_create(arena, padded_count);
+    return result;
+}
+
+inline void
+TriangleSoA_set(TriangleSoA* triangles, u32 i, V3f v0, V3f v1, V3f v2)
+{
+    gj_AssertDebug(i < triangles->count);
+    V3fSoA_set(&triangles->v0,    i, v0);
+    V3fSoA_set(&triangles->edge1, i, V3_sub(v1, v0));
+    V3fSoA_set(&triangles->edge2, i, V3_sub(v2, v0));
+}
+
+// NOTE: Shared by both variants, either side can be the broadcast one.
+//       Returns the mask of lanes that hit closer than best_t.
+inline WideF32
+gj__ray_triangle_wide(WideF32 ox, WideF32 oy, WideF32 oz, WideF32 dx, WideF32 dy, WideF32 dz,
+                      WideF32 v0x, WideF32 v0y, WideF32 v0z,
+                      WideF32 e1x, WideF32 e1y, WideF32 e1z, WideF32 e2x, WideF32 e2y, WideF32 e2z,
+                      WideF32 best_t, WideF32* out_t, WideF32* out_u, WideF32* out_v)
+{
+    WideF32 zero    = gj_wide_set1(0.0f);
+    WideF32 one     = gj_wide_set1(1.0f);
+    WideF32 epsilon = gj_wide_set1(0.000001f);
+
+    // NOTE: pvec = d x e2, det = e1 . pvec
+    WideF32 px = gj_wide_sub(gj_wide_mul(dy, e2z), gj_wide_mul(dz, e2y));
+    WideF32 py = gj_wide_sub(gj_wide_mul(dz, e2x), gj_wide_mul(dx, e2z));
+    WideF32 pz = gj_wide_sub(gj_wide_mul(dx, e2y), gj_wide_mul(dy, e2x));
+    WideF32 det = gj_wide_add(gj_wide_add(gj_wide_mul(e1x, px), gj_wide_mul(e1y, py)), gj_wide_mul(e1z, pz));
+    WideF32 hit = gj_wide_cmple(epsilon, gj_wide_abs(det));
+    WideF32 inv_det = gj_wide_div(one, det);
+
+    WideF32 tx = gj_wide_sub(ox, v0x);
+    WideF32 ty = gj_wide_sub(oy, v0y);
+    WideF32 tz = gj_wide_sub(oz, v0z);
+    WideF32 u = gj_wide_mul(gj_wide_add(gj_wide_add(gj_wide_mul(tx, px), gj_wide_mul(ty, py)), gj_wide_mul(tz, pz)), inv_det);
+    hit = gj_wide_and(hit, gj_wide_and(gj_wide_cmple(zero, u), gj_wide_cmple(u, one)));
+
+    // NOTE: qvec = tvec x e1
+    WideF32 qx = gj_wide_sub(gj_wide_mul(ty, e1z), gj_wide_mul(tz, e1y));
+    WideF32 qy = gj_wide_sub(gj_wide_mul(tz, e1x), gj_wide_mul(tx, e1z));
+    WideF32 qz = gj_wide_sub(gj_wide_mul(tx, e1y), gj_wide_mul(ty, e1x));
+    WideF32 v = gj_wide_mul(gj_wide_add(gj_wide_add(gj_wide_mul(dx, qx), gj_wide_mul(dy, qy)), gj_wide_mul(dz, qz)), inv_det);
+    hit = gj_wide_and(hit, gj_wide_and(gj_wide_cmple(zero, v), gj_wide_cmple(gj_wide_add(u, v), one)));
+
+    WideF32 t = gj_wide_mul(gj_wide_add(gj_wide_add(gj_wide_mul(e2x, qx), gj_wide_mul(e2y, qy)), gj_wide_mul(e2z, qz)), inv_det);
+    hit = gj_wide_and(hit, gj_wide_and(gj_wide_cmple(zero, t), gj_wide_cmplt(t, best_t)));
+
+    *out_t = t;
+    *out_u = u;
+    *out_v = v;
+    return hit;
+}
+
+// NOTE: Nearest hit of one ray against all triangles with t < t_max.
+//       hit->triangle is GJ_RAY_NO_HIT (and false returned) if there's none.
+static b32
+ray_triangles_intersection(V3f ray_origin, V3f ray_direction, TriangleSoA* triangles, RayHit* hit, f32 t_max = FLT_MAX)
+{
+    WideF32 ox = gj_wide_set1(ray_origin.x),    oy = gj_wide_set1(ray_origin.y),    oz = gj_wide_set1(ray_origin.z);
+    WideF32 dx = gj_wide_set1(ray_direction.x), dy = gj_wide_set1(ray_direction.y), dz = gj_wide_set1(ray_direction.z);
+    WideF32 best_t = gj_wide_set1(t_max);
+    WideF32 best_u = gj_wide_set1(0.0f);
+    WideF32 best_v = gj_wide_set1(0.0f);
+    // NOTE: Index of the lane's best hit, as the float bits of a u32
+    WideF32 best_index = gj_wide_set1(0.0f);
+    u32 any_hit = 0;
+
+    V3fSoA* v0 = &triangles->v0;
+    V3fSoA* e1 = &triangles->edge1;
+    V3fSoA* e2 = &triangles->edge2;
+    for (u32 i = 0; i < triangles->count; i += GJ_WIDE_LANES)
+    {
+        WideF32 t, u, v;
+        WideF32 lane_hit = gj__ray_triangle_wide(ox, oy, oz, dx, dy, dz,
+                                                 gj_wide_load(v0->x + i), gj_wide_load(v0->y + i), gj_wide_load(v0->z + i),
+                                                 gj_wide_load(e1->x + i), gj_wide_load(e1->y + i), gj_wide_load(e1->z + i),
+                                                 gj_wide_load(e2->x + i), gj_wide_load(e2->y + i), gj_wide_load(e2->z + i),
+                                                 best_t, &t, &u, &v);
+        u32 mask = gj_wide_movemask(lane_hit);
+        if (mask)
+        {
+            u32 indices[GJ_WIDE_LANES];
+            for (u32 lane = 0; lane < GJ_WIDE_LANES; lane++) indices[lane] = i + lane;
+            best_t     = gj_wide_select(best_t, t, lane_hit);
+            best_u     = gj_wide_select(best_u, u, lane_hit);
+            best_v     = gj_wide_select(best_v, v, lane_hit);
+            best_index = gj_wide_select(best_index, gj_wide_load((f32*)indices), lane_hit);
+            any_hit   |= mask;
+        }
+    }
+
+    hit->t        = t_max;
+    hit->u        = 0.0f;
+    hit->v        = 0.0f;
+    hit->triangle = GJ_RAY_NO_HIT;
+    if (!any_hit) return gj_False;
+
+    f32 ts[GJ_WIDE_LANES], us[GJ_WIDE_LANES], vs[GJ_WIDE_LANES];
+    u32 indices[GJ_WIDE_LANES];
+    gj_wide_store(ts, best_t);
+    gj_wide_store(us, best_u);
+    gj_wide_store(vs, best_v);
+    gj_wide_store((f32*)indices, best_index);
+    for (u32 lane = 0; lane < GJ_WIDE_LANES; lane++)
+    {
+        // NOTE: Ties go to the lower triangle index like a scalar loop would
+        if ((any_hit & (1u << lane)) && (ts[lane] < hit->t || (ts[lane] == hit->t && indices[lane] < hit->triangle)))
+        {
+            hit->t        = ts[lane];
+            hit->u        = us[lane];
+            hit->v        = vs[lane];
+            hit->triangle = indices[lane];
+        }
+    }
+    return gj_True;
+}
+
+// NOTE: Packet version, GJ_WIDE_LANES rays per lane group against every
+//       triangle. Coherent rays (picking around the cursor, a tile of
+//       camera rays) should be grouped together. hits[i] is for ray i.
+//       Returns how many rays hit something.
+static u32
+ray_packet_triangles_intersection(V3fSoA* ray_origins, V3fSoA* ray_directions, TriangleSoA* triangles, RayHit* hits,
+                                  f32 t_max = FLT_MAX)
+{
+    gj_AssertDebug(ray_origins->count == ray_directions->count);
+    u32 hit_count = 0;
+    u32 ray_count = ray_origins->count;
+    u32 r = 0;
+    for (; r + GJ_WIDE_LANES <= ray_count; r += GJ_WIDE_LANES)
+    {
+        WideF32 ox = gj_wide_load(ray_origins->x + r),    oy = gj_wide_load(ray_origins->y + r),    oz = gj_wide_load(ray_origins->z + r);
+        WideF32 dx = gj_wide_load(ray_directions->x + r), dy = gj_wide_load(ray_directions->y + r), dz = gj_wide_load(ray_directions->z + r);
+        WideF32 best_t = gj_wide_set1(t_max);
+        WideF32 best_u = gj_wide_set1(0.0f);
+        WideF32 best_v = gj_wide_set1(0.0f);
+        WideF32 best_index = gj_wide_set1(0.0f);
+        u32 any_hit = 0;
+
+        for (u32 i = 0; i < triangles->count; i++)
+        {
+            WideF32 t, u, v;
+            WideF32 lane_hit = gj__ray_triangle_wide(ox, oy, oz, dx, dy, dz,
+                                                     gj_wide_set1(triangles->v0.x[i]),    gj_wide_set1(triangles->v0.y[i]),    gj_wide_set1(triangles->v0.z[i]),
+                                                     gj_wide_set1(triangles->edge1.x[i]), gj_wide_set1(triangles->edge1.y[i]), gj_wide_set1(triangles->edge1.z[i]),
+                                                     gj_wide_set1(triangles->edge2.x[i]), gj_wide_set1(triangles->edge2.y[i]), gj_wide_set1(triangles->edge2.z[i]),
+                                                     best_t, &t, &u, &v);
+            u32 mask = gj_wide_movemask(lane_hit);
+            if (mask)
+            {
+                f32 index_bits;
+                memcpy(&index_bits, &i, sizeof(u32));
+                best_t     = gj_wide_select(best_t, t, lane_hit);
+                best_u     = gj_wide_select(best_u, u, lane_hit);
+                best_v     = gj_wide_select(best_v, v, lane_hit);
+                best_index = gj_wide_select(best_index, gj_wide_set1(index_bits), lane_hit);
+                any_hit   |= mask;
+            }
+        }
+
+        f32 ts[GJ_WIDE_LANES], us[GJ_WIDE_LANES], vs[GJ_WIDE_LANES];
+        u32 indices[GJ_WIDE_LANES];
+        gj_wide_store(ts, best_t);
+        gj_wide_store(us, best_u);
+        gj_wide_store(vs, best_v);
+        gj_wide_store((f32*)indices, best_index);
+        for (u32 lane = 0; lane < GJ_WIDE_LANES; lane++)
+        {
+            RayHit* hit = hits + r + lane;
+            b32 lane_hit = (any_hit >> lane) & 1;
+            hit->t        = lane_hit ? ts[lane] : t_max;
+            hit->u        = lane_hit ? us[lane] : 0.0f;
+            hit->v        = lane_hit ? vs[lane] : 0.0f;
+            hit->triangle = lane_hit ? indices[lane] : GJ_RAY_NO_HIT;
+            hit_count += lane_hit;
+        }
+    }
+    for (; r < ray_count; r++)
+    {
+        hit_count += ray_triangles_intersection(V3fSoA_get(ray_origins, r), V3fSoA_get(ray_directions, r), triangles, hits + r, t_max);
+    }
+    return hit_count;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Frustum Culling
+///////////////////////////////////////////////////////////////////////////
+// NOTE: Planes are (normal, d) with normal pointing in and normalized, so
+//       dot(normal, p) + d is the signed distance, >= 0 inside.
+//       Extracted from a combined projection * view matrix (Gribb/Hartmann)
+//       for column vectors, with clip z in [0, w] like M4x4_projection_matrix
+//       and M4x4_orthographic_matrix produce.
+//       The AABB/sphere tests are conservative: something is only culled when
+//       it is fully outside one of the planes.
+typedef enum FrustumPlane
+{
+    FrustumPlane_Left,
+    FrustumPlane_Right,
+    FrustumPlane_Bottom,
+    FrustumPlane_Top,
+    FrustumPlane_Near,
+    FrustumPlane_Far,
+    FrustumPlane_Count
+} FrustumPlane;
+
+typedef struct Frustum
+{
+    V4f planes[FrustumPlane_Count];
+} Frustum;
+
+static Frustum
+Frustum_from_M4x4(M4x4 m)
+{
+    Frustum result;
+    for (u32 i = 0; i < 4; i++)
+    {
+        f32 r0 = m.m[0][i], r1 = m.m[1][i], r2 = m.m[2][i], r3 = m.m[3][i];
+        result.planes[FrustumPlane_Left].array[i]   = r3 + r0;
+        result.planes[FrustumPlane_Right].array[i]  = r3 - r0;
+        result.planes[FrustumPlane_Bottom].array[i] = r3 + r1;
+        result.planes[FrustumPlane_Top].array[i]    = r3 - r1;
+        result.planes[FrustumPlane_Near].array[i]   = r2;
+        result.planes[FrustumPlane_Far].array[i]    = r3 - r2;
+    }
+    for (u32 i = 0; i < FrustumPlane_Count; i++)
+    {
+        V4f* plane = result.planes + i;
+        f32 inv_length = 1.0f / V3_length(plane->x, plane->y, plane->z);
+        *plane = V4_mul(inv_length, *plane);
+    }
+    return result;
+}
+
+inline f32 Frustum__distance(V4f plane, f32 x, f32 y, f32 z) { return plane.x * x + plane.y * y + plane.z * z + plane.w; }
+
+// NOTE: The batch versions below give the same answers, same operations
+inline b32
+Frustum_intersects_sphere(Frustum* frustum, V3f center, f32 radius)
+{
+    for (u32 i = 0; i < FrustumPlane_Count; i++)
+    {
+        if (Frustum__distance(frustum->planes[i], center.x, center.y, center.z) + radius < 0.0f) return gj_False;
+    }
+    return gj_True;
+}
+
+// NOTE: Center/extent form, the extent projected on the normal is the
+//       distance of the corner furthest along it
+inline b32
+Frustum_intersects_aabb(Frustum* frustum, V3f box_min, V3f box_max)
+{
+    V3f c = V3_mul(V3_add(box_min, box_max), 0.5f);
+    V3f e = V3_mul(V3_sub(box_max, box_min), 0.5f);
+    for (u32 i = 0; i < FrustumPlane_Count; i++)
+    {
+        V4f p = frustum->planes[i];
+        f32 r = gj_Abs(p.x) * e.x + gj_Abs(p.y) * e.y + gj_Abs(p.z) * e.z;
+        if (Frustum__distance(p, c.x, c.y, c.z) + r < 0.0f) return gj_False;
+    }
+    return gj_True;
+}
+
+typedef struct Frustum__WidePlanes
+{
+    WideF32 x[FrustumPlane_Count];
+    WideF32 y[FrustumPlane_Count];
+    WideF32 z[FrustumPlane_Count];
+    WideF32 d[FrustumPlane_Count];
+} Frustum__WidePlanes;
+
+inline void
+Frustum__wide_planes(Frustum* frustum, Frustum__WidePlanes* wide)
+{
+    for (u32 i = 0; i < FrustumPlane_Count; i++)
+    {
+        wide->x[i] = gj_wide_set1(frustum->planes[i].x);
+        wide->y[i] = gj_wide_set1(frustum->planes[i].y);
+        wide->z[i] = gj_wide_set1(frustum->planes[i].z);
+        wide->d[i] = gj_wide_set1(frustum->planes[i].w);
+    }
+}
+
+// NOTE: Appends first_index + lane for every set bit of mask
+inline u32
+Frustum__append_visible(u32* visible, u32 visible_count, u32 mask, u32 first_index)
+{
+    for (; mask; mask &= mask - 1) visible[visible_count++] = first_index + gj_count_trailing_zeros_u32(mask);
+    return visible_count;
+}
+
+static u32
+Frustum__cull_aabbs(Frustum* frustum, Frustum__WidePlanes* wide,
+                    f32* min_x, f32* min_y, f32* min_z, f32* max_x, f32* max_y, f32* max_z,
+                    u32 count, u32 first_index, u32* visible, u32 visible_count)
+{
+    WideF32 half = gj_wide_set1(0.5f);
+    WideF32 zero = gj_wide_set1(0.0f);
+    u32 i = 0;
+    for (; i + GJ_WIDE_LANES <= count; i += GJ_WIDE_LANES)
+    {
+        WideF32 x0 = gj_wide_load(min_x + i), y0 = gj_wide_load(min_y + i), z0 = gj_wide_load(min_z + i);
+        WideF32 x1 = gj_wide_load(max_x + i), y1 = gj_wide_load(max_y + i), z1 = gj_wide_load(max_z + i);
+        WideF32 cx = gj_wide_mul(gj_wide_add(x0, x1), half), ex = gj_wide_mul(gj_wide_sub(x1, x0), half);
+        WideF32 cy = gj_wide_mul(gj_wide_add(y0, y1), half), ey = gj_wide_mul(gj_wide_sub(y1, y0), half);
+        WideF32 cz = gj_wide_mul(gj_wide_add(z0, z1), half), ez = gj_wide_mul(gj_wide_sub(z1, z0), half);
+        WideF32 outside = zero;
+        for (u32 p = 0; p < FrustumPlane_Count; p++)
+        {
+            WideF32 distance = gj_wide_add(gj_wide_add(gj_wide_add(gj_wide_mul(wide->x[p], cx), gj_wide_mul(wide->y[p], cy)),
+                                                       gj_wide_mul(wide->z[p], cz)), wide->d[p]);
+            WideF32 r = gj_wide_add(gj_wide_add(gj_wide_mul(gj_wide_abs(wide->x[p]), ex), gj_wide_mul(gj_wide_abs(wide->y[p]), ey)),
+                                    gj_wide_mul(gj_wide_abs(wide->z[p]), ez));
+            outside = gj_wide_or(outside, gj_wide_cmplt(gj_wide_add(distance, r), zero));
+        }
+        u32 inside = ~gj_wide_movemask(outside) & ((1u << GJ_WIDE_LANES) - 1);
+        visible_count = Frustum__append_visible(visible, visible_count, inside, first_index + i);
+    }
+    for (; i < count; i++)
+    {
+        if (Frustum_intersects_aabb(frustum, {min_x[i], min_y[i], min_z[i]}, {max_x[i], max_y[i], max_z[i]}))
+        {
+            visible[visible_count++] = first_index + i;
+        }
+    }
+    return visible_count;
+}
+
+static u32
+Frustum__cull_spheres(Frustum* frustum, Frustum__WidePlanes* wide, f32* center_x, f32* center_y, f32* center_z, f32* radii,
+                      u32 count, u32 first_index, u32* visible, u32 visible_count)
+{
+    WideF32 zero = gj_wide_set1(0.0f);
+    u32 i = 0;
+    for (; i + GJ_WIDE_LANES <= count; i += GJ_WIDE_LANES)
+    {
+        WideF32 cx = gj_wide_load(center_x + i), cy = gj_wide_load(center_y + i), cz = gj_wide_load(center_z + i);
+        WideF32 radius  = gj_wide_load(radii + i);
+        WideF32 outside = zero;
+        for (u32 p = 0; p < FrustumPlane_Count; p++)
+        {
+            WideF32 distance = gj_wide_add(gj_wide_add(gj_wide_add(gj_wide_mul(wide->x[p], cx), gj_wide_mul(wide->y[p], cy)),
+                                                       gj_wide_mul(wide->z[p], cz)), wide->d[p]);
+            outside = gj_wide_or(outside, gj_wide_cmplt(gj_wide_add(distance, radius), zero));
+        }
+        u32 inside = ~gj_wide_movemask(outside) & ((1u << GJ_WIDE_LANES) - 1);
+        visible_count = Frustum__append_visible(visible, visible_count, inside, first_index + i);
+    }
+    for (; i < count; i++)
+    {
+        if (Frustum_intersects_sphere(frustum, {center_x[i], center_y[i], center_z[i]}, radii[i]))
+        {
+            visible[visible_count++] = first_index + i;
+        }
+    }
+    return visible_count;
+}
+
+// NOTE: Batch culling, writes the indices of everything that isn't culled in
+//       order into visible (room for count of them) and returns how many.
+//       AoS input is transposed to SoA a chunk at a time on the stack.
+#define GJ_FRUSTUM_CHUNK 256
+
+static u32
+Frustum_cull_aabbs(Frustum* frustum, V3fSoA* box_min, V3fSoA* box_max, u32* visible)
+{
+    Frustum__WidePlanes wide;
+    Frustum__wide_planes(frustum, &wide);
+    return Frustum__cull_aabbs(frustum, &wide, box_min->x, box_min->y, box_min->z, box_max->x, box_max->y, box_max->z,
+                               box_min->count, 0, visible, 0);
+}
+
+static u32
+Frustum_cull_aabbs(Frustum* frustum, V3f* box_min, V3f* box_max, u32 count, u32* visible)
+{
+    Frustum__WidePlanes wide;
+    Frustum__wide_planes(frustum, &wide);
+    f32 chunk[6][GJ_FRUSTUM_CHUNK];
+    u32 visible_count = 0;
+    for (u32 first = 0; first < count; first += GJ_FRUSTUM_CHUNK)
+    {
+        u32 chunk_count = gj_Min(count - first, GJ_FRUSTUM_CHUNK);
+        for (u32 i = 0; i < chunk_count; i++)
+        {
+            chunk[0][i] = box_min[first + i].x; chunk[1][i] = box_min[first + i].y; chunk[2][i] = box_min[first + i].z;
+            chunk[3][i] = box_max[first + i].x; chunk[4][i] = box_max[first + i].y; chunk[5][i] = box_max[first + i].z;
+        }
+        visible_count = Frustum__cull_aabbs(frustum, &wide, chunk[0], chunk[1], chunk[2], chunk[3], chunk[4], chunk[5],
+                                            chunk_count, first, visible, visible_count);
+    }
+    return visible_count;
+}
+
+static u32
+Frustum_cull_spheres(Frustum* frustum, V3fSoA* centers, f32* radii, u32* visible)
+{
+    Frustum__WidePlanes wide;
+    Frustum__wide_planes(frustum, &wide);
+    return Frustum__cull_spheres(frustum, &wide, centers->x, centers->y, centers->z, radii, centers->count, 0, visible, 0);
+}
+
+static u32
+Frustum_cull_spheres(Frustum* frustum, V3f* centers, f32* radii, u32 count, u32* visible)
+{
+    Frustum__WidePlanes wide;
+    Frustum__wide_planes(frustum, &wide);
+    f32 chunk[3][GJ_FRUSTUM_CHUNK];
+    u32 visible_count = 0;
+    for (u32 first = 0; first < count; first += GJ_FRUSTUM_CHUNK)
+    {
+        u32 chunk_count = gj_Min(count - first, GJ_FRUSTUM_CHUNK);
+        for (u32 i = 0; i < chunk_count; i++)
+        {
+            chunk[0][i] = centers[first + i].x; chunk[1][i] = centers[first + i].y; chunk[2][i] = centers[first + i].z;
+        }
+        visible_count = Frustum__cull_spheres(frustum, &wide, chunk[0], chunk[1], chunk[2], radii + first,
+                                              chunk_count, first, visible, visible_count);
+    }
+    return visible_count;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Grid Math
 ///////////////////////////////////////////////////////////////////////////
@@ -1186,20 +2502,485 @@ gj_math_get_random_u32(RandomSeries* random_series)
     return random_series->a = result;
 }
 
+// NOTE: Lemire's multiply-shift, unbiased. Maps x in [0, 2^32) to [0, range),
+//       the rejection only triggers with probability range / 2^32.
+//       range == 0 gives back the whole u32.
+#define gj__RandomRange(Generator, range)                               \
+    u32 x = gj_random_u32(Generator);                                   \
+    if (range == 0) return x;                                           \
+    u64 m = (u64)x * (u64)range;                                        \
+    u32 l = (u32)m;                                                     \
+    if (l < range)                                                      \
+    {                                                                   \
+        u32 threshold = (0u - range) % range;                           \
+        while (l < threshold)                                           \
+        {                                                               \
+            x = gj_random_u32(Generator);                               \
+            m = (u64)x * (u64)range;                                    \
+            l = (u32)m;                                                 \
+        }                                                               \
+    }                                                                   \
+    return (u32)(m >> 32)
+
+inline u32 gj_random_u32(RandomSeries* random_series) { return gj_math_get_random_u32(random_series); }
+
+// NOTE: Top 24 bits so every value is exactly representable, [0, 1)
+inline f32 gj_random_u32_to_unit_f32(u32 x) { return (f32)(x >> 8) * (1.0f / 16777216.0f); }
+
+// NOTE: For seeding the other generators from a single u64
+inline u64
+gj_random_splitmix64(u64* state)
+{
+    u64 z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro128+ from https://prng.di.unimi.it/
+// NOTE: The lowest bits are weak, everything here uses the high bits
+//       (unit floats and Lemire's range both do)
+typedef struct RandomXoshiro128
+{
+    u32 s[4];
+} RandomXoshiro128;
+
+inline void
+gj_random_seed(RandomXoshiro128* random, u64 seed)
+{
+    u64 a = gj_random_splitmix64(&seed);
+    u64 b = gj_random_splitmix64(&seed);
+    random->s[0] = (u32)a;
+    random->s[1] = (u32)(a >> 32);
+    random->s[2] = (u32)b;
+    random->s[3] = (u32)(b >> 32);
+}
+
+inline u32
+gj_random_u32(RandomXoshiro128* random)
+{
+    u32* s = random->s;
+    u32 result = s[0] + s[3];
+    u32 t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 11) | (s[3] >> 21);
+    return result;
+}
+
+static void
+gj__random_xoshiro128_jump(RandomXoshiro128* random, const u32 jump[4])
+{
+    u32 s[4] = {};
+    for (u32 i = 0; i < 4; i++)
+    {
+        for (u32 b = 0; b < 32; b++)
+        {
+            if (jump[i] & (1u << b))
+            {
+                s[0] ^= random->s[0];
+                s[1] ^= random->s[1];
+                s[2] ^= random->s[2];
+                s[3] ^= random->s[3];
+            }
+            gj_random_u32(random);
+        }
+    }
+    memcpy(random->s, s, sizeof(s));
+}
+
+// NOTE: Same as 2^64 calls, gives 2^64 non-overlapping streams.
+//       Seed once and jump between handing the state to each thread.
+inline void
+gj_random_jump(RandomXoshiro128* random)
+{
+    static const u32 jump[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    gj__random_xoshiro128_jump(random, jump);
+}
+
+// NOTE: Same as 2^96 calls, for a second level of streams (e.g. per job, then jump per thread)
+inline void
+gj_random_long_jump(RandomXoshiro128* random)
+{
+    static const u32 long_jump[4] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+    gj__random_xoshiro128_jump(random, long_jump);
+}
+
+// PCG32 (XSH RR) from https://www.pcg-random.org/
+// NOTE: Statistically stronger than xoshiro128+ in the low bits, somewhat
+//       slower. Different stream values give independent sequences.
+typedef struct RandomPCG32
+{
+    u64 state;
+    u64 inc;
+} RandomPCG32;
+
+inline u32
+gj_random_u32(RandomPCG32* random)
+{
+    u64 old = random->state;
+    random->state = old * 6364136223846793005ull + random->inc;
+    u32 xorshifted = (u32)(((old >> 18u) ^ old) >> 27u);
+    u32 rot = (u32)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+}
+
+inline void
+gj_random_seed(RandomPCG32* random, u64 seed, u64 stream = 0)
+{
+    random->state = 0;
+    random->inc   = (stream << 1u) | 1u;
+    gj_random_u32(random);
+    random->state += seed;
+    gj_random_u32(random);
+}
+
+// NOTE: Skips delta steps in O(log delta)
+static void
+gj_random_advance(RandomPCG32* random, u64 delta)
+{
+    u64 acc_mult = 1;
+    u64 acc_plus = 0;
+    u64 cur_mult = 6364136223846793005ull;
+    u64 cur_plus = random->inc;
+    while (delta > 0)
+    {
+        if (delta & 1)
+        {
+            acc_mult *= cur_mult;
+            acc_plus = acc_plus * cur_mult + cur_plus;
+        }
+        cur_plus = (cur_mult + 1) * cur_plus;
+        cur_mult *= cur_mult;
+        delta /= 2;
+    }
+    random->state = acc_mult * random->state + acc_plus;
+}
+
+#define gj__DefineRandomFunctions(Generator)                                                                             \
+    inline u32 gj_random_range_u32(Generator* random, u32 range)        { gj__RandomRange(random, range); }             \
+    /* [min, max) */                                                                                                    \
+    inline u32 gj_random_between_u32(Generator* random, u32 min, u32 max)                                              \
+    { return max <= min ? min : min + gj_random_range_u32(random, max - min); }                                         \
+    /* [0, 1) */                                                                                                        \
+    inline f32 gj_random_unit_f32(Generator* random)                    { return gj_random_u32_to_unit_f32(gj_random_u32(random)); } \
+    /* [-1, 1) */                                                                                                       \
+    inline f32 gj_random_bilateral_f32(Generator* random)               { return 2.0f * gj_random_unit_f32(random) - 1.0f; } \
+    inline f32 gj_random_f32(Generator* random, f32 min, f32 max)      { return min + (max - min) * gj_random_unit_f32(random); } \
+    inline V3f gj_random_unit_V3f(Generator* random)                    \
+    { V3f v; v.x = gj_random_unit_f32(random); v.y = gj_random_unit_f32(random); v.z = gj_random_unit_f32(random); return v; } \
+    inline V3f gj_random_V3f(Generator* random, V3f min, V3f max)      \
+    { return V3_add(min, V3_mul(V3_sub(max, min), gj_random_unit_V3f(random))); }
+
+gj__DefineRandomFunctions(RandomSeries);
+gj__DefineRandomFunctions(RandomXoshiro128);
+gj__DefineRandomFunctions(RandomPCG32);
+
+// [min, max)
 inline u32
 gj_math_get_bounded_random_u32(RandomSeries* random_series, u32 min, u32 max)
 {
-    u32 result = gj_math_get_random_u32(random_series);
-    result %= max - min;
-    result += min;
-    return result;
+    if (max <= min) return min;
+    return min + gj_random_range_u32(random_series, max - min);
 }
 
+// [min, max]
 inline u32
 gj_math_get_bounded_inclusive_random_u32(RandomSeries* random_series, u32 min, u32 max)
 {
-    u32 result = gj_math_get_bounded_random_u32(random_series, min, max + 1);
+    if (max <= min) return min;
+    return min + gj_random_range_u32(random_series, max - min + 1);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Wide Random Number Generation
+///////////////////////////////////////////////////////////////////////////
+// NOTE: xoshiro128+ running 4 (SSE2) or 8 (AVX2) independent lanes for bulk
+//       fills. Every lane is its own jumped stream taken from a scalar
+//       generator, so seeding several of these from the same base (one per
+//       thread) never overlaps:
+//           RandomXoshiro128 base; gj_random_seed(&base, seed);
+//           for (each thread) gj_random_seed(&thread->random4, &base);
+typedef struct RandomXoshiro128x4
+{
+    __m128i s[4];
+} RandomXoshiro128x4;
+
+// NOTE: Jumps base once per lane
+static void
+gj_random_seed(RandomXoshiro128x4* random, RandomXoshiro128* base)
+{
+    u32 lanes[4][4];
+    for (u32 lane = 0; lane < 4; lane++)
+    {
+        for (u32 i = 0; i < 4; i++) lanes[i][lane] = base->s[i];
+        gj_random_jump(base);
+    }
+    for (u32 i = 0; i < 4; i++) random->s[i] = _mm_loadu_si128((__m128i*)lanes[i]);
+}
+
+inline __m128i
+gj_random_u32x4(RandomXoshiro128x4* random)
+{
+    __m128i* s = random->s;
+    __m128i result = _mm_add_epi32(s[0], s[3]);
+    __m128i t = _mm_slli_epi32(s[1], 9);
+    s[2] = _mm_xor_si128(s[2], s[0]);
+    s[3] = _mm_xor_si128(s[3], s[1]);
+    s[1] = _mm_xor_si128(s[1], s[2]);
+    s[0] = _mm_xor_si128(s[0], s[3]);
+    s[2] = _mm_xor_si128(s[2], t);
+    s[3] = _mm_or_si128(_mm_slli_epi32(s[3], 11), _mm_srli_epi32(s[3], 21));
+    return result;
+}
+
+inline __m128
+gj_random_unit_f32x4(RandomXoshiro128x4* random)
+{
+    __m128i x = _mm_srli_epi32(gj_random_u32x4(random), 8);
+    return _mm_mul_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(1.0f / 16777216.0f));
+}
+
+// NOTE: High and low halves of the 4 u32 x range products
+inline void
+gj__random_mul_u32x4(__m128i x, __m128i range, __m128i* hi, __m128i* lo)
+{
+    __m128i even = _mm_mul_epu32(x, range);
+    __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(x, 32), range);
+    __m128i lo_mask = _mm_set_epi32(0, -1, 0, -1);
+    *lo = _mm_or_si128(_mm_and_si128(even, lo_mask), _mm_slli_epi64(odd, 32));
+    *hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(lo_mask, odd));
+}
+
+// NOTE: Lemire's range per lane, lanes that get rejected are redrawn from the
+//       next step of the same lane. range == 0 gives back the whole u32.
+static __m128i
+gj_random_range_u32x4(RandomXoshiro128x4* random, u32 range)
+{
+    __m128i x = gj_random_u32x4(random);
+    if (range == 0) return x;
+    __m128i vrange     = _mm_set1_epi32((s32)range);
+    __m128i sign       = _mm_set1_epi32((s32)0x80000000);
+    __m128i vthreshold = _mm_set1_epi32((s32)(((0u - range) % range) ^ 0x80000000));
+    __m128i result, lo;
+    gj__random_mul_u32x4(x, vrange, &result, &lo);
+    // NOTE: Unsigned lo < threshold
+    __m128i reject = _mm_cmplt_epi32(_mm_xor_si128(lo, sign), vthreshold);
+    while (_mm_movemask_epi8(reject))
+    {
+        __m128i hi;
+        gj__random_mul_u32x4(gj_random_u32x4(random), vrange, &hi, &lo);
+        result = _mm_or_si128(_mm_andnot_si128(reject, result), _mm_and_si128(reject, hi));
+        reject = _mm_and_si128(reject, _mm_cmplt_epi32(_mm_xor_si128(lo, sign), vthreshold));
+    }
     return result;
 }
 
+static void
+gj_random_fill_u32(RandomXoshiro128x4* random, u32* out, u32 count)
+{
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i*)(out + i), gj_random_u32x4(random));
+    if (i < count)
+    {
+        u32 tail[4];
+        _mm_storeu_si128((__m128i*)tail, gj_random_u32x4(random));
+        memcpy(out + i, tail, (count - i) * sizeof(u32));
+    }
+}
+
+// [min, max)
+static void
+gj_random_fill_between_u32(RandomXoshiro128x4* random, u32* out, u32 count, u32 min, u32 max)
+{
+    u32 range = max - min;
+    if (max <= min) { for (u32 i = 0; i < count; i++) out[i] = min; return; }
+    __m128i vmin = _mm_set1_epi32((s32)min);
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_si128((__m128i*)(out + i), _mm_add_epi32(vmin, gj_random_range_u32x4(random, range)));
+    }
+    if (i < count)
+    {
+        u32 tail[4];
+        _mm_storeu_si128((__m128i*)tail, _mm_add_epi32(vmin, gj_random_range_u32x4(random, range)));
+        memcpy(out + i, tail, (count - i) * sizeof(u32));
+    }
+}
+
+// [min, max)
+static void
+gj_random_fill_f32(RandomXoshiro128x4* random, f32* out, u32 count, f32 min = 0.0f, f32 max = 1.0f)
+{
+    __m128 vmin   = _mm_set1_ps(min);
+    __m128 vscale = _mm_set1_ps(max - min);
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(out + i, _mm_add_ps(vmin, _mm_mul_ps(vscale, gj_random_unit_f32x4(random))));
+    }
+    if (i < count)
+    {
+        f32 tail[4];
+        _mm_storeu_ps(tail, _mm_add_ps(vmin, _mm_mul_ps(vscale, gj_random_unit_f32x4(random))));
+        memcpy(out + i, tail, (count - i) * sizeof(f32));
+    }
+}
+
+// NOTE: 4 V3f are 3 registers of xyzx yzxy zxyz, so the per axis min/scale
+//       are rotated the same way and the fill stays fully wide
+static void
+gj_random_fill_V3f(RandomXoshiro128x4* random, V3f* out, u32 count, V3f min, V3f max)
+{
+    V3f scale = V3_sub(max, min);
+    __m128 vmin[3]   = { _mm_setr_ps(min.x, min.y, min.z, min.x),
+                         _mm_setr_ps(min.y, min.z, min.x, min.y),
+                         _mm_setr_ps(min.z, min.x, min.y, min.z) };
+    __m128 vscale[3] = { _mm_setr_ps(scale.x, scale.y, scale.z, scale.x),
+                         _mm_setr_ps(scale.y, scale.z, scale.x, scale.y),
+                         _mm_setr_ps(scale.z, scale.x, scale.y, scale.z) };
+    f32* dst = (f32*)out;
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4, dst += 12)
+    {
+        for (u32 j = 0; j < 3; j++)
+        {
+            _mm_storeu_ps(dst + 4 * j, _mm_add_ps(vmin[j], _mm_mul_ps(vscale[j], gj_random_unit_f32x4(random))));
+        }
+    }
+    for (; i < count; i++, dst += 3)
+    {
+        f32 unit[4];
+        _mm_storeu_ps(unit, gj_random_unit_f32x4(random));
+        dst[0] = min.x + scale.x * unit[0];
+        dst[1] = min.y + scale.y * unit[1];
+        dst[2] = min.z + scale.z * unit[2];
+    }
+}
+
+#if defined(GJ_AVX2)
+typedef struct RandomXoshiro128x8
+{
+    __m256i s[4];
+} RandomXoshiro128x8;
+
+static void
+gj_random_seed(RandomXoshiro128x8* random, RandomXoshiro128* base)
+{
+    u32 lanes[4][8];
+    for (u32 lane = 0; lane < 8; lane++)
+    {
+        for (u32 i = 0; i < 4; i++) lanes[i][lane] = base->s[i];
+        gj_random_jump(base);
+    }
+    for (u32 i = 0; i < 4; i++) random->s[i] = _mm256_loadu_si256((__m256i*)lanes[i]);
+}
+
+inline __m256i
+gj_random_u32x8(RandomXoshiro128x8* random)
+{
+    __m256i* s = random->s;
+    __m256i result = _mm256_add_epi32(s[0], s[3]);
+    __m256i t = _mm256_slli_epi32(s[1], 9);
+    s[2] = _mm256_xor_si256(s[2], s[0]);
+    s[3] = _mm256_xor_si256(s[3], s[1]);
+    s[1] = _mm256_xor_si256(s[1], s[2]);
+    s[0] = _mm256_xor_si256(s[0], s[3]);
+    s[2] = _mm256_xor_si256(s[2], t);
+    s[3] = _mm256_or_si256(_mm256_slli_epi32(s[3], 11), _mm256_srli_epi32(s[3], 21));
+    return result;
+}
+
+inline __m256
+gj_random_unit_f32x8(RandomXoshiro128x8* random)
+{
+    __m256i x = _mm256_srli_epi32(gj_random_u32x8(random), 8);
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(x), _mm256_set1_ps(1.0f / 16777216.0f));
+}
+
+inline void
+gj__random_mul_u32x8(__m256i x, __m256i range, __m256i* hi, __m256i* lo)
+{
+    __m256i even = _mm256_mul_epu32(x, range);
+    __m256i odd  = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), range);
+    *lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    *hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+static __m256i
+gj_random_range_u32x8(RandomXoshiro128x8* random, u32 range)
+{
+    __m256i x = gj_random_u32x8(random);
+    if (range == 0) return x;
+    __m256i vrange     = _mm256_set1_epi32((s32)range);
+    __m256i vthreshold = _mm256_set1_epi32((s32)((0u - range) % range));
+    __m256i result, lo;
+    gj__random_mul_u32x8(x, vrange, &result, &lo);
+    // NOTE: Unsigned lo < threshold is lo != max(lo, threshold)
+    __m256i reject = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(lo, vthreshold), lo), _mm256_set1_epi32(-1));
+    while (_mm256_movemask_epi8(reject))
+    {
+        __m256i hi;
+        gj__random_mul_u32x8(gj_random_u32x8(random), vrange, &hi, &lo);
+        result = _mm256_blendv_epi8(result, hi, reject);
+        reject = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(lo, vthreshold), lo), reject);
+    }
+    return result;
+}
+
+static void
+gj_random_fill_u32(RandomXoshiro128x8* random, u32* out, u32 count)
+{
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8) _mm256_storeu_si256((__m256i*)(out + i), gj_random_u32x8(random));
+    if (i < count)
+    {
+        u32 tail[8];
+        _mm256_storeu_si256((__m256i*)tail, gj_random_u32x8(random));
+        memcpy(out + i, tail, (count - i) * sizeof(u32));
+    }
+}
+
+static void
+gj_random_fill_between_u32(RandomXoshiro128x8* random, u32* out, u32 count, u32 min, u32 max)
+{
+    u32 range = max - min;
+    if (max <= min) { for (u32 i = 0; i < count; i++) out[i] = min; return; }
+    __m256i vmin = _mm256_set1_epi32((s32)min);
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi32(vmin, gj_random_range_u32x8(random, range)));
+    }
+    if (i < count)
+    {
+        u32 tail[8];
+        _mm256_storeu_si256((__m256i*)tail, _mm256_add_epi32(vmin, gj_random_range_u32x8(random, range)));
+        memcpy(out + i, tail, (count - i) * sizeof(u32));
+    }
+}
+
+static void
+gj_random_fill_f32(RandomXoshiro128x8* random, f32* out, u32 count, f32 min = 0.0f, f32 max = 1.0f)
+{
+    __m256 vmin   = _mm256_set1_ps(min);
+    __m256 vscale = _mm256_set1_ps(max - min);
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(vmin, _mm256_mul_ps(vscale, gj_random_unit_f32x8(random))));
+    }
+    if (i < count)
+    {
+        f32 tail[8];
+        _mm256_storeu_ps(tail, _mm256_add_ps(vmin, _mm256_mul_ps(vscale, gj_random_unit_f32x8(random))));
+        memcpy(out + i, tail, (count - i) * sizeof(f32));
+    }
+}
+#endif
+
 #endif
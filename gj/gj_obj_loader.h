@@ -97,7 +97,7 @@ gj_obj_loader_load(PlatformAPI* platform_api, const char* obj_filename,
     parse_state.buffer = (u8*)platform_api->allocate_memory(1024 * 1024);
     PlatformFileHandle obj_file_handle = platform_api->get_file_handle(obj_filename, PlatformOpenFileModeFlags_Read);
     platform_api->read_data_from_file_handle(obj_file_handle, 0, obj_file_handle.file_size, parse_state.buffer);
-    parse_state.buffer_contents_size = obj_file_handle.file_size;
+    parse_state.buffer_contents_size = gj_safe_cast_u64_to_u32(obj_file_handle.file_size);
 
     *vertex_count = 0;
     *index_count  = 0;
@@ -0,0 +1,377 @@
+#if !defined(GJ_PACK_H)
+#define GJ_PACK_H
+
+// Single-file asset pack.
+//
+// Layout:
+//  GJPackHeader
+//  file data, every file starting at a multiple of data_alignment
+//  GJPackEntry[entry_count] (the table of contents), sorted by name_hash
+//
+// Reading maps the whole pack with platform_api->map_file and hands out
+// pointers straight into the mapping, nothing is copied.
+//
+// Writing:
+//  GJPackWriter writer;
+//  gj_pack_writer_begin(&writer, platform_api, &arena, "assets.pack", max_entry_count);
+//  gj_pack_writer_add_file(&writer, "textures/grass.png", "data/textures/grass.png", &scratch_arena);
+//  gj_pack_writer_add_file(&writer, "levels/one.level", "data/levels/one.level", &scratch_arena, GJPackCompression_LZ);
+//  gj_pack_writer_end(&writer);
+//
+// Reading:
+//  GJPack pack;
+//  gj_pack_open(&pack, platform_api, "assets.pack");
+//  u64 size;
+//  void* data = gj_pack_get_file(&pack, "textures/grass.png", &size);
+//  GJPackEntry* entry = gj_pack_find(&pack, "levels/one.level");
+//  void* level = push_size(&arena, entry->uncompressed_size);
+//  gj_pack_read_entry(&pack, entry, level, platform_api, thread_count);
+//  gj_pack_close(&pack, platform_api);
+
+#include <gj/gj_base.h>
+#include <gj/gj_compress.h>
+
+#include <stdlib.h> // qsort
+
+#define GJ_PACK_MAGIC          0x4B504A47 // "GJPK"
+#define GJ_PACK_VERSION        2
+#define GJ_PACK_DATA_ALIGNMENT 64
+
+typedef enum GJPackCompression
+{
+    GJPackCompression_None = 0,
+    // NOTE: gj_compress stream
+    GJPackCompression_LZ   = 1
+} GJPackCompression;
+
+struct GJPackHeader
+{
+    u32 magic;
+    u32 version;
+    u32 entry_count;
+    u32 data_alignment;
+    u64 toc_offset;
+    u64 file_size;
+};
+
+struct GJPackEntry
+{
+    u64 name_hash;
+    u64 offset;
+    // NOTE: size is what's stored in the pack, uncompressed_size is the same
+    //       for GJPackCompression_None
+    u32 size;
+    u32 uncompressed_size;
+    u32 compression;
+    // NOTE: gj_crc32c of the stored bytes, checked by gj_pack_verify
+    u32 crc32c;
+};
+
+// NOTE: FNV-1a, with '\' treated as '/' so that names built on either
+//       platform hash the same. The name hash is part of the file format, so
+//       it is kept separate from gj_hash64 rather than changing whenever that
+//       does, and hashing a byte at a time lets it fold the separators
+//       without copying the name first. Names are short, so the speed of
+//       gj_hash64 doesn't matter here.
+static u64
+gj_pack_hash_name(const char* name)
+{
+    u64 result = 0xCBF29CE484222325ull;
+    for (const char* at = name; *at; at++)
+    {
+        char c = *at == '\\' ? '/' : *at;
+        result ^= (u8)c;
+        result *= 0x100000001B3ull;
+    }
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Reader
+///////////////////////////////////////////////////////////////////////////
+struct GJPack
+{
+    PlatformMappedFile mapped_file;
+    GJPackEntry*       entries;
+    u32                entry_count;
+};
+
+static b32
+gj_pack_open(GJPack* pack, PlatformAPI* platform_api, const char* pack_file_name)
+{
+    b32 result = gj_False;
+    gj__ZeroStruct(*pack);
+
+    PlatformMappedFile mapped_file = platform_api->map_file(pack_file_name);
+    if (!mapped_file.memory) return result;
+
+    GJPackHeader* header = (GJPackHeader*)mapped_file.memory;
+    if (mapped_file.size >= sizeof(GJPackHeader) &&
+        header->magic == GJ_PACK_MAGIC &&
+        header->version == GJ_PACK_VERSION &&
+        header->file_size == mapped_file.size &&
+        header->toc_offset % sizeof(u64) == 0 &&
+        header->toc_offset <= mapped_file.size &&
+        header->entry_count * sizeof(GJPackEntry) <= mapped_file.size - header->toc_offset)
+    {
+        result = gj_True;
+        GJPackEntry* entries = (GJPackEntry*)((u8*)mapped_file.memory + header->toc_offset);
+        for (u32 entry_index = 0; entry_index < header->entry_count; entry_index++)
+        {
+            if (entries[entry_index].offset > mapped_file.size ||
+                entries[entry_index].size > mapped_file.size - entries[entry_index].offset)
+            {
+                result = gj_False;
+                break;
+            }
+        }
+
+        if (result)
+        {
+            pack->mapped_file = mapped_file;
+            pack->entries     = entries;
+            pack->entry_count = header->entry_count;
+        }
+    }
+
+    if (!result)
+    {
+        platform_api->log_error(__FILE__, __FUNCTION__, __LINE__, "%s is not a valid pack", pack_file_name);
+        platform_api->unmap_file(mapped_file);
+    }
+
+    return result;
+}
+
+static void
+gj_pack_close(GJPack* pack, PlatformAPI* platform_api)
+{
+    platform_api->unmap_file(pack->mapped_file);
+    gj__ZeroStruct(*pack);
+}
+
+static GJPackEntry*
+gj_pack_find(GJPack* pack, u64 name_hash)
+{
+    GJPackEntry* result = NULL;
+    if (pack->entry_count > 0)
+    {
+        // NOTE: Branchless lower bound, the table of contents is sorted by hash
+        GJPackEntry* base = pack->entries;
+        u32 count = pack->entry_count;
+        while (count > 1)
+        {
+            u32 half = count / 2;
+            base  = base[half].name_hash <= name_hash ? base + half : base;
+            count -= half;
+        }
+        if (base->name_hash == name_hash) result = base;
+    }
+    return result;
+}
+
+inline GJPackEntry*
+gj_pack_find(GJPack* pack, const char* name) { return gj_pack_find(pack, gj_pack_hash_name(name)); }
+
+// NOTE: Points into the mapped pack, valid until gj_pack_close
+inline void*
+gj_pack_get_data(GJPack* pack, GJPackEntry* entry) { return (u8*)pack->mapped_file.memory + entry->offset; }
+
+inline b32
+gj_pack_verify(GJPack* pack, GJPackEntry* entry) { return gj_crc32c(0, gj_pack_get_data(pack, entry), entry->size) == entry->crc32c; }
+
+// NOTE: NULL if the file is missing or stored compressed
+static void*
+gj_pack_get_file(GJPack* pack, const char* name, u64* size)
+{
+    void* result = NULL;
+    GJPackEntry* entry = gj_pack_find(pack, name);
+    if (entry && entry->compression == GJPackCompression_None)
+    {
+        result = gj_pack_get_data(pack, entry);
+        if (size) *size = entry->size;
+    }
+    return result;
+}
+
+// NOTE: Copies or decompresses the entry into dst, which has to hold
+//       entry->uncompressed_size bytes
+static b32
+gj_pack_read_entry(GJPack* pack, GJPackEntry* entry, void* dst, PlatformAPI* platform_api, u32 thread_count = 1)
+{
+    b32 result = gj_False;
+    void* data = gj_pack_get_data(pack, entry);
+    switch (entry->compression)
+    {
+        case GJPackCompression_None:
+        {
+            memcpy(dst, data, entry->size);
+            result = gj_True;
+        } break;
+        case GJPackCompression_LZ:
+        {
+            result = gj_decompress(platform_api, data, entry->size, dst, entry->uncompressed_size, thread_count);
+        } break;
+    }
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Writer
+///////////////////////////////////////////////////////////////////////////
+struct GJPackWriter
+{
+    PlatformAPI*       platform_api;
+    PlatformFileHandle file_handle;
+    GJPackEntry*       entries;
+    u32                entry_count;
+    u32                max_entry_count;
+    u64                offset;
+    b32                ok;
+};
+
+static int
+gj_pack_compare_entries(const void* a, const void* b)
+{
+    u64 a_hash = ((GJPackEntry*)a)->name_hash;
+    u64 b_hash = ((GJPackEntry*)b)->name_hash;
+    return (a_hash > b_hash) - (a_hash < b_hash);
+}
+
+inline u64
+gj_pack_align(u64 offset, u64 alignment) { return (offset + alignment - 1) & ~(alignment - 1); }
+
+static b32
+gj_pack_writer_begin(GJPackWriter* writer, PlatformAPI* platform_api, MemoryArena* arena,
+                     const char* pack_file_name, u32 max_entry_count)
+{
+    gj__ZeroStruct(*writer);
+    writer->platform_api    = platform_api;
+    writer->file_handle     = platform_api->get_file_handle(pack_file_name, PlatformOpenFileModeFlags_Write | PlatformOpenFileModeFlags_Overwrite);
+    writer->entries         = push_array(arena, GJPackEntry, max_entry_count);
+    writer->max_entry_count = max_entry_count;
+    writer->offset          = gj_pack_align(sizeof(GJPackHeader), GJ_PACK_DATA_ALIGNMENT);
+    writer->ok              = writer->file_handle.handle != PLATFORM_INVALID_FILE_HANDLE;
+    return writer->ok;
+}
+
+static b32
+gj_pack_writer_add_stored(GJPackWriter* writer, const char* name, void* data, u64 size,
+                          u32 compression, u64 uncompressed_size)
+{
+    if (!writer->ok) return gj_False;
+
+    gj_AssertDebug(writer->entry_count < writer->max_entry_count);
+    gj_AssertDebug(uncompressed_size <= gj_BitmaskU32);
+    if (writer->entry_count == writer->max_entry_count || uncompressed_size > gj_BitmaskU32)
+    {
+        writer->ok = gj_False;
+        return gj_False;
+    }
+
+    GJPackEntry* entry = &writer->entries[writer->entry_count++];
+    entry->name_hash         = gj_pack_hash_name(name);
+    entry->offset            = writer->offset;
+    entry->size              = (u32)size;
+    entry->uncompressed_size = (u32)uncompressed_size;
+    entry->compression       = compression;
+    entry->crc32c            = gj_crc32c(0, data, size);
+
+    if (size > 0) writer->platform_api->write_data_to_file_handle(writer->file_handle, writer->offset, size, data);
+    writer->offset = gj_pack_align(writer->offset + size, GJ_PACK_DATA_ALIGNMENT);
+
+    return gj_True;
+}
+
+inline b32
+gj_pack_writer_add(GJPackWriter* writer, const char* name, void* data, u64 size)
+{ return gj_pack_writer_add_stored(writer, name, data, size, GJPackCompression_None, size); }
+
+// NOTE: Compressed into scratch_arena temporarily, stored uncompressed when
+//       that doesn't make it smaller
+static b32
+gj_pack_writer_add_compressed(GJPackWriter* writer, const char* name, void* data, u64 size, MemoryArena* scratch_arena)
+{
+    BeginTemporaryMemoryBlock(scratch_arena);
+    u64 compressed_size;
+    void* compressed = gj_compress(scratch_arena, data, size, GJ_COMPRESS_DEFAULT_BLOCK_SIZE, &compressed_size);
+    b32 result = compressed_size && compressed_size < size
+        ? gj_pack_writer_add_stored(writer, name, compressed, compressed_size, GJPackCompression_LZ, size)
+        : gj_pack_writer_add_stored(writer, name, data, size, GJPackCompression_None, size);
+    EndTemporaryMemoryBlock(scratch_arena);
+    return result;
+}
+
+// NOTE: The file is read into scratch_arena temporarily
+static b32
+gj_pack_writer_add_file(GJPackWriter* writer, const char* name, const char* file_name, MemoryArena* scratch_arena,
+                        u32 compression = GJPackCompression_None)
+{
+    b32 result = gj_False;
+    PlatformFileHandle file_handle = writer->platform_api->get_file_handle(file_name, PlatformOpenFileModeFlags_Read);
+    if (file_handle.handle != PLATFORM_INVALID_FILE_HANDLE)
+    {
+        BeginTemporaryMemoryBlock(scratch_arena);
+        void* data = push_size(scratch_arena, file_handle.file_size);
+        writer->platform_api->read_data_from_file_handle(file_handle, 0, file_handle.file_size, data);
+        result = compression == GJPackCompression_LZ
+            ? gj_pack_writer_add_compressed(writer, name, data, file_handle.file_size, scratch_arena)
+            : gj_pack_writer_add(writer, name, data, file_handle.file_size);
+        EndTemporaryMemoryBlock(scratch_arena);
+        writer->platform_api->close_file_handle(file_handle);
+    }
+    else
+    {
+        writer->platform_api->log_error(__FILE__, __FUNCTION__, __LINE__, "Failed to open %s for packing", file_name);
+    }
+    return result;
+}
+
+static b32
+gj_pack_writer_end(GJPackWriter* writer)
+{
+    b32 result = writer->ok;
+    if (writer->file_handle.handle == PLATFORM_INVALID_FILE_HANDLE) return result;
+
+    if (result)
+    {
+        qsort(writer->entries, writer->entry_count, sizeof(GJPackEntry), gj_pack_compare_entries);
+
+        // NOTE: Duplicate or colliding names end up next to each other after the sort
+        for (u32 entry_index = 1; entry_index < writer->entry_count; entry_index++)
+        {
+            if (writer->entries[entry_index].name_hash == writer->entries[entry_index - 1].name_hash)
+            {
+                writer->platform_api->log_error(__FILE__, __FUNCTION__, __LINE__, "Duplicate or colliding pack name hash %llx",
+                                                (unsigned long long)writer->entries[entry_index].name_hash);
+                result = gj_False;
+                break;
+            }
+        }
+    }
+
+    if (result)
+    {
+        GJPackHeader header;
+        gj__ZeroStruct(header);
+        header.magic          = GJ_PACK_MAGIC;
+        header.version        = GJ_PACK_VERSION;
+        header.entry_count    = writer->entry_count;
+        header.data_alignment = GJ_PACK_DATA_ALIGNMENT;
+        // NOTE: An empty pack is just the header
+        header.toc_offset     = writer->entry_count > 0 ? writer->offset : sizeof(GJPackHeader);
+        header.file_size      = header.toc_offset + writer->entry_count * sizeof(GJPackEntry);
+
+        if (writer->entry_count > 0)
+        {
+            writer->platform_api->write_data_to_file_handle(writer->file_handle, header.toc_offset,
+                                                            writer->entry_count * sizeof(GJPackEntry), writer->entries);
+        }
+        writer->platform_api->write_data_to_file_handle(writer->file_handle, 0, sizeof(header), &header);
+    }
+
+    writer->platform_api->close_file_handle(writer->file_handle);
+    return result;
+}
+
+#endif
@@ -0,0 +1,357 @@
+#if !defined(GJ_SPATIAL_HASH_H)
+#define GJ_SPATIAL_HASH_H
+
+// Uniform grid over points, stored as a hash of the cell coordinates so the
+// grid has no bounds. Meant to be rebuilt every frame: a build hashes each
+// point's cell (V3f_to_V3i_floor(position / cell_size)) to a bucket and
+// counting sorts the points by bucket, so every bucket is one contiguous
+// range of items and positions. Queries visit the cells overlapping the
+// query and only touch those ranges.
+//
+// Cells that hash to the same bucket share its range, entries are checked
+// against the cell being visited so nothing is reported twice.
+//
+// The 2D build takes V2f positions and keeps z at 0, queries then ignore z.
+//
+//  GJSpatialHash hash;
+//  gj_spatial_hash_create(&hash, &arena, entity_max, 4.0f, 8);
+//  gj_spatial_hash_build(&hash, &entities[0].position, sizeof(Entity), entity_count, &platform_api, 8);
+//  u32 neighbors[64];
+//  u32 found = gj_spatial_hash_query_radius(&hash, position, 10.0f, neighbors, gj_ArrayCount(neighbors));
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+
+typedef struct GJSpatialHash
+{
+    f32  cell_size;
+    f32  inverse_cell_size;
+    // NOTE: Built from V2f, z is 0 everywhere
+    b32  planar;
+
+    u32  capacity;
+    u32  count;
+
+    // NOTE: Power of two >= capacity, bucket b is entries
+    //       [bucket_start[b], bucket_start[b + 1])
+    u32  bucket_count;
+    u32  bucket_shift;
+    u32* bucket_start;
+
+    // NOTE: Entries in bucket order, the source index and a copy of the
+    //       position so queries don't go back to the source array
+    u32* items;
+    V3f* positions;
+
+    // NOTE: Build scratch, the bucket of every point and one histogram per
+    //       thread
+    u32* buckets;
+    u32* counts;
+    u32  max_thread_count;
+} GJSpatialHash;
+
+// NOTE: Every build thread needs a bucket_count histogram, max_thread_count
+//       is the most a build will use
+static void
+gj_spatial_hash_create(GJSpatialHash* hash, MemoryArena* arena, u32 capacity, f32 cell_size, u32 max_thread_count = 1)
+{
+    gj_AssertDebug(cell_size > 0.0f);
+    max_thread_count = gj_Max(1, gj_Min(max_thread_count, GJ_MAX_THREADS));
+    u32 bucket_bits = 4;
+    while ((1u << bucket_bits) < capacity) bucket_bits++;
+
+    hash->cell_size         = cell_size;
+    hash->inverse_cell_size = 1.0f / cell_size;
+    hash->planar            = gj_False;
+    hash->capacity          = capacity;
+    hash->count             = 0;
+    hash->bucket_count      = 1u << bucket_bits;
+    hash->bucket_shift      = 32 - bucket_bits;
+    hash->bucket_start      = push_array(arena, u32, hash->bucket_count + 1);
+    hash->items             = push_array(arena, u32, capacity);
+    hash->positions         = push_array(arena, V3f, capacity);
+    hash->buckets           = push_array(arena, u32, capacity);
+    hash->counts            = push_array(arena, u32, (u64)hash->bucket_count * max_thread_count);
+    hash->max_thread_count  = max_thread_count;
+}
+
+inline V3i
+gj_spatial_hash_cell(GJSpatialHash* hash, V3f position)
+{
+    return V3f_to_V3i_floor(V3_mul(position, hash->inverse_cell_size));
+}
+
+// NOTE: Fibonacci hashing on top of the usual prime mix, the top bits are
+//       the bucket
+inline u32
+gj_spatial_hash_bucket(GJSpatialHash* hash, V3i cell)
+{
+    u32 h = ((u32)cell.x * 73856093u) ^ ((u32)cell.y * 19349663u) ^ ((u32)cell.z * 83492791u);
+    return (h * 2654435769u) >> hash->bucket_shift;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Build
+///////////////////////////////////////////////////////////////////////////
+typedef struct GJSpatialHashJob
+{
+    GJSpatialHash* hash;
+    byte*          src;
+    u64            stride;
+} GJSpatialHashJob;
+
+inline V3f
+gj__spatial_hash_load(GJSpatialHash* hash, byte* src)
+{
+    V3f result;
+    if (hash->planar) { V2f p = *(V2f*)src; result = {p.x, p.y, 0.0f}; }
+    else              result = *(V3f*)src;
+    return result;
+}
+
+static void
+gj__spatial_hash_count_range(void* data, u32 thread_index, u64 first, u64 count)
+{
+    GJSpatialHashJob* job = (GJSpatialHashJob*)data;
+    GJSpatialHash* hash = job->hash;
+    u32* counts = hash->counts + (u64)thread_index * hash->bucket_count;
+    memset(counts, 0, hash->bucket_count * sizeof(u32));
+    byte* src = job->src + first * job->stride;
+    for (u64 i = first; i < first + count; i++, src += job->stride)
+    {
+        u32 bucket = gj_spatial_hash_bucket(hash, gj_spatial_hash_cell(hash, gj__spatial_hash_load(hash, src)));
+        hash->buckets[i] = bucket;
+        counts[bucket]++;
+    }
+}
+
+// NOTE: The thread's counts hold its write cursor per bucket by now
+static void
+gj__spatial_hash_scatter_range(void* data, u32 thread_index, u64 first, u64 count)
+{
+    GJSpatialHashJob* job = (GJSpatialHashJob*)data;
+    GJSpatialHash* hash = job->hash;
+    u32* counts = hash->counts + (u64)thread_index * hash->bucket_count;
+    byte* src = job->src + first * job->stride;
+    for (u64 i = first; i < first + count; i++, src += job->stride)
+    {
+        u32 entry = counts[hash->buckets[i]]++;
+        hash->items[entry]     = (u32)i;
+        hash->positions[entry] = gj__spatial_hash_load(hash, src);
+    }
+}
+
+static void
+gj__spatial_hash_build(GJSpatialHash* hash, byte* src, u64 stride, u32 count, b32 planar,
+                       PlatformAPI* platform_api, u32 thread_count)
+{
+    gj_AssertDebug(count <= hash->capacity);
+    hash->count  = count;
+    hash->planar = planar;
+    // NOTE: Both passes get the same ranges, each thread scatters the points
+    //       it counted
+    thread_count = gj_parallel_thread_count(platform_api, gj_Min(thread_count, hash->max_thread_count), count, GJ_PARALLEL_MIN_RANGE);
+
+    GJSpatialHashJob job;
+    job.hash   = hash;
+    job.src    = src;
+    job.stride = stride;
+    gj_parallel_for(platform_api, thread_count, count, gj__spatial_hash_count_range, &job);
+
+    // NOTE: Exclusive prefix sum, bucket major and thread minor, so each
+    //       thread writes its points after the earlier threads' ones and the
+    //       result doesn't depend on the thread count
+    u32 total = 0;
+    for (u32 bucket = 0; bucket < hash->bucket_count; bucket++)
+    {
+        hash->bucket_start[bucket] = total;
+        for (u32 thread_index = 0; thread_index < thread_count; thread_index++)
+        {
+            u32* counts = hash->counts + (u64)thread_index * hash->bucket_count + bucket;
+            u32 bucket_count = *counts;
+            *counts = total;
+            total  += bucket_count;
+        }
+    }
+    hash->bucket_start[hash->bucket_count] = total;
+
+    gj_parallel_for(platform_api, thread_count, count, gj__spatial_hash_scatter_range, &job);
+}
+
+inline void
+gj_spatial_hash_build(GJSpatialHash* hash, V3f* positions, u64 stride, u32 count,
+                      PlatformAPI* platform_api = NULL, u32 thread_count = 1)
+{ gj__spatial_hash_build(hash, (byte*)positions, stride, count, gj_False, platform_api, thread_count); }
+
+inline void
+gj_spatial_hash_build(GJSpatialHash* hash, V2f* positions, u64 stride, u32 count,
+                      PlatformAPI* platform_api = NULL, u32 thread_count = 1)
+{ gj__spatial_hash_build(hash, (byte*)positions, stride, count, gj_True, platform_api, thread_count); }
+
+///////////////////////////////////////////////////////////////////////////
+// Queries
+///////////////////////////////////////////////////////////////////////////
+// NOTE: The queries write up to out_max source indices to out and return how
+//       many matched in total, a result above out_max means out was cut
+//       short.
+
+// NOTE: Every point in the cells [cell_min, cell_max] inclusive
+static u32
+gj_spatial_hash_query_cells(GJSpatialHash* hash, V3i cell_min, V3i cell_max, u32* out, u32 out_max)
+{
+    if (hash->planar) cell_min.z = cell_max.z = 0;
+    if (cell_min.x > cell_max.x || cell_min.y > cell_max.y || cell_min.z > cell_max.z) return 0;
+
+    u32 found = 0;
+    u64 cell_count = (u64)(cell_max.x - cell_min.x + 1) * (u64)(cell_max.y - cell_min.y + 1) * (u64)(cell_max.z - cell_min.z + 1);
+    if (cell_count >= hash->count)
+    {
+        // NOTE: More cells than points, a straight scan is cheaper
+        for (u32 entry = 0; entry < hash->count; entry++)
+        {
+            V3i cell = gj_spatial_hash_cell(hash, hash->positions[entry]);
+            if (cell.x < cell_min.x || cell.x > cell_max.x || cell.y < cell_min.y || cell.y > cell_max.y ||
+                cell.z < cell_min.z || cell.z > cell_max.z) continue;
+            if (found < out_max) out[found] = hash->items[entry];
+            found++;
+        }
+        return found;
+    }
+
+    for (s32 z = cell_min.z; z <= cell_max.z; z++)
+    {
+        for (s32 y = cell_min.y; y <= cell_max.y; y++)
+        {
+            for (s32 x = cell_min.x; x <= cell_max.x; x++)
+            {
+                V3i cell = {x, y, z};
+                u32 bucket = gj_spatial_hash_bucket(hash, cell);
+                for (u32 entry = hash->bucket_start[bucket]; entry < hash->bucket_start[bucket + 1]; entry++)
+                {
+                    V3i entry_cell = gj_spatial_hash_cell(hash, hash->positions[entry]);
+                    if (entry_cell.x != x || entry_cell.y != y || entry_cell.z != z) continue;
+                    if (found < out_max) out[found] = hash->items[entry];
+                    found++;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+inline u32
+gj_spatial_hash_query_cell(GJSpatialHash* hash, V3i cell, u32* out, u32 out_max)
+{
+    return gj_spatial_hash_query_cells(hash, cell, cell, out, out_max);
+}
+
+// NOTE: Points inside [min, max] inclusive
+static u32
+gj_spatial_hash_query_aabb(GJSpatialHash* hash, V3f min, V3f max, u32* out, u32 out_max)
+{
+    V3i cell_min = gj_spatial_hash_cell(hash, min);
+    V3i cell_max = gj_spatial_hash_cell(hash, max);
+    if (hash->planar)
+    {
+        cell_min.z = cell_max.z = 0;
+        min.z = max.z = 0.0f;
+    }
+    if (cell_min.x > cell_max.x || cell_min.y > cell_max.y || cell_min.z > cell_max.z) return 0;
+
+    u32 found = 0;
+    u64 cell_count = (u64)(cell_max.x - cell_min.x + 1) * (u64)(cell_max.y - cell_min.y + 1) * (u64)(cell_max.z - cell_min.z + 1);
+    if (cell_count >= hash->count)
+    {
+        for (u32 entry = 0; entry < hash->count; entry++)
+        {
+            V3f p = hash->positions[entry];
+            if (p.x < min.x || p.x > max.x || p.y < min.y || p.y > max.y || p.z < min.z || p.z > max.z) continue;
+            if (found < out_max) out[found] = hash->items[entry];
+            found++;
+        }
+        return found;
+    }
+
+    for (s32 z = cell_min.z; z <= cell_max.z; z++)
+    {
+        for (s32 y = cell_min.y; y <= cell_max.y; y++)
+        {
+            for (s32 x = cell_min.x; x <= cell_max.x; x++)
+            {
+                u32 bucket = gj_spatial_hash_bucket(hash, {x, y, z});
+                for (u32 entry = hash->bucket_start[bucket]; entry < hash->bucket_start[bucket + 1]; entry++)
+                {
+                    V3f p = hash->positions[entry];
+                    if (p.x < min.x || p.x > max.x || p.y < min.y || p.y > max.y || p.z < min.z || p.z > max.z) continue;
+                    // NOTE: Only from its own cell, the bucket can come up again for another cell
+                    V3i entry_cell = gj_spatial_hash_cell(hash, p);
+                    if (entry_cell.x != x || entry_cell.y != y || entry_cell.z != z) continue;
+                    if (found < out_max) out[found] = hash->items[entry];
+                    found++;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+// NOTE: Points with distance <= radius
+static u32
+gj_spatial_hash_query_radius(GJSpatialHash* hash, V3f center, f32 radius, u32* out, u32 out_max)
+{
+    if (hash->planar) center.z = 0.0f;
+    V3i cell_min = gj_spatial_hash_cell(hash, V3_add(center, -radius));
+    V3i cell_max = gj_spatial_hash_cell(hash, V3_add(center, radius));
+    if (hash->planar) cell_min.z = cell_max.z = 0;
+
+    u32 found = 0;
+    f32 radius_squared = radius * radius;
+    u64 cell_count = (u64)(cell_max.x - cell_min.x + 1) * (u64)(cell_max.y - cell_min.y + 1) * (u64)(cell_max.z - cell_min.z + 1);
+    if (cell_count >= hash->count)
+    {
+        for (u32 entry = 0; entry < hash->count; entry++)
+        {
+            V3f d = V3_sub(hash->positions[entry], center);
+            if (V3_dot(d, d) > radius_squared) continue;
+            if (found < out_max) out[found] = hash->items[entry];
+            found++;
+        }
+        return found;
+    }
+
+    for (s32 z = cell_min.z; z <= cell_max.z; z++)
+    {
+        for (s32 y = cell_min.y; y <= cell_max.y; y++)
+        {
+            for (s32 x = cell_min.x; x <= cell_max.x; x++)
+            {
+                u32 bucket = gj_spatial_hash_bucket(hash, {x, y, z});
+                for (u32 entry = hash->bucket_start[bucket]; entry < hash->bucket_start[bucket + 1]; entry++)
+                {
+                    V3f p = hash->positions[entry];
+                    V3f d = V3_sub(p, center);
+                    if (V3_dot(d, d) > radius_squared) continue;
+                    V3i entry_cell = gj_spatial_hash_cell(hash, p);
+                    if (entry_cell.x != x || entry_cell.y != y || entry_cell.z != z) continue;
+                    if (found < out_max) out[found] = hash->items[entry];
+                    found++;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+inline u32
+gj_spatial_hash_query_radius(GJSpatialHash* hash, V2f center, f32 radius, u32* out, u32 out_max)
+{
+    return gj_spatial_hash_query_radius(hash, V3f{center.x, center.y, 0.0f}, radius, out, out_max);
+}
+
+inline u32
+gj_spatial_hash_query_aabb(GJSpatialHash* hash, V2f min, V2f max, u32* out, u32 out_max)
+{
+    return gj_spatial_hash_query_aabb(hash, V3f{min.x, min.y, 0.0f}, V3f{max.x, max.y, 0.0f}, out, out_max);
+}
+
+#endif
@@ -0,0 +1,385 @@
+#if !defined(GJ_STREAM_H)
+#define GJ_STREAM_H
+
+// Streaming file reader. A background thread reads the file chunk by chunk
+// into a ring of buffers while the consumer works on the chunk it has, so
+// reading and parsing overlap and memory use doesn't depend on the file size.
+//
+//  GJStreamReader reader;
+//  gj_stream_reader_open(&reader, platform_api, &arena, "big.obj", Megabytes(1), 3);
+//  u8* chunk;
+//  u32 chunk_size;
+//  while (gj_stream_reader_next(&reader, &chunk, &chunk_size))
+//  {
+//      parse(chunk, chunk_size);
+//  }
+//  gj_stream_reader_close(&reader);
+//
+// Buffered writer. Appends go into large aligned buffers that a background
+// thread writes out, so many small writes become a few big ones and the
+// caller doesn't wait on the disk.
+//
+//  GJStreamWriter writer;
+//  gj_stream_writer_open(&writer, platform_api, &arena, "baked.bin", Megabytes(4), 3, gj_False);
+//  gj_stream_writer_write(&writer, &record, sizeof(record));
+//  gj_stream_writer_flush(&writer, gj_True); // NOTE: Everything so far is on disk
+//  gj_stream_writer_close(&writer);
+//
+// Readers and writers are shared with their thread, don't move them between
+// open and close.
+
+#include <gj/gj_base.h>
+
+#define GJ_STREAM_MAX_BUFFERS     8
+#define GJ_STREAM_BUFFER_ALIGNMENT PLATFORM_UNBUFFERED_ALIGNMENT
+
+///////////////////////////////////////////////////////////////////////////
+// Reader
+///////////////////////////////////////////////////////////////////////////
+struct GJStreamChunk
+{
+    u8* data;
+    u32 size;
+};
+
+struct GJStreamReader
+{
+    PlatformAPI*          platform_api;
+    PlatformFileHandle    file_handle;
+    u64                   file_size;
+
+    GJStreamChunk         chunks[GJ_STREAM_MAX_BUFFERS];
+    u32                   buffer_count;
+    u32                   buffer_size;
+
+    // NOTE: Counts of chunks ready for the consumer and buffers free for the thread
+    PlatformSemaphore     filled;
+    PlatformSemaphore     empty;
+    PlatformThreadContext thread;
+    b32 volatile          stop;
+
+    // NOTE: Consumer side
+    u32                   current;
+    b32                   holding_chunk;
+    b32                   done;
+    // NOTE: Unread part of the current chunk, for gj_stream_reader_read
+    u8*                   at;
+    u8*                   end;
+};
+
+static void
+gj_stream_reader_thread(void* param)
+{
+    GJStreamReader* reader = (GJStreamReader*)param;
+    PlatformAPI* platform_api = reader->platform_api;
+
+    u64 offset = 0;
+    for (u32 buffer_index = 0;; buffer_index = (buffer_index + 1) % reader->buffer_count)
+    {
+        platform_api->wait_for_semaphore(reader->empty);
+        if (reader->stop) break;
+
+        GJStreamChunk* chunk = &reader->chunks[buffer_index];
+        u64 remaining = reader->file_size - offset;
+        chunk->size = (u32)(remaining < reader->buffer_size ? remaining : reader->buffer_size);
+        if (chunk->size > 0)
+        {
+            platform_api->read_data_from_file_handle(reader->file_handle, offset, chunk->size, chunk->data);
+            offset += chunk->size;
+        }
+
+        platform_api->signal_semaphore(reader->filled);
+        // NOTE: An empty chunk marks the end of the file
+        if (chunk->size == 0) break;
+    }
+}
+
+// NOTE: buffer_count buffers of buffer_size bytes are pushed on arena, at
+//       least 2 so that one is being read while the other is consumed
+static b32
+gj_stream_reader_open(GJStreamReader* reader, PlatformAPI* platform_api, MemoryArena* arena,
+                      const char* file_name, u32 buffer_size, u32 buffer_count)
+{
+    gj__ZeroStruct(*reader);
+    gj_AssertDebug(buffer_count >= 2 && buffer_count <= GJ_STREAM_MAX_BUFFERS);
+    gj_AssertDebug(buffer_size > 0);
+
+    reader->platform_api = platform_api;
+    reader->file_handle  = platform_api->get_file_handle(file_name, PlatformOpenFileModeFlags_Read);
+    if (reader->file_handle.handle == PLATFORM_INVALID_FILE_HANDLE)
+    {
+        platform_api->log_error(__FILE__, __FUNCTION__, __LINE__, "Failed to open %s for streaming", file_name);
+        return gj_False;
+    }
+
+    reader->file_size    = reader->file_handle.file_size;
+    reader->buffer_count = buffer_count;
+    reader->buffer_size  = buffer_size;
+    for (u32 buffer_index = 0; buffer_index < buffer_count; buffer_index++)
+    {
+        reader->chunks[buffer_index].data = (u8*)_push(arena, buffer_size, GJ_STREAM_BUFFER_ALIGNMENT);
+    }
+
+    reader->filled = platform_api->new_semaphore(0, buffer_count);
+    reader->empty  = platform_api->new_semaphore(buffer_count, buffer_count + 1);
+
+    reader->thread.thread_func = gj_stream_reader_thread;
+    reader->thread.param       = reader;
+    platform_api->new_thread(platform_api, &reader->thread);
+
+    return gj_True;
+}
+
+// NOTE: Hands out the next chunk, which stays valid until the next call. The
+//       previous chunk goes back to the thread to be refilled. False at the
+//       end of the file.
+static b32
+gj_stream_reader_next(GJStreamReader* reader, u8** data, u32* size)
+{
+    if (reader->done) return gj_False;
+
+    PlatformAPI* platform_api = reader->platform_api;
+    if (reader->holding_chunk)
+    {
+        platform_api->signal_semaphore(reader->empty);
+        reader->current = (reader->current + 1) % reader->buffer_count;
+    }
+
+    platform_api->wait_for_semaphore(reader->filled);
+    reader->holding_chunk = gj_True;
+
+    GJStreamChunk* chunk = &reader->chunks[reader->current];
+    reader->at  = chunk->data;
+    reader->end = chunk->data + chunk->size;
+    if (data) *data = chunk->data;
+    if (size) *size = chunk->size;
+
+    reader->done = chunk->size == 0;
+    return !reader->done;
+}
+
+// NOTE: Copies the next size bytes into dst across chunk boundaries, returns
+//       how many were copied, less than size only at the end of the file
+static u64
+gj_stream_reader_read(GJStreamReader* reader, void* dst, u64 size)
+{
+    u64 result = 0;
+    while (result < size)
+    {
+        if (reader->at == reader->end && !gj_stream_reader_next(reader, NULL, NULL)) break;
+
+        u64 available = reader->end - reader->at;
+        u64 copy_size = size - result < available ? size - result : available;
+        memcpy((u8*)dst + result, reader->at, copy_size);
+        reader->at += copy_size;
+        result     += copy_size;
+    }
+    return result;
+}
+
+// NOTE: Fine to call before the end of the file
+static void
+gj_stream_reader_close(GJStreamReader* reader)
+{
+    PlatformAPI* platform_api = reader->platform_api;
+    if (reader->file_handle.handle == PLATFORM_INVALID_FILE_HANDLE) return;
+
+    // NOTE: Wakes the thread up if it's waiting for a free buffer, if it's
+    //       already past the end of the file this is never looked at
+    reader->stop = gj_True;
+    platform_api->signal_semaphore(reader->empty);
+    platform_api->wait_for_threads(platform_api, &reader->thread, 1);
+
+    platform_api->delete_semaphore(reader->filled);
+    platform_api->delete_semaphore(reader->empty);
+    platform_api->close_file_handle(reader->file_handle);
+    gj__ZeroStruct(*reader);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Writer
+///////////////////////////////////////////////////////////////////////////
+struct GJStreamWriter
+{
+    PlatformAPI*          platform_api;
+    PlatformFileHandle    file_handle;
+    b32                   unbuffered;
+
+    GJStreamChunk         chunks[GJ_STREAM_MAX_BUFFERS];
+    u64                   chunk_offsets[GJ_STREAM_MAX_BUFFERS];
+    u32                   buffer_count;
+    u32                   buffer_size;
+
+    // NOTE: Counts of chunks ready for the thread and buffers free for the producer
+    PlatformSemaphore     filled;
+    PlatformSemaphore     empty;
+    PlatformThreadContext thread;
+    b32 volatile          stop;
+
+    // NOTE: Producer side, the current buffer starts at offset in the file
+    u32                   current;
+    u64                   offset;
+};
+
+inline u64
+gj_stream_writer_write_size(GJStreamWriter* writer, u32 size)
+{
+    // NOTE: Unbuffered writes have to be whole sectors, the padding past the
+    //       end of the data is cut off with set_file_size
+    return writer->unbuffered ? (size + GJ_STREAM_BUFFER_ALIGNMENT - 1) & ~(u64)(GJ_STREAM_BUFFER_ALIGNMENT - 1) : size;
+}
+
+static void
+gj_stream_writer_thread(void* param)
+{
+    GJStreamWriter* writer = (GJStreamWriter*)param;
+    PlatformAPI* platform_api = writer->platform_api;
+
+    for (u32 buffer_index = 0;; buffer_index = (buffer_index + 1) % writer->buffer_count)
+    {
+        platform_api->wait_for_semaphore(writer->filled);
+        if (writer->stop) break;
+
+        GJStreamChunk* chunk = &writer->chunks[buffer_index];
+        platform_api->write_data_to_file_handle(writer->file_handle, writer->chunk_offsets[buffer_index],
+                                                gj_stream_writer_write_size(writer, chunk->size), chunk->data);
+        platform_api->signal_semaphore(writer->empty);
+    }
+}
+
+// NOTE: buffer_count buffers of buffer_size bytes are pushed on arena. With
+//       unbuffered the OS file cache is skipped, which is worth it for outputs
+//       much bigger than memory, buffer_size then has to be a multiple of
+//       GJ_STREAM_BUFFER_ALIGNMENT.
+static b32
+gj_stream_writer_open(GJStreamWriter* writer, PlatformAPI* platform_api, MemoryArena* arena,
+                      const char* file_name, u32 buffer_size, u32 buffer_count, b32 unbuffered)
+{
+    gj__ZeroStruct(*writer);
+    gj_AssertDebug(buffer_count >= 2 && buffer_count <= GJ_STREAM_MAX_BUFFERS);
+    gj_AssertDebug(buffer_size > 0);
+    gj_AssertDebug(!unbuffered || buffer_size % GJ_STREAM_BUFFER_ALIGNMENT == 0);
+
+    u8 mode_flags = PlatformOpenFileModeFlags_Write | PlatformOpenFileModeFlags_Overwrite;
+    if (unbuffered) mode_flags |= PlatformOpenFileModeFlags_Unbuffered;
+
+    writer->platform_api = platform_api;
+    writer->file_handle  = platform_api->get_file_handle(file_name, mode_flags);
+    if (writer->file_handle.handle == PLATFORM_INVALID_FILE_HANDLE)
+    {
+        platform_api->log_error(__FILE__, __FUNCTION__, __LINE__, "Failed to open %s for streaming", file_name);
+        return gj_False;
+    }
+
+    writer->unbuffered   = unbuffered;
+    writer->buffer_count = buffer_count;
+    writer->buffer_size  = buffer_size;
+    for (u32 buffer_index = 0; buffer_index < buffer_count; buffer_index++)
+    {
+        writer->chunks[buffer_index].data = (u8*)_push(arena, buffer_size, GJ_STREAM_BUFFER_ALIGNMENT);
+    }
+
+    writer->filled = platform_api->new_semaphore(0, buffer_count + 1);
+    writer->empty  = platform_api->new_semaphore(buffer_count, buffer_count);
+
+    writer->thread.thread_func = gj_stream_writer_thread;
+    writer->thread.param       = writer;
+    platform_api->new_thread(platform_api, &writer->thread);
+
+    // NOTE: The producer always owns the current buffer
+    platform_api->wait_for_semaphore(writer->empty);
+
+    return gj_True;
+}
+
+// NOTE: Hands the full current buffer to the thread and waits for a free one
+static void
+gj_stream_writer_submit(GJStreamWriter* writer)
+{
+    PlatformAPI* platform_api = writer->platform_api;
+    GJStreamChunk* chunk = &writer->chunks[writer->current];
+
+    writer->chunk_offsets[writer->current] = writer->offset;
+    writer->offset += chunk->size;
+    platform_api->signal_semaphore(writer->filled);
+
+    writer->current = (writer->current + 1) % writer->buffer_count;
+    platform_api->wait_for_semaphore(writer->empty);
+    writer->chunks[writer->current].size = 0;
+}
+
+static void
+gj_stream_writer_write(GJStreamWriter* writer, const void* data, u64 size)
+{
+    const u8* at = (const u8*)data;
+    while (size > 0)
+    {
+        GJStreamChunk* chunk = &writer->chunks[writer->current];
+        u64 space     = writer->buffer_size - chunk->size;
+        u64 copy_size = size < space ? size : space;
+        memcpy(chunk->data + chunk->size, at, copy_size);
+        chunk->size += (u32)copy_size;
+        at          += copy_size;
+        size        -= copy_size;
+
+        if (chunk->size == writer->buffer_size) gj_stream_writer_submit(writer);
+    }
+}
+
+inline u64
+gj_stream_writer_size(GJStreamWriter* writer) { return writer->offset + writer->chunks[writer->current].size; }
+
+// NOTE: Barrier, returns once everything written so far has reached the file.
+//       With sync it's also flushed to the disk (FlushFileBuffers, fdatasync).
+static b32
+gj_stream_writer_flush(GJStreamWriter* writer, b32 sync)
+{
+    PlatformAPI* platform_api = writer->platform_api;
+
+    // NOTE: Taking every buffer back means the thread has nothing in flight
+    for (u32 index = 1; index < writer->buffer_count; index++) platform_api->wait_for_semaphore(writer->empty);
+    for (u32 index = 1; index < writer->buffer_count; index++) platform_api->signal_semaphore(writer->empty);
+
+    b32 result = gj_True;
+    GJStreamChunk* chunk = &writer->chunks[writer->current];
+    if (chunk->size > 0)
+    {
+        platform_api->write_data_to_file_handle(writer->file_handle, writer->offset,
+                                                gj_stream_writer_write_size(writer, chunk->size), chunk->data);
+        if (writer->unbuffered)
+        {
+            // NOTE: Keep the partial buffer, it's written again at the same
+            //       offset once it fills up since unbuffered writes can't append
+            result = platform_api->set_file_size(writer->file_handle, writer->offset + chunk->size);
+        }
+        else
+        {
+            writer->offset += chunk->size;
+            chunk->size = 0;
+        }
+    }
+
+    if (sync) result = platform_api->flush_file_handle(writer->file_handle) && result;
+    return result;
+}
+
+static b32
+gj_stream_writer_close(GJStreamWriter* writer, b32 sync = gj_False)
+{
+    PlatformAPI* platform_api = writer->platform_api;
+    if (writer->file_handle.handle == PLATFORM_INVALID_FILE_HANDLE) return gj_False;
+
+    b32 result = gj_stream_writer_flush(writer, sync);
+
+    writer->stop = gj_True;
+    platform_api->signal_semaphore(writer->filled);
+    platform_api->wait_for_threads(platform_api, &writer->thread, 1);
+
+    platform_api->delete_semaphore(writer->filled);
+    platform_api->delete_semaphore(writer->empty);
+    platform_api->close_file_handle(writer->file_handle);
+    gj__ZeroStruct(*writer);
+    return result;
+}
+
+#endif
@@ -0,0 +1,250 @@
+#if !defined(GJ_TRANSFORM_HIERARCHY_H)
+#define GJ_TRANSFORM_HIERARCHY_H
+
+// Transform hierarchy. Nodes hold a local translation/rotation/scale and get
+// a world matrix = parent world * local. Every field is its own array and
+// nodes are stored parent before child, so one pass in index order always
+// sees a parent's world matrix before its children need it.
+//
+// Setting a TRS only flags the node, gj_transform_hierarchy_update then
+// rebuilds the local matrices of the flagged nodes (4 at a time with SSE)
+// and the world matrices of them and everything below them. A static scene
+// costs one scan of an empty bitset.
+//
+//  GJTransformHierarchy hierarchy;
+//  gj_transform_hierarchy_create(&hierarchy, &arena, 4096);
+//  u32 body  = gj_transform_add(&hierarchy, GJ_TRANSFORM_NO_PARENT, position, Quat_identity(), {1, 1, 1});
+//  u32 wheel = gj_transform_add(&hierarchy, body, offset, Quat_identity(), {1, 1, 1});
+//  gj_transform_set_rotation(&hierarchy, wheel, spin);
+//  gj_transform_hierarchy_update(&hierarchy);
+//  draw(gj_transform_world(&hierarchy, wheel));
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+
+#define GJ_TRANSFORM_NO_PARENT 0xFFFFFFFF
+
+typedef struct GJTransformHierarchy
+{
+    u32      count;
+    u32      capacity;
+
+    // NOTE: Local TRS, rotation is a Quat
+    V3f*     translation;
+    V4f*     rotation;
+    V3f*     scale;
+
+    u32*     parent;
+
+    M4x4*    local;
+    M4x4*    world;
+
+    // NOTE: local_dirty is set by the setters, world_dirty is local_dirty
+    //       spread down to the children during the update
+    GJBitset local_dirty;
+    GJBitset world_dirty;
+    // NOTE: Scratch for the update, capacity entries
+    u32*     update_indices;
+} GJTransformHierarchy;
+
+static void
+gj_transform_hierarchy_create(GJTransformHierarchy* hierarchy, MemoryArena* arena, u32 capacity)
+{
+    hierarchy->count          = 0;
+    hierarchy->capacity       = capacity;
+    hierarchy->translation    = push_array(arena, V3f,  capacity);
+    hierarchy->rotation       = push_array(arena, V4f,  capacity);
+    hierarchy->scale          = push_array(arena, V3f,  capacity);
+    hierarchy->parent         = push_array(arena, u32,  capacity);
+    hierarchy->local          = (M4x4*)_push(arena, capacity * sizeof(M4x4), 32);
+    hierarchy->world          = (M4x4*)_push(arena, capacity * sizeof(M4x4), 32);
+    hierarchy->local_dirty    = gj_bitset_create(arena, capacity);
+    hierarchy->world_dirty    = gj_bitset_create(arena, capacity);
+    hierarchy->update_indices = push_array(arena, u32,  capacity);
+}
+
+// NOTE: parent has to be added already (or GJ_TRANSFORM_NO_PARENT), which is
+//       what keeps the parent before child order
+static u32
+gj_transform_add(GJTransformHierarchy* hierarchy, u32 parent, V3f translation, V4f rotation, V3f scale)
+{
+    gj_AssertDebug(hierarchy->count < hierarchy->capacity);
+    gj_AssertDebug(parent == GJ_TRANSFORM_NO_PARENT || parent < hierarchy->count);
+    u32 node = hierarchy->count++;
+    hierarchy->translation[node] = translation;
+    hierarchy->rotation[node]    = rotation;
+    hierarchy->scale[node]       = scale;
+    hierarchy->parent[node]      = parent;
+    gj_bitset_set(&hierarchy->local_dirty, node);
+    return node;
+}
+
+inline void
+gj_transform_set_translation(GJTransformHierarchy* hierarchy, u32 node, V3f translation)
+{
+    gj_AssertDebug(node < hierarchy->count);
+    hierarchy->translation[node] = translation;
+    gj_bitset_set(&hierarchy->local_dirty, node);
+}
+
+inline void
+gj_transform_set_rotation(GJTransformHierarchy* hierarchy, u32 node, V4f rotation)
+{
+    gj_AssertDebug(node < hierarchy->count);
+    hierarchy->rotation[node] = rotation;
+    gj_bitset_set(&hierarchy->local_dirty, node);
+}
+
+inline void
+gj_transform_set_scale(GJTransformHierarchy* hierarchy, u32 node, V3f scale)
+{
+    gj_AssertDebug(node < hierarchy->count);
+    hierarchy->scale[node] = scale;
+    gj_bitset_set(&hierarchy->local_dirty, node);
+}
+
+inline void
+gj_transform_set_trs(GJTransformHierarchy* hierarchy, u32 node, V3f translation, V4f rotation, V3f scale)
+{
+    gj_AssertDebug(node < hierarchy->count);
+    hierarchy->translation[node] = translation;
+    hierarchy->rotation[node]    = rotation;
+    hierarchy->scale[node]       = scale;
+    gj_bitset_set(&hierarchy->local_dirty, node);
+}
+
+// NOTE: Valid after gj_transform_hierarchy_update
+inline M4x4*
+gj_transform_world(GJTransformHierarchy* hierarchy, u32 node)
+{
+    gj_AssertDebug(node < hierarchy->count);
+    return hierarchy->world + node;
+}
+
+// NOTE: T * R * S, the rotation part is Quat_to_rotation_matrix with its
+//       columns scaled. Same operations as the wide version below.
+static void
+gj_transform_trs_matrix(M4x4* result, V3f t, V4f q, V3f s)
+{
+    f32 _2xx = 2.0f * q.qx * q.qx;
+    f32 _2yy = 2.0f * q.qy * q.qy;
+    f32 _2zz = 2.0f * q.qz * q.qz;
+    f32 _2xy = 2.0f * q.qx * q.qy;
+    f32 _2xz = 2.0f * q.qx * q.qz;
+    f32 _2yz = 2.0f * q.qy * q.qz;
+    f32 _2wx = 2.0f * q.qw * q.qx;
+    f32 _2wz = 2.0f * q.qw * q.qz;
+    f32 _2wy = 2.0f * q.qw * q.qy;
+    M4x4 m = {
+        (1.0f - _2yy - _2zz) * s.x, (_2xy - _2wz) * s.y,        (_2xz + _2wy) * s.z,        t.x,
+        (_2xy + _2wz) * s.x,        (1.0f - _2xx - _2zz) * s.y, (_2yz - _2wx) * s.z,        t.y,
+        (_2xz - _2wy) * s.x,        (_2yz + _2wx) * s.y,        (1.0f - _2xx - _2yy) * s.z, t.z,
+        0.0f,                       0.0f,                       0.0f,                       1.0f
+    };
+    *result = m;
+}
+
+// NOTE: 4 nodes at once, TRS transposed in, matrix rows transposed out
+static void
+gj__transform_trs_matrix_x4(GJTransformHierarchy* hierarchy, u32* nodes)
+{
+    __m128 qw = _mm_loadu_ps(hierarchy->rotation[nodes[0]].array);
+    __m128 qx = _mm_loadu_ps(hierarchy->rotation[nodes[1]].array);
+    __m128 qy = _mm_loadu_ps(hierarchy->rotation[nodes[2]].array);
+    __m128 qz = _mm_loadu_ps(hierarchy->rotation[nodes[3]].array);
+    _MM_TRANSPOSE4_PS(qw, qx, qy, qz);
+
+    __m128 tx = M4x4__load_V3f((byte*)(hierarchy->translation + nodes[0]));
+    __m128 ty = M4x4__load_V3f((byte*)(hierarchy->translation + nodes[1]));
+    __m128 tz = M4x4__load_V3f((byte*)(hierarchy->translation + nodes[2]));
+    __m128 tw = M4x4__load_V3f((byte*)(hierarchy->translation + nodes[3]));
+    _MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+
+    __m128 sx = M4x4__load_V3f((byte*)(hierarchy->scale + nodes[0]));
+    __m128 sy = M4x4__load_V3f((byte*)(hierarchy->scale + nodes[1]));
+    __m128 sz = M4x4__load_V3f((byte*)(hierarchy->scale + nodes[2]));
+    __m128 sw = M4x4__load_V3f((byte*)(hierarchy->scale + nodes[3]));
+    _MM_TRANSPOSE4_PS(sx, sy, sz, sw);
+
+    __m128 two = _mm_set1_ps(2.0f);
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 _2xx = _mm_mul_ps(_mm_mul_ps(two, qx), qx);
+    __m128 _2yy = _mm_mul_ps(_mm_mul_ps(two, qy), qy);
+    __m128 _2zz = _mm_mul_ps(_mm_mul_ps(two, qz), qz);
+    __m128 _2xy = _mm_mul_ps(_mm_mul_ps(two, qx), qy);
+    __m128 _2xz = _mm_mul_ps(_mm_mul_ps(two, qx), qz);
+    __m128 _2yz = _mm_mul_ps(_mm_mul_ps(two, qy), qz);
+    __m128 _2wx = _mm_mul_ps(_mm_mul_ps(two, qw), qx);
+    __m128 _2wz = _mm_mul_ps(_mm_mul_ps(two, qw), qz);
+    __m128 _2wy = _mm_mul_ps(_mm_mul_ps(two, qw), qy);
+
+    __m128 rows[3][4];
+    rows[0][0] = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, _2yy), _2zz), sx);
+    rows[0][1] = _mm_mul_ps(_mm_sub_ps(_2xy, _2wz), sy);
+    rows[0][2] = _mm_mul_ps(_mm_add_ps(_2xz, _2wy), sz);
+    rows[0][3] = tx;
+    rows[1][0] = _mm_mul_ps(_mm_add_ps(_2xy, _2wz), sx);
+    rows[1][1] = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, _2xx), _2zz), sy);
+    rows[1][2] = _mm_mul_ps(_mm_sub_ps(_2yz, _2wx), sz);
+    rows[1][3] = ty;
+    rows[2][0] = _mm_mul_ps(_mm_sub_ps(_2xz, _2wy), sx);
+    rows[2][1] = _mm_mul_ps(_mm_add_ps(_2yz, _2wx), sy);
+    rows[2][2] = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, _2xx), _2yy), sz);
+    rows[2][3] = tz;
+
+    __m128 last_row = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    for (u32 row = 0; row < 3; row++)
+    {
+        _MM_TRANSPOSE4_PS(rows[row][0], rows[row][1], rows[row][2], rows[row][3]);
+        for (u32 i = 0; i < 4; i++) _mm_storeu_ps(hierarchy->local[nodes[i]].a + 4 * row, rows[row][i]);
+    }
+    for (u32 i = 0; i < 4; i++) _mm_storeu_ps(hierarchy->local[nodes[i]].a + 12, last_row);
+}
+
+// NOTE: Returns how many world matrices were recomputed
+static u32
+gj_transform_hierarchy_update(GJTransformHierarchy* hierarchy)
+{
+    GJBitset* local_dirty = &hierarchy->local_dirty;
+    GJBitset* world_dirty = &hierarchy->world_dirty;
+    if (!gj_bitset_any(local_dirty)) return 0;
+
+    // NOTE: Local matrices of the changed nodes
+    u32* indices = hierarchy->update_indices;
+    u32 local_count = gj_bitset_to_indices(local_dirty, indices);
+    u32 i = 0;
+    for (; i + 4 <= local_count; i += 4) gj__transform_trs_matrix_x4(hierarchy, indices + i);
+    for (; i < local_count; i++)
+    {
+        u32 node = indices[i];
+        gj_transform_trs_matrix(hierarchy->local + node, hierarchy->translation[node], hierarchy->rotation[node], hierarchy->scale[node]);
+    }
+
+    // NOTE: Spread down in one pass from the first changed node, parents come
+    //       first so their bit is final when a child reads it. This is a
+    //       linear walk over parent with lookups into a small bitset, walking
+    //       child lists instead was slower from all the random jumps.
+    memcpy(world_dirty->words, local_dirty->words, world_dirty->word_count * sizeof(u64));
+    u32* parents = hierarchy->parent;
+    for (u32 node = gj_bitset_next(world_dirty, 0) + 1; node < hierarchy->count; node++)
+    {
+        u32 parent = parents[node];
+        if (parent != GJ_TRANSFORM_NO_PARENT && gj_bitset_get(world_dirty, parent)) gj_bitset_set(world_dirty, node);
+    }
+
+    // NOTE: In index order, parents are done before their children
+    u32 world_count = gj_bitset_to_indices(world_dirty, indices);
+    for (i = 0; i < world_count; i++)
+    {
+        u32 node   = indices[i];
+        u32 parent = hierarchy->parent[node];
+        if (parent == GJ_TRANSFORM_NO_PARENT) hierarchy->world[node] = hierarchy->local[node];
+        else                                  M4x4_mul(hierarchy->world + node, hierarchy->world + parent, hierarchy->local + node);
+    }
+
+    gj_bitset_clear_all(local_dirty);
+    gj_bitset_clear_all(world_dirty);
+    return world_count;
+}
+
+#endif
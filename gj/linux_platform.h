@@ -0,0 +1,1228 @@
+#if !defined(LINUX_PLATFORM_H)
+#define LINUX_PLATFORM_H
+
+#include <gj/gj_base.h> // PlatformAPI
+
+// NOTE: unistd.h declares brk() which collides with the debug brk macro
+#pragma push_macro("brk")
+#undef brk
+#include <fcntl.h>
+#include <unistd.h>
+#include <fnmatch.h>
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <sys/inotify.h>
+#pragma pop_macro("brk")
+
+///////////////////////////////////////////////////////////////////////////
+// OS API
+///////////////////////////////////////////////////////////////////////////
+void* linux_allocate_memory(size_t size);
+void  linux_deallocate_memory(void* memory);
+void  linux_log_error(const char* file, const char* function, s32 line, const char* format, ...);
+void  linux_log_info(const char* file, const char* function, s32 line, const char* format, ...);
+void  linux_begin_ticket_mutex(TicketMutex* ticket_mutex);
+void  linux_end_ticket_mutex(TicketMutex* ticket_mutex);
+
+// NOTE: PlatformFileHandle::handle stores fd + 1 so that fd 0 does not
+//       collide with PLATFORM_INVALID_FILE_HANDLE
+inline int   linux_fd_from_handle(void* handle) { return (int)((intptr_t)handle - 1); }
+inline void* linux_handle_from_fd(int fd)       { return (void*)((intptr_t)fd + 1); }
+
+PlatformFileHandle linux_get_file_handle(const char* file_name, u8 mode_flags)
+{
+    PlatformFileHandle result;
+    gj__ZeroStruct(result);
+
+    gj_AssertDebug((mode_flags & PlatformOpenFileModeFlags_Read) || (mode_flags & PlatformOpenFileModeFlags_Write));
+
+    int open_flags = O_CLOEXEC;
+    if ((mode_flags & PlatformOpenFileModeFlags_Read) && (mode_flags & PlatformOpenFileModeFlags_Write))
+    {
+        open_flags |= O_RDWR | O_CREAT;
+    }
+    else if (mode_flags & PlatformOpenFileModeFlags_Write)
+    {
+        open_flags |= O_WRONLY | O_CREAT;
+    }
+    else
+    {
+        open_flags |= O_RDONLY;
+    }
+    if ((mode_flags & PlatformOpenFileModeFlags_Write) && (mode_flags & PlatformOpenFileModeFlags_Overwrite))
+    {
+        open_flags |= O_TRUNC;
+    }
+
+    int fd = -1;
+#if defined(O_DIRECT)
+    if (mode_flags & PlatformOpenFileModeFlags_Unbuffered)
+    {
+        fd = open(file_name, open_flags | O_DIRECT, 0644);
+    }
+    // NOTE: tmpfs and some others refuse O_DIRECT with EINVAL
+    if (fd < 0)
+#endif
+    {
+        fd = open(file_name, open_flags, 0644);
+    }
+    struct stat file_stat;
+    if (fd >= 0 && (fstat(fd, &file_stat) != 0 || S_ISDIR(file_stat.st_mode)))
+    {
+        // NOTE: Same as CreateFile, directories can't be opened as files
+        close(fd);
+        fd = -1;
+    }
+
+    if (fd < 0)
+    {
+        result.handle = PLATFORM_INVALID_FILE_HANDLE;
+    }
+    else
+    {
+        result.handle = linux_handle_from_fd(fd);
+
+        char buffer[PATH_MAX];
+        const char* full_file_name = realpath(file_name, buffer) ? buffer : file_name;
+        size_t file_name_size = strlen(full_file_name);
+        result.full_file_name = (char*)linux_allocate_memory(file_name_size + 1);
+        memcpy(result.full_file_name, full_file_name, file_name_size + 1);
+
+        result.file_size = (u64)file_stat.st_size;
+    }
+
+    return result;
+}
+
+void linux_read_data_from_file_handle(PlatformFileHandle file_handle, u64 offset, u64 size, void* dst)
+{
+    int fd = linux_fd_from_handle(file_handle.handle);
+
+    u64 bytes_read = 0;
+    while (bytes_read < size)
+    {
+        ssize_t read_result = pread(fd, (u8*)dst + bytes_read, size - bytes_read, offset + bytes_read);
+        if (read_result < 0 && errno == EINTR) continue;
+        if (read_result <= 0) break;
+        bytes_read += read_result;
+    }
+    gj_AssertDebug(bytes_read == size);
+}
+
+void linux_write_data_to_file_handle(PlatformFileHandle file_handle, u64 offset, size_t size, void* src)
+{
+    int fd = linux_fd_from_handle(file_handle.handle);
+
+    size_t bytes_written = 0;
+    while (bytes_written < size)
+    {
+        ssize_t write_result = pwrite(fd, (u8*)src + bytes_written, size - bytes_written, offset + bytes_written);
+        if (write_result < 0 && errno == EINTR) continue;
+        if (write_result <= 0) break;
+        bytes_written += write_result;
+    }
+    gj_AssertDebug(bytes_written == size);
+}
+
+void linux_close_file_handle(PlatformFileHandle file_handle)
+{
+    gj_OnlyDebug(int ok = )close(linux_fd_from_handle(file_handle.handle));
+    gj_AssertDebug(ok == 0);
+    linux_deallocate_memory(file_handle.full_file_name);
+}
+
+b32 linux_flush_file_handle(PlatformFileHandle file_handle)
+{
+    return fdatasync(linux_fd_from_handle(file_handle.handle)) == 0;
+}
+
+b32 linux_set_file_size(PlatformFileHandle file_handle, u64 size)
+{
+    return ftruncate(linux_fd_from_handle(file_handle.handle), (off_t)size) == 0;
+}
+
+u32 linux_read_whole_file(const char* file_name, void* dst)
+{
+    u32 result = 0;
+    PlatformFileHandle file_handle = linux_get_file_handle(file_name, PlatformOpenFileModeFlags_Read);
+    if (file_handle.handle != NULL)
+    {
+        result = gj_safe_cast_u64_to_u32(file_handle.file_size);
+        linux_read_data_from_file_handle(file_handle, 0, file_handle.file_size, dst);
+        linux_close_file_handle(file_handle);
+    }
+    else
+    {
+        linux_log_error(__FILE__, __FUNCTION__, __LINE__, "linux_read_whole_file failed to read %s", file_name);
+    }
+    return result;
+}
+
+PlatformMappedFile linux_map_file(const char* file_name)
+{
+    PlatformMappedFile result;
+    gj__ZeroStruct(result);
+
+    int fd = open(file_name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        linux_log_error(__FILE__, __FUNCTION__, __LINE__, "linux_map_file failed to open %s", file_name);
+        return result;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+    {
+        // NOTE: The mapping keeps the file alive so the fd can be closed here
+        void* memory = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (memory != MAP_FAILED)
+        {
+            result.memory = memory;
+            result.size   = file_stat.st_size;
+        }
+    }
+    close(fd);
+
+    return result;
+}
+
+void linux_unmap_file(PlatformMappedFile mapped_file)
+{
+    if (mapped_file.memory)
+    {
+        gj_OnlyDebug(int ok = )munmap(mapped_file.memory, mapped_file.size);
+        gj_AssertDebug(ok == 0);
+    }
+}
+
+PlatformFileListing* linux_list_files(void* memory, size_t memory_max_size, const char* file_name_pattern)
+{
+    PlatformFileListing* result = 0;
+
+    MemoryArena memory_arena;
+    initialize_arena(&memory_arena, memory_max_size, (u8*)memory);
+
+    // NOTE: Split "dir/pattern" into the directory to open and the pattern
+    //       to match against, same as FindFirstFile the result is file names only
+    char directory[PATH_MAX] = ".";
+    const char* pattern = strrchr(file_name_pattern, '/');
+    if (pattern)
+    {
+        size_t directory_length = pattern - file_name_pattern;
+        if (directory_length == 0) directory_length = 1;
+        gj_AssertDebug(directory_length < sizeof(directory));
+        memcpy(directory, file_name_pattern, directory_length);
+        directory[directory_length] = '\0';
+        pattern++;
+    }
+    else
+    {
+        pattern = file_name_pattern;
+    }
+
+    DIR* dir = opendir(directory);
+    if (dir)
+    {
+        PlatformFileListing* current = 0;
+        struct dirent* dir_entry;
+        while ((dir_entry = readdir(dir)) != NULL)
+        {
+            if (fnmatch(pattern, dir_entry->d_name, FNM_PERIOD) != 0) continue;
+
+            PlatformFileListing* next = push_struct(&memory_arena, PlatformFileListing);
+            size_t file_name_size = strlen(dir_entry->d_name) + 1;
+            next->file_name = (char*)push_array(&memory_arena, char, file_name_size);
+            memcpy(next->file_name, dir_entry->d_name, file_name_size);
+
+            if (current) current->next = next;
+            else         result        = next;
+            current = next;
+        }
+        closedir(dir);
+    }
+
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Directory walk
+///////////////////////////////////////////////////////////////////////////
+// NOTE: Layout of the records returned by the getdents64 syscall
+struct LinuxDirent64
+{
+    u64  d_ino;
+    s64  d_off;
+    u16  d_reclen;
+    u8   d_type;
+    char d_name[1];
+};
+
+#define LINUX_WALK_DIRECTORY_STAT_ENTRIES_PER_THREAD 256
+#define LINUX_WALK_DIRECTORY_MAX_STAT_THREADS        16
+
+typedef struct LinuxWalkDirectoryStatJob
+{
+    PlatformDirectoryListing* listing;
+    int root_fd;
+    u32 entry_begin;
+    u32 entry_end;
+} LinuxWalkDirectoryStatJob;
+
+static void*
+linux_walk_directory_stat_entries(void* param)
+{
+    LinuxWalkDirectoryStatJob* job = (LinuxWalkDirectoryStatJob*)param;
+    for (u32 entry_index = job->entry_begin; entry_index < job->entry_end; entry_index++)
+    {
+        PlatformDirectoryEntry* entry = &job->listing->entries[entry_index];
+        struct statx stx;
+        if (statx(job->root_fd, job->listing->names + entry->name_offset,
+                  AT_STATX_DONT_SYNC, STATX_SIZE | STATX_MTIME, &stx) == 0)
+        {
+            entry->size            = stx.stx_size;
+            entry->last_write_time = (u64)stx.stx_mtime.tv_sec * 1000000000ull + stx.stx_mtime.tv_nsec;
+        }
+    }
+    return NULL;
+}
+
+// NOTE: Names are read with getdents64 into a large buffer (d_type tells
+//       directories apart without a stat), sizes and write times are then
+//       fetched with statx split over a few threads since that is where the
+//       time goes on large trees.
+PlatformDirectoryListing linux_walk_directory(void* memory, size_t memory_max_size, const char* directory, b32 recursive)
+{
+    PlatformDirectoryListingBuilder builder;
+    platform_directory_listing_begin(&builder, memory, memory_max_size);
+
+    int root_fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (root_fd < 0)
+    {
+        linux_log_error(__FILE__, __FUNCTION__, __LINE__, "linux_walk_directory failed to open %s", directory);
+        return platform_directory_listing_end(&builder);
+    }
+
+    // NOTE: u64 so the linux_dirent64 records in it are 8 byte aligned
+    u64 dirent_buffer[Kilobytes(32) / sizeof(u64)];
+
+    // NOTE: parent_index -1 is the walked directory itself, recursing appends
+    //       subdirectories to the listing which are then visited in order.
+    for (s64 parent_index = -1;
+         parent_index < (s64)builder.listing.entry_count && !builder.listing.out_of_memory;
+         parent_index++)
+    {
+        char* parent        = NULL;
+        u32   parent_length = 0;
+        int   dir_fd        = root_fd;
+        if (parent_index >= 0)
+        {
+            if (!recursive) break;
+            if (!builder.listing.entries[parent_index].is_directory) continue;
+            parent        = platform_directory_listing_get_name(&builder, (u32)parent_index);
+            parent_length = builder.listing.entries[parent_index].name_length;
+            dir_fd        = openat(root_fd, parent, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (dir_fd < 0) continue;
+        }
+
+        for (;;)
+        {
+            long bytes_read = syscall(SYS_getdents64, dir_fd, dirent_buffer, sizeof(dirent_buffer));
+            if (bytes_read <= 0) break;
+
+            for (long offset = 0; offset < bytes_read;)
+            {
+                LinuxDirent64* dir_entry = (LinuxDirent64*)((u8*)dirent_buffer + offset);
+                offset += dir_entry->d_reclen;
+
+                char* name = dir_entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+                PlatformDirectoryEntry* entry = platform_directory_listing_push(&builder, parent, parent_length,
+                                                                                name, (u32)strlen(name));
+                if (!entry) break;
+
+                if (dir_entry->d_type == DT_UNKNOWN)
+                {
+                    struct stat file_stat;
+                    entry->is_directory = (fstatat(dir_fd, name, &file_stat, AT_SYMLINK_NOFOLLOW) == 0 &&
+                                           S_ISDIR(file_stat.st_mode));
+                }
+                else
+                {
+                    entry->is_directory = dir_entry->d_type == DT_DIR;
+                }
+            }
+            if (builder.listing.out_of_memory) break;
+        }
+
+        if (dir_fd != root_fd) close(dir_fd);
+    }
+
+    PlatformDirectoryListing result = platform_directory_listing_end(&builder);
+
+    u32 thread_count = (result.entry_count + LINUX_WALK_DIRECTORY_STAT_ENTRIES_PER_THREAD - 1) / LINUX_WALK_DIRECTORY_STAT_ENTRIES_PER_THREAD;
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu_count > 0 && thread_count > (u32)cpu_count)          thread_count = (u32)cpu_count;
+    if (thread_count > LINUX_WALK_DIRECTORY_MAX_STAT_THREADS)     thread_count = LINUX_WALK_DIRECTORY_MAX_STAT_THREADS;
+    if (thread_count == 0)                                        thread_count = 1;
+
+    LinuxWalkDirectoryStatJob jobs[LINUX_WALK_DIRECTORY_MAX_STAT_THREADS];
+    pthread_t threads[LINUX_WALK_DIRECTORY_MAX_STAT_THREADS];
+    b32 thread_started[LINUX_WALK_DIRECTORY_MAX_STAT_THREADS] = {};
+    u32 entries_per_thread = (result.entry_count + thread_count - 1) / thread_count;
+    for (u32 thread_index = 0; thread_index < thread_count; thread_index++)
+    {
+        LinuxWalkDirectoryStatJob* job = &jobs[thread_index];
+        job->listing     = &result;
+        job->root_fd     = root_fd;
+        job->entry_begin = thread_index * entries_per_thread;
+        job->entry_end   = job->entry_begin + entries_per_thread;
+        if (job->entry_begin > result.entry_count) job->entry_begin = result.entry_count;
+        if (job->entry_end   > result.entry_count) job->entry_end   = result.entry_count;
+        // NOTE: The calling thread takes the first range itself
+        if (thread_index > 0)
+        {
+            thread_started[thread_index] = pthread_create(&threads[thread_index], NULL, linux_walk_directory_stat_entries, job) == 0;
+            if (!thread_started[thread_index]) linux_walk_directory_stat_entries(job);
+        }
+    }
+    linux_walk_directory_stat_entries(&jobs[0]);
+    for (u32 thread_index = 1; thread_index < thread_count; thread_index++)
+    {
+        if (thread_started[thread_index]) pthread_join(threads[thread_index], NULL);
+    }
+
+    close(root_fd);
+
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// File watch
+///////////////////////////////////////////////////////////////////////////
+#define LINUX_FILE_WATCH_MAX_DIRECTORIES 4096
+// NOTE: IN_CLOSE_WRITE instead of IN_MODIFY so that a change is reported once
+//       the writer is done with the file instead of on every write
+#define LINUX_FILE_WATCH_MASK (IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+
+// NOTE: One per inotify watch descriptor, a recursive watch adds one for every
+//       subdirectory and they all share the watch_id
+typedef struct LinuxFileWatchDirectory
+{
+    u32   watch_id;
+    int   wd;
+    b32   recursive;
+    char* path;
+    // NOTE: Path relative to the watched directory, "" for the directory itself
+    char* prefix;
+    // NOTE: Only report changes to this name, NULL to report everything
+    char* file_name;
+} LinuxFileWatchDirectory;
+
+typedef struct LinuxFileWatcher
+{
+    int inotify_fd;
+    u32 next_watch_id;
+    LinuxFileWatchDirectory directories[LINUX_FILE_WATCH_MAX_DIRECTORIES];
+    u32 directory_count;
+    PlatformFileChangeQueue queue;
+} LinuxFileWatcher;
+
+global_variable LinuxFileWatcher g_linux_file_watcher;
+
+static char*
+linux_copy_string(const char* s, size_t length)
+{
+    char* result = (char*)linux_allocate_memory(length + 1);
+    memcpy(result, s, length);
+    result[length] = '\0';
+    return result;
+}
+
+static void
+linux_file_watch_free_directory(LinuxFileWatchDirectory* directory)
+{
+    linux_deallocate_memory(directory->path);
+    linux_deallocate_memory(directory->prefix);
+    linux_deallocate_memory(directory->file_name);
+}
+
+// NOTE: report_existing is set for directories created after the watch was
+//       added, files can be written into them before the inotify watch exists
+static b32
+linux_file_watch_add_directory(u32 watch_id, const char* path, const char* prefix, const char* file_name,
+                               b32 recursive, b32 report_existing)
+{
+    LinuxFileWatcher* watcher = &g_linux_file_watcher;
+    if (watcher->directory_count == LINUX_FILE_WATCH_MAX_DIRECTORIES)
+    {
+        linux_log_error(__FILE__, __FUNCTION__, __LINE__, "Too many watched directories, skipping %s", path);
+        return gj_False;
+    }
+
+    int wd = inotify_add_watch(watcher->inotify_fd, path, LINUX_FILE_WATCH_MASK);
+    if (wd < 0) return gj_False;
+
+    LinuxFileWatchDirectory* directory = &watcher->directories[watcher->directory_count++];
+    directory->watch_id  = watch_id;
+    directory->wd        = wd;
+    directory->recursive = recursive;
+    directory->path      = linux_copy_string(path, strlen(path));
+    directory->prefix    = linux_copy_string(prefix, strlen(prefix));
+    directory->file_name = file_name ? linux_copy_string(file_name, strlen(file_name)) : NULL;
+
+    if (recursive)
+    {
+        DIR* dir = opendir(path);
+        if (dir)
+        {
+            struct dirent* dir_entry;
+            while ((dir_entry = readdir(dir)) != NULL)
+            {
+                char* name = dir_entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+                char child_path[PATH_MAX];
+                char child_prefix[PATH_MAX];
+                stbsp_snprintf(child_path, sizeof(child_path), "%s/%s", path, name);
+                stbsp_snprintf(child_prefix, sizeof(child_prefix), prefix[0] ? "%s/%s" : "%s%s", prefix, name);
+
+                b32 is_directory = dir_entry->d_type == DT_DIR;
+                if (dir_entry->d_type == DT_UNKNOWN)
+                {
+                    struct stat file_stat;
+                    is_directory = lstat(child_path, &file_stat) == 0 && S_ISDIR(file_stat.st_mode);
+                }
+                if (report_existing)
+                {
+                    platform_file_change_queue_push(&watcher->queue, watch_id, PlatformFileChangeFlags_Created,
+                                                    prefix, (u32)strlen(prefix), name, (u32)strlen(name));
+                }
+                if (is_directory) linux_file_watch_add_directory(watch_id, child_path, child_prefix, NULL, gj_True, report_existing);
+            }
+            closedir(dir);
+        }
+    }
+
+    return gj_True;
+}
+
+u32 linux_add_file_watch(const char* path, b32 recursive)
+{
+    u32 result = 0;
+    LinuxFileWatcher* watcher = &g_linux_file_watcher;
+
+    if (watcher->next_watch_id == 0)
+    {
+        watcher->inotify_fd    = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        watcher->next_watch_id = 1;
+    }
+    if (watcher->inotify_fd < 0) return result;
+
+    struct stat file_stat;
+    if (stat(path, &file_stat) != 0)
+    {
+        linux_log_error(__FILE__, __FUNCTION__, __LINE__, "Can't watch %s, it does not exist", path);
+        return result;
+    }
+
+    u32 watch_id = watcher->next_watch_id;
+    b32 ok;
+    if (S_ISDIR(file_stat.st_mode))
+    {
+        ok = linux_file_watch_add_directory(watch_id, path, "", NULL, recursive, gj_False);
+    }
+    else
+    {
+        char directory[PATH_MAX] = ".";
+        const char* file_name = strrchr(path, '/');
+        if (file_name)
+        {
+            size_t directory_length = file_name - path;
+            if (directory_length == 0) directory_length = 1;
+            memcpy(directory, path, directory_length);
+            directory[directory_length] = '\0';
+            file_name++;
+        }
+        else
+        {
+            file_name = path;
+        }
+        ok = linux_file_watch_add_directory(watch_id, directory, "", file_name, gj_False, gj_False);
+    }
+
+    if (ok)
+    {
+        result = watch_id;
+        watcher->next_watch_id++;
+    }
+    return result;
+}
+
+static void
+linux_file_watch_remove_directory(u32 directory_index, b32 remove_wd)
+{
+    LinuxFileWatcher* watcher = &g_linux_file_watcher;
+    LinuxFileWatchDirectory* directory = &watcher->directories[directory_index];
+
+    if (remove_wd)
+    {
+        // NOTE: inotify hands out the same wd when a directory is watched twice
+        b32 wd_shared = gj_False;
+        for (u32 other_index = 0; other_index < watcher->directory_count; other_index++)
+        {
+            if (other_index != directory_index && watcher->directories[other_index].wd == directory->wd) wd_shared = gj_True;
+        }
+        if (!wd_shared) inotify_rm_watch(watcher->inotify_fd, directory->wd);
+    }
+
+    linux_file_watch_free_directory(directory);
+    *directory = watcher->directories[--watcher->directory_count];
+}
+
+void linux_remove_file_watch(u32 watch_id)
+{
+    LinuxFileWatcher* watcher = &g_linux_file_watcher;
+    for (u32 directory_index = 0; directory_index < watcher->directory_count;)
+    {
+        if (watcher->directories[directory_index].watch_id == watch_id)
+        {
+            linux_file_watch_remove_directory(directory_index, gj_True);
+        }
+        else
+        {
+            directory_index++;
+        }
+    }
+}
+
+static u32
+linux_file_change_flags(u32 mask)
+{
+    u32 result = 0;
+    if (mask & IN_CLOSE_WRITE)            result |= PlatformFileChangeFlags_Modified;
+    if (mask & (IN_CREATE | IN_MOVED_TO)) result |= PlatformFileChangeFlags_Created;
+    if (mask & (IN_DELETE | IN_MOVED_FROM)) result |= PlatformFileChangeFlags_Deleted;
+    if (mask & (IN_MOVED_FROM | IN_MOVED_TO)) result |= PlatformFileChangeFlags_Renamed;
+    return result;
+}
+
+u32 linux_poll_file_changes(PlatformFileChange* changes, u32 max_change_count)
+{
+    LinuxFileWatcher* watcher = &g_linux_file_watcher;
+    PlatformFileChangeQueue* queue = &watcher->queue;
+    platform_file_change_queue_begin(queue);
+
+    if (watcher->next_watch_id > 0 && watcher->inotify_fd >= 0)
+    {
+        alignas(struct inotify_event) u8 event_buffer[Kilobytes(16)];
+        for (;;)
+        {
+            ssize_t bytes_read = read(watcher->inotify_fd, event_buffer, sizeof(event_buffer));
+            if (bytes_read < 0 && errno == EINTR) continue;
+            if (bytes_read <= 0) break;
+
+            for (ssize_t offset = 0; offset < bytes_read;)
+            {
+                struct inotify_event* event = (struct inotify_event*)(event_buffer + offset);
+                offset += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    platform_file_change_queue_push_overflow(queue);
+                    continue;
+                }
+
+                // NOTE: Directory count can grow below when new subdirectories
+                //       get watched, those don't need to see this event
+                u32 directory_count = watcher->directory_count;
+                for (u32 directory_index = 0; directory_index < directory_count;)
+                {
+                    LinuxFileWatchDirectory* directory = &watcher->directories[directory_index];
+                    if (directory->wd != event->wd)
+                    {
+                        directory_index++;
+                        continue;
+                    }
+
+                    if (event->mask & IN_IGNORED)
+                    {
+                        // NOTE: The kernel already dropped the watch (directory
+                        //       deleted), removed below once the events are done
+                        directory->wd = -1;
+                        directory_index++;
+                        continue;
+                    }
+
+                    const char* name = event->len > 0 ? event->name : "";
+                    if (!directory->file_name || gj_strings_equal_null_term(directory->file_name, name))
+                    {
+                        u32 flags = linux_file_change_flags(event->mask);
+                        if (flags)
+                        {
+                            platform_file_change_queue_push(queue, directory->watch_id, flags,
+                                                            directory->prefix, (u32)strlen(directory->prefix),
+                                                            name, (u32)strlen(name));
+                        }
+                    }
+
+                    if (directory->recursive && (event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+                    {
+                        char child_path[PATH_MAX];
+                        char child_prefix[PATH_MAX];
+                        stbsp_snprintf(child_path, sizeof(child_path), "%s/%s", directory->path, name);
+                        stbsp_snprintf(child_prefix, sizeof(child_prefix), directory->prefix[0] ? "%s/%s" : "%s%s", directory->prefix, name);
+                        linux_file_watch_add_directory(directory->watch_id, child_path, child_prefix, NULL, gj_True, gj_True);
+                    }
+
+                    directory_index++;
+                }
+            }
+        }
+
+        // NOTE: Removing swaps the last directory in, so it's done in its own
+        //       pass rather than while the loop above walks the directories
+        for (u32 directory_index = 0; directory_index < watcher->directory_count;)
+        {
+            if (watcher->directories[directory_index].wd < 0)
+            {
+                linux_file_watch_remove_directory(directory_index, gj_False);
+            }
+            else
+            {
+                directory_index++;
+            }
+        }
+    }
+
+    return platform_file_change_queue_take(queue, changes, max_change_count);
+}
+
+FileTime linux_get_file_last_write_time(const char* file_name)
+{
+    FileTime result;
+    gj__ZeroStruct(result);
+
+    struct stat file_stat;
+    if (stat(file_name, &file_stat) != 0)
+    {
+        InvalidCodePath;
+        return result;
+    }
+
+    struct tm utc_time;
+    gmtime_r(&file_stat.st_mtim.tv_sec, &utc_time);
+    result.second = (u16)utc_time.tm_sec;
+    result.minute = (u16)utc_time.tm_min;
+    result.hour   = (u16)utc_time.tm_hour;
+    result.day    = (u16)utc_time.tm_mday;
+    result.month  = (u16)(utc_time.tm_mon + 1);
+    result.year   = (u16)(utc_time.tm_year + 1900);
+
+    result.compare_value = (u64)file_stat.st_mtim.tv_sec * 1000000000ull + file_stat.st_mtim.tv_nsec;
+
+    return result;
+}
+
+b32 linux_check_file_exists(const char* file_name)
+{
+    struct stat file_stat;
+    return stat(file_name, &file_stat) == 0 && S_ISREG(file_stat.st_mode);
+}
+
+void* linux_allocate_memory(size_t size)
+{
+    void* result = calloc(1, size);
+    gj_Assert(result);
+    return result;
+}
+
+void linux_deallocate_memory(void* memory)
+{
+    free(memory);
+}
+
+// NOTE: Layout is [header page][canary][data][guard page], see PLATFORM_GUARDED_ALLOCATIONS_ENV
+static struct
+{
+    TicketMutex            mutex;
+    PlatformGuardedHeader* quarantine[PLATFORM_GUARD_QUARANTINE_COUNT];
+    u32                    next;
+} g_linux_guarded;
+
+void* linux_guarded_allocate_memory(size_t size)
+{
+    size_t page_size    = (size_t)sysconf(_SC_PAGESIZE);
+    size_t aligned_size = (size + 15) & ~(size_t)15;
+    size_t data_size    = (aligned_size + page_size - 1) & ~(page_size - 1);
+    size_t mapping_size = page_size + data_size + page_size;
+
+    u8* mapping = (u8*)mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    gj_Assert(mapping != MAP_FAILED);
+
+    u8* guard = mapping + page_size + data_size;
+    gj_OnlyDebug(int ok = )mprotect(guard, page_size, PROT_NONE);
+    gj_AssertDebug(ok == 0);
+
+    u8* result = guard - aligned_size;
+    memset(mapping + page_size, PLATFORM_GUARD_CANARY, result - (mapping + page_size));
+    memset(result + size, PLATFORM_GUARD_CANARY, aligned_size - size);
+
+    PlatformGuardedHeader* header = (PlatformGuardedHeader*)mapping;
+    header->magic        = PLATFORM_GUARD_MAGIC;
+    header->mapping_size = mapping_size;
+    header->size         = size;
+    header->data         = result;
+    return result;
+}
+
+// NOTE: Copies the header through the kernel, for a pointer that didn't come
+//       from linux_guarded_allocate_memory the page before it may be unmapped
+//       or PROT_NONE and the read fails instead of faulting
+static b32
+linux_guarded_read_header(PlatformGuardedHeader* header, PlatformGuardedHeader* result)
+{
+    struct iovec local  = {result, sizeof(PlatformGuardedHeader)};
+    struct iovec remote = {header, sizeof(PlatformGuardedHeader)};
+    return process_vm_readv(getpid(), &local, 1, &remote, 1, 0) == (ssize_t)sizeof(PlatformGuardedHeader);
+}
+
+void linux_guarded_deallocate_memory(void* memory)
+{
+    if (!memory) return;
+
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    u8* data_start   = (u8*)((uintptr_t)memory & ~(uintptr_t)(page_size - 1));
+    PlatformGuardedHeader* header = (PlatformGuardedHeader*)(data_start - page_size);
+
+    PlatformGuardedHeader header_copy;
+    b32 readable = linux_guarded_read_header(header, &header_copy);
+    if (!readable || header_copy.magic != PLATFORM_GUARD_MAGIC || header_copy.data != memory)
+    {
+        linux_log_error(__FILE__, __FUNCTION__, __LINE__, "%s %p",
+                        readable && header_copy.magic == PLATFORM_GUARD_FREED_MAGIC ? "Double free of" : "Freeing unknown pointer", memory);
+        gj_Assert(!"Bad free");
+        return;
+    }
+
+    u8* end = header->data + ((header->size + 15) & ~(size_t)15);
+    b32 corrupted = gj_False;
+    for (u8* at = data_start; at < header->data; at++) corrupted |= *at != PLATFORM_GUARD_CANARY;
+    for (u8* at = header->data + header->size; at < end; at++) corrupted |= *at != PLATFORM_GUARD_CANARY;
+    if (corrupted)
+    {
+        linux_log_error(__FILE__, __FUNCTION__, __LINE__, "Heap corruption around %p (%zu bytes)", memory, header->size);
+        gj_Assert(!"Heap corruption");
+    }
+
+    header->magic = PLATFORM_GUARD_FREED_MAGIC;
+    memset(header->data, PLATFORM_GUARD_POISON, header->size);
+    mprotect(data_start, end - data_start, PROT_READ);
+
+    linux_begin_ticket_mutex(&g_linux_guarded.mutex);
+    PlatformGuardedHeader* evicted = g_linux_guarded.quarantine[g_linux_guarded.next];
+    g_linux_guarded.quarantine[g_linux_guarded.next] = header;
+    g_linux_guarded.next = (g_linux_guarded.next + 1) % PLATFORM_GUARD_QUARANTINE_COUNT;
+    linux_end_ticket_mutex(&g_linux_guarded.mutex);
+
+    if (evicted) munmap(evicted, evicted->mapping_size);
+}
+
+void* linux_reserve_memory(size_t size)
+{
+    void* result = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return result == MAP_FAILED ? NULL : result;
+}
+
+// NOTE: Rounded out to whole pages
+b32 linux_commit_memory(void* memory, size_t size)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start  = (uintptr_t)memory & ~(uintptr_t)(page_size - 1);
+    uintptr_t end    = ((uintptr_t)memory + size + page_size - 1) & ~(uintptr_t)(page_size - 1);
+    return mprotect((void*)start, end - start, PROT_READ | PROT_WRITE) == 0;
+}
+
+void linux_release_memory(void* memory, size_t size)
+{
+    if (memory) munmap(memory, size);
+}
+
+#define LINUX_HUGE_PAGE_SIZE    Megabytes(2)
+// NOTE: From linux/mempolicy.h, numaif.h is part of libnuma which might not be installed
+#define LINUX_MPOL_PREFERRED    1
+#define LINUX_MPOL_INTERLEAVE   3
+#define LINUX_MAX_NUMA_NODES    1024
+
+u32 linux_get_numa_node_count()
+{
+    // NOTE: /sys/devices/system/node/online is a list like "0" or "0-3" or "0,2-3",
+    //       the count is the highest node + 1
+    static u32 node_count = 0;
+    if (node_count) return node_count;
+
+    u32 highest_node = 0;
+    int fd = open("/sys/devices/system/node/online", O_RDONLY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        char buffer[256];
+        ssize_t bytes_read = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        buffer[bytes_read > 0 ? bytes_read : 0] = 0;
+
+        u32 value = 0;
+        for (char* at = buffer;; at++)
+        {
+            if (gj_IsDigit(*at))
+            {
+                value = value * 10 + gj_CharToDigit(*at);
+            }
+            else
+            {
+                if (value > highest_node) highest_node = value;
+                value = 0;
+                if (!*at) break;
+            }
+        }
+    }
+
+    node_count = highest_node < LINUX_MAX_NUMA_NODES ? highest_node + 1 : LINUX_MAX_NUMA_NODES;
+    return node_count;
+}
+
+PlatformPages linux_allocate_pages(size_t size, u32 flags, s32 numa_node)
+{
+    PlatformPages result;
+    gj__ZeroStruct(result);
+
+    b32 huge = flags & (PlatformPageFlags_LargePages | PlatformPageFlags_TransparentHugePages);
+    size_t page_size = huge ? LINUX_HUGE_PAGE_SIZE : (size_t)sysconf(_SC_PAGESIZE);
+    size = (size + page_size - 1) & ~(page_size - 1);
+
+    u8* memory = (u8*)MAP_FAILED;
+    if (flags & PlatformPageFlags_LargePages)
+    {
+        memory = (u8*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory == MAP_FAILED) flags = (flags & ~PlatformPageFlags_LargePages) | PlatformPageFlags_TransparentHugePages;
+    }
+
+    if (memory == MAP_FAILED && (flags & PlatformPageFlags_TransparentHugePages))
+    {
+        // NOTE: Map one huge page more and trim so that the range is huge page
+        //       aligned, khugepaged can't back unaligned ranges with huge pages
+        u8* base = (u8*)mmap(NULL, size + LINUX_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base != MAP_FAILED)
+        {
+            memory = (u8*)(((uintptr_t)base + LINUX_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(LINUX_HUGE_PAGE_SIZE - 1));
+            if (memory > base) munmap(base, memory - base);
+            if (memory + size < base + size + LINUX_HUGE_PAGE_SIZE) munmap(memory + size, (base + size + LINUX_HUGE_PAGE_SIZE) - (memory + size));
+            if (madvise(memory, size, MADV_HUGEPAGE) != 0) flags &= ~PlatformPageFlags_TransparentHugePages;
+        }
+    }
+    else if (memory == MAP_FAILED)
+    {
+        memory = (u8*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+
+    if (memory == MAP_FAILED)
+    {
+        linux_log_error(__FILE__, __FUNCTION__, __LINE__, "Failed to allocate %zu bytes", size);
+        return result;
+    }
+
+    // NOTE: The policy has to be set before the pages are touched. An unknown
+    //       node is dropped, it would index past node_mask
+    u32 node_count = linux_get_numa_node_count();
+    if (numa_node != PLATFORM_NUMA_NODE_ANY && (u32)numa_node >= node_count)
+    {
+        linux_log_error(__FILE__, __FUNCTION__, __LINE__, "NUMA node %d out of range (%u nodes), ignored", numa_node, node_count);
+        numa_node = PLATFORM_NUMA_NODE_ANY;
+    }
+    if ((flags & PlatformPageFlags_NumaInterleave) || numa_node != PLATFORM_NUMA_NODE_ANY)
+    {
+        u64 node_mask[LINUX_MAX_NUMA_NODES / 64];
+        memset(node_mask, 0, sizeof(node_mask));
+
+        int mode;
+        if (flags & PlatformPageFlags_NumaInterleave)
+        {
+            mode = LINUX_MPOL_INTERLEAVE;
+            for (u32 node = 0; node < node_count; node++) node_mask[node / 64] |= 1ull << (node % 64);
+        }
+        else
+        {
+            mode = LINUX_MPOL_PREFERRED;
+            node_mask[(u32)numa_node / 64] |= 1ull << ((u32)numa_node % 64);
+        }
+
+        if (syscall(SYS_mbind, memory, size, mode, node_mask, (unsigned long)LINUX_MAX_NUMA_NODES, 0) != 0)
+        {
+            flags &= ~PlatformPageFlags_NumaInterleave;
+        }
+    }
+
+    result.memory = memory;
+    result.size   = size;
+    result.flags  = flags;
+    return result;
+}
+
+void linux_deallocate_pages(PlatformPages pages)
+{
+    if (pages.memory) munmap(pages.memory, pages.size);
+}
+
+typedef struct LinuxThread
+{
+    pthread_t thread;
+    u32 volatile done;
+} LinuxThread;
+
+static void*
+linux_thread_proc(void* param)
+{
+    PlatformThreadContext* thread_context = (PlatformThreadContext*)param;
+    thread_context->thread_func(thread_context->param);
+    __atomic_store_n(&((LinuxThread*)thread_context->platform)->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+void linux_new_thread(PlatformAPI* platform_api, PlatformThreadContext* thread_context)
+{
+    // NOTE: Allocated before the thread starts since linux_thread_proc writes to it
+    thread_context->platform = platform_api->allocate_memory(sizeof(LinuxThread));
+    gj_OnlyDebug(int ok = )pthread_create(&((LinuxThread*)thread_context->platform)->thread, NULL, linux_thread_proc, thread_context);
+    gj_AssertDebug(ok == 0);
+}
+
+b32 linux_wait_for_threads(PlatformAPI* platform_api, PlatformThreadContext* threads, u32 thread_count)
+{
+    for (u32 thread_index = 0;
+         thread_index < thread_count;
+         thread_index++)
+    {
+        pthread_join(((LinuxThread*)threads[thread_index].platform)->thread, NULL);
+        platform_api->deallocate_memory(threads[thread_index].platform);
+    }
+
+    return gj_True;
+}
+
+ThreadStatus linux_check_thread_status(PlatformThreadContext thread_context)
+{
+    ThreadStatus result = ThreadStatus_Running;
+    if (thread_context.platform)
+    {
+        if (__atomic_load_n(&((LinuxThread*)thread_context.platform)->done, __ATOMIC_ACQUIRE)) result = ThreadStatus_Done;
+    }
+    return result;
+}
+
+void linux_begin_ticket_mutex(TicketMutex* ticket_mutex)
+{
+    u64 ticket = __atomic_fetch_add(&ticket_mutex->ticket, 1, __ATOMIC_SEQ_CST);
+    while (ticket != __atomic_load_n(&ticket_mutex->serving, __ATOMIC_ACQUIRE)) _mm_pause();
+}
+
+void linux_end_ticket_mutex(TicketMutex* ticket_mutex)
+{
+    __atomic_fetch_add(&ticket_mutex->serving, 1, __ATOMIC_RELEASE);
+}
+
+// NOTE: POSIX semaphores have no maximum (SEM_VALUE_MAX is the limit), it's
+//       kept to check signals against like ReleaseSemaphore does on Win32
+typedef struct LinuxSemaphore
+{
+    sem_t semaphore;
+    u32   max_count;
+} LinuxSemaphore;
+
+PlatformSemaphore linux_new_semaphore(u32 initial_count, u32 max_count)
+{
+    gj_AssertDebug(initial_count <= max_count);
+    LinuxSemaphore* semaphore = (LinuxSemaphore*)malloc(sizeof(LinuxSemaphore));
+    semaphore->max_count = max_count;
+    gj_OnlyDebug(int ok = )sem_init(&semaphore->semaphore, 0, initial_count);
+    gj_AssertDebug(ok == 0);
+
+    PlatformSemaphore result;
+    result.handle = semaphore;
+    return result;
+}
+
+void linux_signal_semaphore(PlatformSemaphore semaphore)
+{
+    LinuxSemaphore* linux_semaphore = (LinuxSemaphore*)semaphore.handle;
+#if defined(GJ_DEBUG)
+    int count = 0;
+    sem_getvalue(&linux_semaphore->semaphore, &count);
+    gj_AssertDebug((u32)count < linux_semaphore->max_count);
+#endif
+    sem_post(&linux_semaphore->semaphore);
+}
+
+void linux_wait_for_semaphore(PlatformSemaphore semaphore)
+{
+    LinuxSemaphore* linux_semaphore = (LinuxSemaphore*)semaphore.handle;
+    while (sem_wait(&linux_semaphore->semaphore) != 0 && errno == EINTR) {}
+}
+
+void linux_delete_semaphore(PlatformSemaphore semaphore)
+{
+    if (!semaphore.handle) return;
+    LinuxSemaphore* linux_semaphore = (LinuxSemaphore*)semaphore.handle;
+    sem_destroy(&linux_semaphore->semaphore);
+    free(linux_semaphore);
+}
+
+static PlatformFileHandle g_linux_log_file_handle = {};
+void linux_write_to_stdout(char* buffer, u64 buffer_size)
+{
+    if (!g_linux_log_file_handle.handle) g_linux_log_file_handle = linux_get_file_handle("logs", PlatformOpenFileModeFlags_Write);
+    gj_OnlyDebug(ssize_t bytes_written = )write(STDOUT_FILENO, buffer, buffer_size);
+    gj_AssertDebug(bytes_written == (ssize_t)buffer_size);
+    if (g_linux_log_file_handle.file_size > Megabytes(1))
+    {
+        g_linux_log_file_handle.file_size = 0;
+    }
+    if (g_linux_log_file_handle.handle)
+    {
+        linux_write_data_to_file_handle(g_linux_log_file_handle, g_linux_log_file_handle.file_size, buffer_size, buffer);
+        g_linux_log_file_handle.file_size += buffer_size;
+    }
+}
+
+static u64
+linux_format_log_line(char* buffer, u64 buffer_size, const char* kind, const char* file, const char* function, s32 line, char* message)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    struct tm local_time;
+    localtime_r(&now.tv_sec, &local_time);
+
+    return stbsp_snprintf(buffer, (int)buffer_size, "[%04d-%02d-%02d %02d:%02d:%02d.%03d] %s %s:%s %d %s\n",
+                          local_time.tm_year + 1900, local_time.tm_mon + 1, local_time.tm_mday,
+                          local_time.tm_hour, local_time.tm_min, local_time.tm_sec, (int)(now.tv_nsec / 1000000),
+                          kind, file, function, line, message);
+}
+
+void linux_log_error(const char* file, const char* function, s32 line, const char* format, ...)
+{
+    va_list varargs;
+    va_start(varargs, format);
+    char buffer[BUFFER_SIZE * 2];
+    stbsp_vsnprintf(buffer, sizeof(buffer), format, varargs);
+    va_end(varargs);
+
+    char buffer2[BUFFER_SIZE * 4];
+    u64 buffer2_size = linux_format_log_line(buffer2, sizeof(buffer2), "Error in", file, function, line, buffer);
+    if (buffer2_size >= sizeof(buffer2)) buffer2_size = sizeof(buffer2) - 1;
+    linux_write_to_stdout(buffer2, buffer2_size);
+}
+
+void linux_log_info(const char* file, const char* function, s32 line, const char* format, ...)
+{
+    va_list varargs;
+    va_start(varargs, format);
+    char buffer[BUFFER_SIZE * 2];
+    stbsp_vsnprintf(buffer, sizeof(buffer), format, varargs);
+    va_end(varargs);
+
+    char buffer2[BUFFER_SIZE * 4];
+    u64 buffer2_size = linux_format_log_line(buffer2, sizeof(buffer2), "Info", file, function, line, buffer);
+    if (buffer2_size >= sizeof(buffer2)) buffer2_size = sizeof(buffer2) - 1;
+    linux_write_to_stdout(buffer2, buffer2_size);
+}
+
+void linux_debug_print(const char* format, ...)
+{
+    va_list varargs;
+    va_start(varargs, format);
+    char buffer[BUFFER_SIZE];
+    u64 buffer_size = stbsp_vsnprintf(buffer, sizeof(buffer), format, varargs);
+    if (buffer_size >= sizeof(buffer)) buffer_size = sizeof(buffer) - 1;
+    linux_write_to_stdout(buffer, buffer_size);
+    va_end(varargs);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// Init
+///////////////////////////////////////////////////////////////////////////
+// TODO: Audio API, the sound buffer functions are left NULL for now
+// NOTE: memory_flags and numa_node are passed to allocate_pages for PlatformAPI::memory
+void linux_init_platform_api(PlatformAPI* platform_api, size_t memory_size,
+                             u32 memory_flags = 0, s32 numa_node = PLATFORM_NUMA_NODE_ANY)
+{
+    memset(platform_api->_os_api, 0, sizeof(platform_api->_os_api));
+    platform_api->get_file_handle            = linux_get_file_handle;
+    platform_api->read_data_from_file_handle = linux_read_data_from_file_handle;
+    platform_api->write_data_to_file_handle  = linux_write_data_to_file_handle;
+    platform_api->close_file_handle          = linux_close_file_handle;
+    platform_api->flush_file_handle          = linux_flush_file_handle;
+    platform_api->set_file_size              = linux_set_file_size;
+    platform_api->read_whole_file            = linux_read_whole_file;
+    platform_api->map_file                   = linux_map_file;
+    platform_api->unmap_file                 = linux_unmap_file;
+    platform_api->list_files                 = linux_list_files;
+    platform_api->walk_directory             = linux_walk_directory;
+    platform_api->get_file_last_write_time   = linux_get_file_last_write_time;
+    platform_api->check_file_exists          = linux_check_file_exists;
+    platform_api->add_file_watch             = linux_add_file_watch;
+    platform_api->remove_file_watch          = linux_remove_file_watch;
+    platform_api->poll_file_changes          = linux_poll_file_changes;
+    platform_api->allocate_memory            = linux_allocate_memory;
+    platform_api->deallocate_memory          = linux_deallocate_memory;
+    platform_api->reserve_memory             = linux_reserve_memory;
+    platform_api->commit_memory              = linux_commit_memory;
+    platform_api->release_memory             = linux_release_memory;
+    platform_api->allocate_pages             = linux_allocate_pages;
+    platform_api->deallocate_pages           = linux_deallocate_pages;
+    platform_api->get_numa_node_count        = linux_get_numa_node_count;
+    platform_api->new_thread                 = linux_new_thread;
+    platform_api->wait_for_threads           = linux_wait_for_threads;
+    platform_api->check_thread_status        = linux_check_thread_status;
+    platform_api->begin_ticket_mutex         = linux_begin_ticket_mutex;
+    platform_api->end_ticket_mutex           = linux_end_ticket_mutex;
+    platform_api->new_semaphore              = linux_new_semaphore;
+    platform_api->signal_semaphore           = linux_signal_semaphore;
+    platform_api->wait_for_semaphore         = linux_wait_for_semaphore;
+    platform_api->delete_semaphore           = linux_delete_semaphore;
+    platform_api->log_error                  = linux_log_error;
+    platform_api->log_info                   = linux_log_info;
+#if GJ_DEBUG
+    platform_api->debug_print                = linux_debug_print;
+#endif
+    gj_VerifyPlatformAPI((*platform_api));
+
+    const char* guarded = getenv(PLATFORM_GUARDED_ALLOCATIONS_ENV);
+    platform_api->guarded_allocations = guarded && guarded[0] == '1';
+    if (platform_api->guarded_allocations)
+    {
+        platform_api->allocate_memory   = linux_guarded_allocate_memory;
+        platform_api->deallocate_memory = linux_guarded_deallocate_memory;
+        linux_log_info(__FILE__, __FUNCTION__, __LINE__, "Guarded allocations on");
+    }
+
+    if (memory_size > 0 && platform_api->guarded_allocations)
+    {
+        platform_api->memory      = platform_api->allocate_memory(memory_size);
+        platform_api->memory_size = memory_size;
+    }
+    else if (memory_size > 0)
+    {
+        PlatformPages pages = platform_api->allocate_pages(memory_size, memory_flags, numa_node);
+        platform_api->memory       = pages.memory;
+        platform_api->memory_size  = pages.memory ? memory_size : 0;
+        platform_api->memory_flags = pages.flags;
+    }
+}
+
+#endif
@@ -32,7 +32,10 @@ win32_assert(bool exp)
 ///////////////////////////////////////////////////////////////////////////
 void* win32_allocate_memory(size_t size);
 void  win32_deallocate_memory(void* memory);
-void  win32_log_error(char* file, char* function, s32 line, char* format, ...);
+void  win32_log_error(const char* file, const char* function, s32 line, const char* format, ...);
+void  win32_log_info(const char* file, const char* function, s32 line, const char* format, ...);
+void  win32_begin_ticket_mutex(TicketMutex* ticket_mutex);
+void  win32_end_ticket_mutex(TicketMutex* ticket_mutex);
 
 PlatformFileHandle win32_get_file_handle(const char* file_name, u8 mode_flags)
 {
@@ -70,8 +73,10 @@ PlatformFileHandle win32_get_file_handle(const char* file_name, u8 mode_flags)
 
     // TODO: Add FILE_FLAG_SEQUENTIAL_SCAN to dwFlagsAndAttributes since most of the time
     //       the app will just read the file top-to-bottom?
+    DWORD handle_flags = FILE_ATTRIBUTE_NORMAL;
+    if (mode_flags & PlatformOpenFileModeFlags_Unbuffered) handle_flags |= FILE_FLAG_NO_BUFFERING;
     *(HANDLE*)&result.handle = CreateFileA(result.full_file_name, handle_permissions,
-                                           FILE_SHARE_READ | FILE_SHARE_WRITE, 0, handle_creation, FILE_ATTRIBUTE_NORMAL, 0);
+                                           FILE_SHARE_READ | FILE_SHARE_WRITE, 0, handle_creation, handle_flags, 0);
 
     if (result.handle == INVALID_HANDLE_VALUE)
     {
@@ -79,8 +84,8 @@ PlatformFileHandle win32_get_file_handle(const char* file_name, u8 mode_flags)
     }
     else
     {
-        DWORD file_size_high;
-        result.file_size = GetFileSize(result.handle, &file_size_high);
+        LARGE_INTEGER file_size;
+        result.file_size = GetFileSizeEx(result.handle, &file_size) ? (u64)file_size.QuadPart : 0;
     }
     
     return result;
@@ -110,7 +115,7 @@ void win32_write_data_to_file_handle(PlatformFileHandle file_handle, u64 offset,
 
     OVERLAPPED overlapped;
     gj__ZeroStruct(overlapped);
-    overlapped.Offset = gj_safe_cast_u64_to_u32(offset);
+    overlapped.Offset = offset & 0xFFFFFFFF;
     overlapped.OffsetHigh = (u32)((offset >> 32) & 0xFFFFFFFF);
 
     DWORD bytes_written;
@@ -122,6 +127,19 @@ void win32_write_data_to_file_handle(PlatformFileHandle file_handle, u64 offset,
     gj_AssertDebug(bytes_written == size);
 }
 
+b32 win32_flush_file_handle(PlatformFileHandle file_handle)
+{
+    return FlushFileBuffers((HANDLE)file_handle.handle);
+}
+
+b32 win32_set_file_size(PlatformFileHandle file_handle, u64 size)
+{
+    // NOTE: Doesn't touch the file pointer, unlike SetFilePointerEx + SetEndOfFile
+    FILE_END_OF_FILE_INFO end_of_file;
+    end_of_file.EndOfFile.QuadPart = (LONGLONG)size;
+    return SetFileInformationByHandle((HANDLE)file_handle.handle, FileEndOfFileInfo, &end_of_file, sizeof(end_of_file));
+}
+
 void win32_close_file_handle(PlatformFileHandle file_handle)
 {
     gj_OnlyDebug(BOOL ok = )CloseHandle(file_handle.handle);
@@ -135,7 +153,7 @@ u32 win32_read_whole_file(const char* file_name, void* dst)
     PlatformFileHandle file_handle = win32_get_file_handle(file_name, PlatformOpenFileModeFlags_Read);
     if (file_handle.handle != NULL)
     {
-        result = file_handle.file_size;
+        result = gj_safe_cast_u64_to_u32(file_handle.file_size);
         win32_read_data_from_file_handle(file_handle, 0, file_handle.file_size, dst);
         win32_close_file_handle(file_handle);
     }
@@ -146,6 +164,44 @@ u32 win32_read_whole_file(const char* file_name, void* dst)
     return result;
 }
 
+PlatformMappedFile win32_map_file(const char* file_name)
+{
+    PlatformMappedFile result;
+    gj__ZeroStruct(result);
+
+    HANDLE file_handle = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+        win32_log_error(__FILE__, __FUNCTION__, __LINE__, "win32_map_file failed to open %s", file_name);
+        return result;
+    }
+
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file_handle, &file_size) && file_size.QuadPart > 0)
+    {
+        // NOTE: The view keeps the mapping alive so both handles can be closed here
+        HANDLE mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping_handle)
+        {
+            result.memory = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+            if (result.memory) result.size = file_size.QuadPart;
+            CloseHandle(mapping_handle);
+        }
+    }
+    CloseHandle(file_handle);
+
+    return result;
+}
+
+void win32_unmap_file(PlatformMappedFile mapped_file)
+{
+    if (mapped_file.memory)
+    {
+        gj_OnlyDebug(BOOL ok = )UnmapViewOfFile(mapped_file.memory);
+        gj_AssertDebug(ok);
+    }
+}
+
 PlatformFileListing* win32_list_files(void* memory, size_t memory_max_size, const char* file_name_pattern)
 {
     PlatformFileListing* result = 0;
@@ -163,8 +219,9 @@ PlatformFileListing* win32_list_files(void* memory, size_t memory_max_size, cons
     PlatformFileListing* current = result;
     while (find_handle != INVALID_HANDLE_VALUE)
     {
-        current->file_name = (char*)push_array(&memory_arena, char, MAX_PATH);
-        memcpy(current->file_name, find_data.cFileName, MAX_PATH);
+        size_t file_name_size = strlen(find_data.cFileName) + 1;
+        current->file_name = (char*)push_array(&memory_arena, char, file_name_size);
+        memcpy(current->file_name, find_data.cFileName, file_name_size);
 
         if (!FindNextFileA(find_handle, &find_data))
         {
@@ -181,6 +238,277 @@ PlatformFileListing* win32_list_files(void* memory, size_t memory_max_size, cons
     return result;
 }
 
+// NOTE: FindFirstFileEx returns size, write time and attributes with every entry
+//       so there is no separate per-file stat pass on Win32.
+PlatformDirectoryListing win32_walk_directory(void* memory, size_t memory_max_size, const char* directory, b32 recursive)
+{
+    PlatformDirectoryListingBuilder builder;
+    platform_directory_listing_begin(&builder, memory, memory_max_size);
+
+    // NOTE: parent_index -1 is the walked directory itself, recursing appends
+    //       subdirectories to the listing which are then visited in order.
+    for (s64 parent_index = -1;
+         parent_index < (s64)builder.listing.entry_count && !builder.listing.out_of_memory;
+         parent_index++)
+    {
+        char* parent        = NULL;
+        u32   parent_length = 0;
+        if (parent_index >= 0)
+        {
+            if (!recursive) break;
+            if (!builder.listing.entries[parent_index].is_directory) continue;
+            parent        = platform_directory_listing_get_name(&builder, (u32)parent_index);
+            parent_length = builder.listing.entries[parent_index].name_length;
+        }
+
+        char search_pattern[BUFFER_SIZE];
+        s32 search_pattern_length = parent ?
+            stbsp_snprintf(search_pattern, sizeof(search_pattern), "%s/%s/*", directory, parent) :
+            stbsp_snprintf(search_pattern, sizeof(search_pattern), "%s/*", directory);
+        if (search_pattern_length >= (s32)sizeof(search_pattern))
+        {
+            win32_log_error(__FILE__, __FUNCTION__, __LINE__, "win32_walk_directory path too long in %s", directory);
+            continue;
+        }
+
+        WIN32_FIND_DATAA find_data;
+        HANDLE find_handle = FindFirstFileExA(search_pattern, FindExInfoBasic, &find_data,
+                                              FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+        if (find_handle == INVALID_HANDLE_VALUE) continue;
+
+        do
+        {
+            char* name = find_data.cFileName;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+            PlatformDirectoryEntry* entry = platform_directory_listing_push(&builder, parent, parent_length,
+                                                                            name, (u32)strlen(name));
+            if (!entry) break;
+
+            entry->size            = ((u64)find_data.nFileSizeHigh << 32) | find_data.nFileSizeLow;
+            entry->last_write_time = ((u64)find_data.ftLastWriteTime.dwHighDateTime << 32) | find_data.ftLastWriteTime.dwLowDateTime;
+            // NOTE: Junctions and directory symlinks aren't followed, they could
+            //       loop back up the tree. Matches d_type on Linux, which
+            //       reports links as DT_LNK.
+            entry->is_directory    = ((find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+                                      !(find_data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT));
+        } while (FindNextFileA(find_handle, &find_data));
+        FindClose(find_handle);
+    }
+
+    return platform_directory_listing_end(&builder);
+}
+
+///////////////////////////////////////////////////////////////////////////
+// File watch
+///////////////////////////////////////////////////////////////////////////
+#define WIN32_FILE_WATCH_MAX_WATCHES  256
+// NOTE: ReadDirectoryChangesW fails with more than 64KB on network shares
+#define WIN32_FILE_WATCH_BUFFER_SIZE  Kilobytes(64)
+#define WIN32_FILE_WATCH_NOTIFY_FILTER (FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | \
+                                        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_CREATION)
+
+// NOTE: Heap allocated since the OVERLAPPED must stay put while a read is pending
+typedef struct Win32FileWatch
+{
+    u32        watch_id;
+    HANDLE     directory;
+    OVERLAPPED overlapped;
+    b32        recursive;
+    // NOTE: Only report changes to this name, NULL to report everything
+    char*      file_name;
+    u8*        buffer;
+} Win32FileWatch;
+
+typedef struct Win32FileWatcher
+{
+    u32 next_watch_id;
+    Win32FileWatch* watches[WIN32_FILE_WATCH_MAX_WATCHES];
+    u32 watch_count;
+    PlatformFileChangeQueue queue;
+} Win32FileWatcher;
+
+global_variable Win32FileWatcher g_win32_file_watcher;
+
+static b32
+win32_file_watch_issue_read(Win32FileWatch* watch)
+{
+    gj__ZeroStruct(watch->overlapped);
+    return ReadDirectoryChangesW(watch->directory, watch->buffer, WIN32_FILE_WATCH_BUFFER_SIZE, watch->recursive,
+                                 WIN32_FILE_WATCH_NOTIFY_FILTER, NULL, &watch->overlapped, NULL);
+}
+
+static void
+win32_file_watch_free(Win32FileWatch* watch)
+{
+    CancelIoEx(watch->directory, &watch->overlapped);
+    DWORD bytes_transferred;
+    GetOverlappedResult(watch->directory, &watch->overlapped, &bytes_transferred, TRUE);
+    CloseHandle(watch->directory);
+    win32_deallocate_memory(watch->file_name);
+    win32_deallocate_memory(watch->buffer);
+    win32_deallocate_memory(watch);
+}
+
+u32 win32_add_file_watch(const char* path, b32 recursive)
+{
+    u32 result = 0;
+    Win32FileWatcher* watcher = &g_win32_file_watcher;
+    if (watcher->next_watch_id == 0) watcher->next_watch_id = 1;
+
+    DWORD attributes = GetFileAttributesA(path);
+    if (attributes == INVALID_FILE_ATTRIBUTES || watcher->watch_count == WIN32_FILE_WATCH_MAX_WATCHES)
+    {
+        win32_log_error(__FILE__, __FUNCTION__, __LINE__, "win32_add_file_watch can't watch %s", path);
+        return result;
+    }
+
+    char directory[BUFFER_SIZE];
+    char* file_name = NULL;
+    if (attributes & FILE_ATTRIBUTE_DIRECTORY)
+    {
+        stbsp_snprintf(directory, sizeof(directory), "%s", path);
+    }
+    else
+    {
+        const char* last_slash = strrchr(path, '/');
+        const char* last_backslash = strrchr(path, '\\');
+        if (last_backslash > last_slash) last_slash = last_backslash;
+        if (last_slash)
+        {
+            stbsp_snprintf(directory, sizeof(directory), "%.*s", (s32)(last_slash - path), path);
+            path = last_slash + 1;
+        }
+        else
+        {
+            stbsp_snprintf(directory, sizeof(directory), ".");
+        }
+        size_t file_name_size = strlen(path) + 1;
+        file_name = (char*)win32_allocate_memory(file_name_size);
+        memcpy(file_name, path, file_name_size);
+        recursive = gj_False;
+    }
+
+    HANDLE directory_handle = CreateFileA(directory, FILE_LIST_DIRECTORY,
+                                          FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                                          FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    if (directory_handle == INVALID_HANDLE_VALUE)
+    {
+        win32_deallocate_memory(file_name);
+        return result;
+    }
+
+    Win32FileWatch* watch = (Win32FileWatch*)win32_allocate_memory(sizeof(Win32FileWatch));
+    watch->watch_id  = watcher->next_watch_id;
+    watch->directory = directory_handle;
+    watch->recursive = recursive;
+    watch->file_name = file_name;
+    watch->buffer    = (u8*)win32_allocate_memory(WIN32_FILE_WATCH_BUFFER_SIZE);
+    if (win32_file_watch_issue_read(watch))
+    {
+        watcher->watches[watcher->watch_count++] = watch;
+        result = watcher->next_watch_id++;
+    }
+    else
+    {
+        win32_deallocate_memory(watch->file_name);
+        win32_deallocate_memory(watch->buffer);
+        win32_deallocate_memory(watch);
+        CloseHandle(directory_handle);
+    }
+
+    return result;
+}
+
+void win32_remove_file_watch(u32 watch_id)
+{
+    Win32FileWatcher* watcher = &g_win32_file_watcher;
+    for (u32 watch_index = 0; watch_index < watcher->watch_count; watch_index++)
+    {
+        if (watcher->watches[watch_index]->watch_id == watch_id)
+        {
+            win32_file_watch_free(watcher->watches[watch_index]);
+            watcher->watches[watch_index] = watcher->watches[--watcher->watch_count];
+            break;
+        }
+    }
+}
+
+static u32
+win32_file_change_flags(DWORD action)
+{
+    u32 result = 0;
+    switch (action)
+    {
+        case FILE_ACTION_ADDED:            { result = PlatformFileChangeFlags_Created;  } break;
+        case FILE_ACTION_REMOVED:          { result = PlatformFileChangeFlags_Deleted;  } break;
+        case FILE_ACTION_MODIFIED:         { result = PlatformFileChangeFlags_Modified; } break;
+        case FILE_ACTION_RENAMED_OLD_NAME: { result = PlatformFileChangeFlags_Deleted | PlatformFileChangeFlags_Renamed; } break;
+        case FILE_ACTION_RENAMED_NEW_NAME: { result = PlatformFileChangeFlags_Created | PlatformFileChangeFlags_Renamed; } break;
+    }
+    return result;
+}
+
+u32 win32_poll_file_changes(PlatformFileChange* changes, u32 max_change_count)
+{
+    Win32FileWatcher* watcher = &g_win32_file_watcher;
+    PlatformFileChangeQueue* queue = &watcher->queue;
+    platform_file_change_queue_begin(queue);
+
+    for (u32 watch_index = 0; watch_index < watcher->watch_count; watch_index++)
+    {
+        Win32FileWatch* watch = watcher->watches[watch_index];
+
+        DWORD bytes_transferred = 0;
+        if (!GetOverlappedResult(watch->directory, &watch->overlapped, &bytes_transferred, FALSE))
+        {
+            // NOTE: Nothing has changed since the last poll
+            if (GetLastError() == ERROR_IO_INCOMPLETE) continue;
+            bytes_transferred = 0;
+        }
+
+        if (bytes_transferred == 0)
+        {
+            // NOTE: The system buffer overflowed and the changes were dropped
+            platform_file_change_queue_push_overflow(queue);
+        }
+
+        for (u8* at = bytes_transferred > 0 ? watch->buffer : NULL; at;)
+        {
+            FILE_NOTIFY_INFORMATION* notify_information = (FILE_NOTIFY_INFORMATION*)at;
+
+            char name[BUFFER_SIZE];
+            s32 name_length = WideCharToMultiByte(CP_UTF8, 0,
+                                                  notify_information->FileName,
+                                                  notify_information->FileNameLength / sizeof(WCHAR),
+                                                  name, sizeof(name) - 1, NULL, NULL);
+            name[name_length] = '\0';
+            for (s32 char_index = 0; char_index < name_length; char_index++)
+            {
+                if (name[char_index] == '\\') name[char_index] = '/';
+            }
+
+            u32 flags = win32_file_change_flags(notify_information->Action);
+            if (flags && (!watch->file_name || lstrcmpiA(watch->file_name, name) == 0))
+            {
+                platform_file_change_queue_push(queue, watch->watch_id, flags, "", 0, name, name_length);
+            }
+
+            at = notify_information->NextEntryOffset ? at + notify_information->NextEntryOffset : NULL;
+        }
+
+        if (!win32_file_watch_issue_read(watch))
+        {
+            // NOTE: E.g. the watched directory got deleted
+            win32_log_error(__FILE__, __FUNCTION__, __LINE__, "win32_poll_file_changes dropping watch %u", watch->watch_id);
+            win32_file_watch_free(watch);
+            watcher->watches[watch_index--] = watcher->watches[--watcher->watch_count];
+        }
+    }
+
+    return platform_file_change_queue_take(queue, changes, max_change_count);
+}
+
 FileTime win32_get_file_last_write_time(const char* file_name)
 {
     FileTime result;
@@ -261,6 +589,226 @@ void win32_deallocate_memory(void* memory)
     }
 }
 
+// NOTE: Layout is [header page][canary][data][guard page], see PLATFORM_GUARDED_ALLOCATIONS_ENV
+static struct
+{
+    TicketMutex            mutex;
+    PlatformGuardedHeader* quarantine[PLATFORM_GUARD_QUARANTINE_COUNT];
+    u32                    next;
+} g_win32_guarded;
+
+static size_t
+win32_get_page_size()
+{
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return system_info.dwPageSize;
+}
+
+void* win32_guarded_allocate_memory(size_t size)
+{
+    size_t page_size    = win32_get_page_size();
+    size_t aligned_size = (size + 15) & ~(size_t)15;
+    size_t data_size    = (aligned_size + page_size - 1) & ~(page_size - 1);
+    size_t mapping_size = page_size + data_size + page_size;
+
+    u8* mapping = (u8*)VirtualAlloc(NULL, mapping_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    gj_Assert(mapping);
+
+    u8* guard = mapping + page_size + data_size;
+    DWORD old_protect;
+    gj_OnlyDebug(BOOL ok = )VirtualProtect(guard, page_size, PAGE_NOACCESS, &old_protect);
+    gj_AssertDebug(ok);
+
+    u8* result = guard - aligned_size;
+    memset(mapping + page_size, PLATFORM_GUARD_CANARY, result - (mapping + page_size));
+    memset(result + size, PLATFORM_GUARD_CANARY, aligned_size - size);
+
+    PlatformGuardedHeader* header = (PlatformGuardedHeader*)mapping;
+    header->magic        = PLATFORM_GUARD_MAGIC;
+    header->mapping_size = mapping_size;
+    header->size         = size;
+    header->data         = result;
+    return result;
+}
+
+// NOTE: The header page starts every guarded mapping, anything else (not
+//       mapped, another allocation, no access) isn't read
+static b32
+win32_guarded_header_readable(PlatformGuardedHeader* header)
+{
+    MEMORY_BASIC_INFORMATION info;
+    return (VirtualQuery(header, &info, sizeof(info)) == sizeof(info) &&
+            info.AllocationBase == header &&
+            info.State == MEM_COMMIT &&
+            (info.Protect & (PAGE_READWRITE | PAGE_READONLY)));
+}
+
+void win32_guarded_deallocate_memory(void* memory)
+{
+    if (!memory) return;
+
+    size_t page_size = win32_get_page_size();
+    u8* data_start   = (u8*)((uintptr_t)memory & ~(uintptr_t)(page_size - 1));
+    PlatformGuardedHeader* header = (PlatformGuardedHeader*)(data_start - page_size);
+
+    b32 readable = win32_guarded_header_readable(header);
+    if (!readable || header->magic != PLATFORM_GUARD_MAGIC || header->data != memory)
+    {
+        win32_log_error(__FILE__, __FUNCTION__, __LINE__, "%s %p",
+                        readable && header->magic == PLATFORM_GUARD_FREED_MAGIC ? "Double free of" : "Freeing unknown pointer", memory);
+        gj_Assert(!"Bad free");
+        return;
+    }
+
+    u8* end = header->data + ((header->size + 15) & ~(size_t)15);
+    b32 corrupted = gj_False;
+    for (u8* at = data_start; at < header->data; at++) corrupted |= *at != PLATFORM_GUARD_CANARY;
+    for (u8* at = header->data + header->size; at < end; at++) corrupted |= *at != PLATFORM_GUARD_CANARY;
+    if (corrupted)
+    {
+        win32_log_error(__FILE__, __FUNCTION__, __LINE__, "Heap corruption around %p (%zu bytes)", memory, header->size);
+        gj_Assert(!"Heap corruption");
+    }
+
+    header->magic = PLATFORM_GUARD_FREED_MAGIC;
+    memset(header->data, PLATFORM_GUARD_POISON, header->size);
+    DWORD old_protect;
+    VirtualProtect(data_start, end - data_start, PAGE_READONLY, &old_protect);
+
+    win32_begin_ticket_mutex(&g_win32_guarded.mutex);
+    PlatformGuardedHeader* evicted = g_win32_guarded.quarantine[g_win32_guarded.next];
+    g_win32_guarded.quarantine[g_win32_guarded.next] = header;
+    g_win32_guarded.next = (g_win32_guarded.next + 1) % PLATFORM_GUARD_QUARANTINE_COUNT;
+    win32_end_ticket_mutex(&g_win32_guarded.mutex);
+
+    if (evicted) VirtualFree(evicted, 0, MEM_RELEASE);
+}
+
+// NOTE: Large pages need SeLockMemoryPrivilege, which the user has to be
+//       granted ("Lock pages in memory") and the process has to enable
+static b32
+win32_enable_lock_memory_privilege()
+{
+    static s32 state = 0; // NOTE: 0 not tried yet, 1 enabled, -1 failed
+    if (state == 0)
+    {
+        state = -1;
+        HANDLE token;
+        if (OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+        {
+            TOKEN_PRIVILEGES privileges;
+            privileges.PrivilegeCount = 1;
+            privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+            if (LookupPrivilegeValueA(NULL, "SeLockMemoryPrivilege", &privileges.Privileges[0].Luid) &&
+                AdjustTokenPrivileges(token, FALSE, &privileges, 0, NULL, NULL) &&
+                GetLastError() == ERROR_SUCCESS)
+            {
+                state = 1;
+            }
+            CloseHandle(token);
+        }
+    }
+    return state == 1;
+}
+
+u32 win32_get_numa_node_count()
+{
+    ULONG highest_node = 0;
+    if (!GetNumaHighestNodeNumber(&highest_node)) highest_node = 0;
+    return (u32)highest_node + 1;
+}
+
+void* win32_reserve_memory(size_t size)
+{
+    return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+// NOTE: Rounded out to whole pages
+b32 win32_commit_memory(void* memory, size_t size)
+{
+    return VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
+void win32_release_memory(void* memory, size_t size)
+{
+    if (memory) VirtualFree(memory, 0, MEM_RELEASE);
+}
+
+#define WIN32_NUMA_INTERLEAVE_CHUNK_SIZE Megabytes(2)
+
+PlatformPages win32_allocate_pages(size_t size, u32 flags, s32 numa_node)
+{
+    PlatformPages result;
+    gj__ZeroStruct(result);
+
+    // NOTE: Windows has no madvise, large pages are the only huge pages
+    flags &= ~PlatformPageFlags_TransparentHugePages;
+
+    HANDLE process = GetCurrentProcess();
+    u32    node_count = win32_get_numa_node_count();
+    if (numa_node != PLATFORM_NUMA_NODE_ANY && (u32)numa_node >= node_count)
+    {
+        win32_log_error(__FILE__, __FUNCTION__, __LINE__, "NUMA node %d out of range (%u nodes), ignored", numa_node, node_count);
+        numa_node = PLATFORM_NUMA_NODE_ANY;
+    }
+    DWORD  node    = numa_node == PLATFORM_NUMA_NODE_ANY ? NUMA_NO_PREFERRED_NODE : (DWORD)numa_node;
+    if (node_count == 1) flags &= ~PlatformPageFlags_NumaInterleave;
+
+    void* memory = NULL;
+    if (flags & PlatformPageFlags_LargePages)
+    {
+        // NOTE: Large pages are reserved and committed in one go, so they can't
+        //       be spread over nodes chunk by chunk
+        SIZE_T large_page_size = GetLargePageMinimum();
+        if (large_page_size && !(flags & PlatformPageFlags_NumaInterleave) && win32_enable_lock_memory_privilege())
+        {
+            size = (size + large_page_size - 1) & ~(large_page_size - 1);
+            memory = VirtualAllocExNuma(process, NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+        }
+        if (!memory) flags &= ~PlatformPageFlags_LargePages;
+    }
+
+    if (!memory && (flags & PlatformPageFlags_NumaInterleave))
+    {
+        // NOTE: Reserve the whole range and commit it in chunks, each chunk
+        //       preferring the next node
+        size = (size + WIN32_NUMA_INTERLEAVE_CHUNK_SIZE - 1) & ~(size_t)(WIN32_NUMA_INTERLEAVE_CHUNK_SIZE - 1);
+        memory = VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_READWRITE);
+        for (size_t offset = 0; memory && offset < size; offset += WIN32_NUMA_INTERLEAVE_CHUNK_SIZE)
+        {
+            DWORD chunk_node = (DWORD)((offset / WIN32_NUMA_INTERLEAVE_CHUNK_SIZE) % node_count);
+            if (!VirtualAllocExNuma(process, (u8*)memory + offset, WIN32_NUMA_INTERLEAVE_CHUNK_SIZE, MEM_COMMIT, PAGE_READWRITE, chunk_node))
+            {
+                VirtualFree(memory, 0, MEM_RELEASE);
+                memory = NULL;
+            }
+        }
+        if (!memory) flags &= ~PlatformPageFlags_NumaInterleave;
+    }
+
+    if (!memory)
+    {
+        memory = VirtualAllocExNuma(process, NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+    }
+
+    if (!memory)
+    {
+        win32_log_error(__FILE__, __FUNCTION__, __LINE__, "Failed to allocate %zu bytes", size);
+        return result;
+    }
+
+    result.memory = memory;
+    result.size   = size;
+    result.flags  = flags;
+    return result;
+}
+
+void win32_deallocate_pages(PlatformPages pages)
+{
+    if (pages.memory) VirtualFree(pages.memory, 0, MEM_RELEASE);
+}
+
 DWORD WINAPI ThreadProc(LPVOID param)
 {
     PlatformThreadContext* thread_context = (PlatformThreadContext*)param;
@@ -325,6 +873,31 @@ void win32_end_ticket_mutex(TicketMutex* ticket_mutex)
     InterlockedExchangeAdd64((volatile LONG64*)&ticket_mutex->serving, 1);
 }
 
+PlatformSemaphore win32_new_semaphore(u32 initial_count, u32 max_count)
+{
+    PlatformSemaphore result;
+    result.handle = CreateSemaphoreExA(NULL, initial_count, max_count, NULL, 0, SEMAPHORE_ALL_ACCESS);
+    gj_AssertDebug(result.handle);
+    return result;
+}
+
+void win32_signal_semaphore(PlatformSemaphore semaphore)
+{
+    // NOTE: Fails when the count is already at max_count
+    gj_OnlyDebug(BOOL ok = )ReleaseSemaphore((HANDLE)semaphore.handle, 1, NULL);
+    gj_AssertDebug(ok);
+}
+
+void win32_wait_for_semaphore(PlatformSemaphore semaphore)
+{
+    WaitForSingleObjectEx((HANDLE)semaphore.handle, INFINITE, FALSE);
+}
+
+void win32_delete_semaphore(PlatformSemaphore semaphore)
+{
+    if (semaphore.handle) CloseHandle((HANDLE)semaphore.handle);
+}
+
 HANDLE win32_get_stdout_handle()
 {
     HANDLE result = CreateFileA("CONOUT$",
@@ -347,10 +920,10 @@ void _write_to_stdout(char* buffer, u64 buffer_size)
         g_log_file_handle.file_size = 0;
     }
     win32_write_data_to_file_handle(g_log_file_handle, g_log_file_handle.file_size, buffer_size, buffer);
-    g_log_file_handle.file_size += gj_safe_cast_u64_to_u32(buffer_size);
+    g_log_file_handle.file_size += buffer_size;
 }
 
-void win32_log_error(char* file, char* function, s32 line, char* format, ...)
+void win32_log_error(const char* file, const char* function, s32 line, const char* format, ...)
 {
     SYSTEMTIME st;
     GetLocalTime(&st);
@@ -367,7 +940,7 @@ void win32_log_error(char* file, char* function, s32 line, char* format, ...)
     _write_to_stdout(buffer2, buffer2_size);
 }
 
-void win32_log_info(char* file, char* function, s32 line, char* format, ...)
+void win32_log_info(const char* file, const char* function, s32 line, const char* format, ...)
 {
     SYSTEMTIME st;
     GetLocalTime(&st);
@@ -577,24 +1150,44 @@ u64 win32_get_samples_left(SoundBuffer sound_buffer)
 ///////////////////////////////////////////////////////////////////////////
 // Init
 ///////////////////////////////////////////////////////////////////////////
-void win32_init_platform_api(PlatformAPI* platform_api, size_t memory_size)
+// NOTE: memory_flags and numa_node are passed to allocate_pages for PlatformAPI::memory
+void win32_init_platform_api(PlatformAPI* platform_api, size_t memory_size,
+                             u32 memory_flags = 0, s32 numa_node = PLATFORM_NUMA_NODE_ANY)
 {
     memset(platform_api->_os_api, 0, sizeof(platform_api->_os_api));
     platform_api->get_file_handle            = win32_get_file_handle;
     platform_api->read_data_from_file_handle = win32_read_data_from_file_handle;
     platform_api->write_data_to_file_handle  = win32_write_data_to_file_handle;
     platform_api->close_file_handle          = win32_close_file_handle;
+    platform_api->flush_file_handle          = win32_flush_file_handle;
+    platform_api->set_file_size              = win32_set_file_size;
     platform_api->read_whole_file            = win32_read_whole_file;
+    platform_api->map_file                   = win32_map_file;
+    platform_api->unmap_file                 = win32_unmap_file;
     platform_api->list_files                 = win32_list_files;
+    platform_api->walk_directory             = win32_walk_directory;
     platform_api->get_file_last_write_time   = win32_get_file_last_write_time;
     platform_api->check_file_exists          = win32_check_file_exists;
+    platform_api->add_file_watch             = win32_add_file_watch;
+    platform_api->remove_file_watch          = win32_remove_file_watch;
+    platform_api->poll_file_changes          = win32_poll_file_changes;
     platform_api->allocate_memory            = win32_allocate_memory;
     platform_api->deallocate_memory          = win32_deallocate_memory;
+    platform_api->reserve_memory             = win32_reserve_memory;
+    platform_api->commit_memory              = win32_commit_memory;
+    platform_api->release_memory             = win32_release_memory;
+    platform_api->allocate_pages             = win32_allocate_pages;
+    platform_api->deallocate_pages           = win32_deallocate_pages;
+    platform_api->get_numa_node_count        = win32_get_numa_node_count;
     platform_api->new_thread                 = win32_new_thread;
     platform_api->wait_for_threads           = win32_wait_for_threads;
     platform_api->check_thread_status        = win32_check_thread_status;
     platform_api->begin_ticket_mutex         = win32_begin_ticket_mutex;
     platform_api->end_ticket_mutex           = win32_end_ticket_mutex;
+    platform_api->new_semaphore              = win32_new_semaphore;
+    platform_api->signal_semaphore           = win32_signal_semaphore;
+    platform_api->wait_for_semaphore         = win32_wait_for_semaphore;
+    platform_api->delete_semaphore           = win32_delete_semaphore;
     platform_api->log_error                  = win32_log_error;
     platform_api->log_info                   = win32_log_info;
 #if GJ_DEBUG
@@ -608,11 +1201,28 @@ void win32_init_platform_api(PlatformAPI* platform_api, size_t memory_size)
     platform_api->set_volume          = win32_set_volume;
     platform_api->get_samples_left    = win32_get_samples_left;
     
-    if (memory_size > 0)
+    char guarded[2] = {};
+    platform_api->guarded_allocations = GetEnvironmentVariableA(PLATFORM_GUARDED_ALLOCATIONS_ENV, guarded, sizeof(guarded)) == 1 &&
+                                        guarded[0] == '1';
+    if (platform_api->guarded_allocations)
+    {
+        platform_api->allocate_memory   = win32_guarded_allocate_memory;
+        platform_api->deallocate_memory = win32_guarded_deallocate_memory;
+        win32_log_info(__FILE__, __FUNCTION__, __LINE__, "Guarded allocations on");
+    }
+
+    if (memory_size > 0 && platform_api->guarded_allocations)
     {
         platform_api->memory      = platform_api->allocate_memory(memory_size);
         platform_api->memory_size = memory_size;
     }
+    else if (memory_size > 0)
+    {
+        PlatformPages pages = platform_api->allocate_pages(memory_size, memory_flags, numa_node);
+        platform_api->memory       = pages.memory;
+        platform_api->memory_size  = pages.memory ? memory_size : 0;
+        platform_api->memory_flags = pages.flags;
+    }
 }
 
 #endif
@@ -0,0 +1,315 @@
+// Checks GJAABBTree over ticks of random moves, inserts and removes: the
+// box, ray and pair queries against testing every live object's fat box,
+// when a move reinserts, and the tree structure itself (parents, heights,
+// node bounds, node counts, a height logarithmic in the leaf count).
+//
+//  g++ -O2 -I. tools/aabb_tree_test.cpp -o aabb_tree_test && ./aabb_tree_test
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <gj/gj_aabb_tree.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 tick)
+{
+    if (!ok)
+    {
+        printf("%s: failed at tick %u\n", name, tick);
+        g_failures++;
+    }
+}
+
+typedef struct Object
+{
+    V3f min;
+    V3f max;
+    V3f velocity;
+    // NOTE: The box grown by the margin when it was last (re)inserted
+    V3f fat_min;
+    V3f fat_max;
+    GJAABBTreeNode* proxy;
+    b32 alive;
+} Object;
+
+static b32
+overlap(V3f a_min, V3f a_max, V3f b_min, V3f b_max)
+{
+    return a_min.x <= b_max.x && b_min.x <= a_max.x &&
+           a_min.y <= b_max.y && b_min.y <= a_max.y &&
+           a_min.z <= b_max.z && b_min.z <= a_max.z;
+}
+
+// NOTE: Closed box over [0, t_max], an axis giving NaN (0 * inf) is skipped
+static b32
+slab(V3f origin, V3f inverse_direction, V3f box_min, V3f box_max, f32 t_max)
+{
+    f32 enter = 0.0f;
+    f32 exit  = t_max;
+    for (u32 axis = 0; axis < 3; axis++)
+    {
+        f32 t0 = (box_min.a[axis] - origin.a[axis]) * inverse_direction.a[axis];
+        f32 t1 = (box_max.a[axis] - origin.a[axis]) * inverse_direction.a[axis];
+        if (isnan(t0) || isnan(t1)) continue;
+        if (t0 > t1) { f32 t = t0; t0 = t1; t1 = t; }
+        if (t0 > enter) enter = t0;
+        if (t1 < exit)  exit  = t1;
+    }
+    return enter <= exit;
+}
+
+// NOTE: Order isn't part of the result
+static b32
+same(u32* out, u32 found, std::vector<u32>& expected)
+{
+    std::vector<u32> sorted(out, out + found);
+    std::sort(sorted.begin(), sorted.end());
+    return sorted == expected;
+}
+
+// NOTE: Returns the leaf count under node, clears *ok on a broken invariant
+static u32
+validate(GJAABBTreeNode* node, GJAABBTreeNode* parent, Object* objects, b32* ok)
+{
+    if (node->parent != parent) *ok = gj_False;
+    if (gj__aabb_tree_is_leaf(node))
+    {
+        Object* object = &objects[node->user];
+        if (node->child2 || node->height != 0 || !object->alive || object->proxy != node ||
+            memcmp(&node->min, &object->fat_min, sizeof(V3f)) != 0 || memcmp(&node->max, &object->fat_max, sizeof(V3f)) != 0) *ok = gj_False;
+        return 1;
+    }
+    if (!node->child2) { *ok = gj_False; return 0; }
+    u32 leaves = validate(node->child1, node, objects, ok) + validate(node->child2, node, objects, ok);
+    s32 height1 = node->child1->height;
+    s32 height2 = node->child2->height;
+    if (node->height != 1 + gj_Max(height1, height2)) *ok = gj_False;
+    for (u32 axis = 0; axis < 3; axis++)
+    {
+        if (node->min.a[axis] != gj_Min(node->child1->min.a[axis], node->child2->min.a[axis]) ||
+            node->max.a[axis] != gj_Max(node->child1->max.a[axis], node->child2->max.a[axis])) *ok = gj_False;
+    }
+    return leaves;
+}
+
+// NOTE: The rotations don't keep every node within one level, only the
+//       height close to logarithmic
+static b32
+balanced(GJAABBTree* tree)
+{
+    return tree->leaf_count < 2 || gj_aabb_tree_height(tree) <= 2.0f * log2f((f32)tree->leaf_count);
+}
+
+static void
+insert(GJAABBTree* tree, Object* objects, u32 i)
+{
+    Object* object = &objects[i];
+    object->proxy   = gj_aabb_tree_insert(tree, object->min, object->max, i);
+    object->fat_min = V3_add(object->min, -tree->margin);
+    object->fat_max = V3_add(object->max,  tree->margin);
+    object->alive   = gj_True;
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(16);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    u32 count = 2000;
+    f32 world = 100.0f;
+    Object* objects = push_array(&arena, Object, count);
+    GJAABBTree tree;
+    gj_aabb_tree_create(&tree, &arena, 0.25f);
+
+    u32 out_max = count;
+    u32* out = push_array(&arena, u32, out_max);
+    u32 pair_max = 64 * count;
+    GJAABBTreePair* pairs = push_array(&arena, GJAABBTreePair, pair_max);
+
+    // NOTE: Empty tree
+    check("gj_aabb_tree_query_aabb empty", gj_aabb_tree_query_aabb(&tree, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, out, out_max) == 0, 0);
+    check("gj_aabb_tree_query_ray empty", gj_aabb_tree_query_ray(&tree, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, out, out_max) == 0, 0);
+    check("gj_aabb_tree_query_pairs empty", gj_aabb_tree_query_pairs(&tree, pairs, pair_max) == 0, 0);
+
+    // NOTE: A quarter of the boxes sit on the integer grid, half of those
+    //       stay put and half move in exact steps so boxes touch their fat
+    //       boxes and the queries touch the fat boxes. Every other box
+    //       starts out live.
+    for (u32 i = 0; i < count; i++)
+    {
+        Object* object = &objects[i];
+        V3f center = gj_random_V3f(&random, {0.0f, 0.0f, 0.0f}, {world, world, world});
+        V3f extent = gj_random_V3f(&random, {0.0f, 0.0f, 0.0f}, {2.0f, 2.0f, 2.0f});
+        if (i % 4 == 0)
+        {
+            center = {floorf(center.x), floorf(center.y), floorf(center.z)};
+            extent = {floorf(extent.x), floorf(extent.y), floorf(extent.z)};
+        }
+        object->min      = V3_sub(center, extent);
+        object->max      = V3_add(center, extent);
+        object->velocity = gj_random_V3f(&random, {-0.2f, -0.2f, -0.2f}, {0.2f, 0.2f, 0.2f});
+        if (i % 8 == 0) object->velocity = {0.0f, 0.0f, 0.0f};
+        if (i % 8 == 4) object->velocity = {0.125f, -0.125f, 0.0625f};
+        object->alive    = gj_False;
+        if (i % 2 == 0) insert(&tree, objects, i);
+    }
+
+    std::vector<u32> expected;
+    std::vector<std::pair<u32, u32>> expected_pairs, found_pairs;
+    for (u32 tick = 0; tick < 60; tick++)
+    {
+        // NOTE: Moves only reinsert once the box leaves the fat box
+        b32 ok = gj_True;
+        for (u32 i = 0; i < count; i++)
+        {
+            Object* object = &objects[i];
+            object->min = V3_add(object->min, object->velocity);
+            object->max = V3_add(object->max, object->velocity);
+            if (!object->alive) continue;
+            b32 inside = object->fat_min.x <= object->min.x && object->fat_min.y <= object->min.y && object->fat_min.z <= object->min.z &&
+                         object->max.x <= object->fat_max.x && object->max.y <= object->fat_max.y && object->max.z <= object->fat_max.z;
+            if (gj_aabb_tree_move(&tree, object->proxy, object->min, object->max) == inside) ok = gj_False;
+            if (!inside)
+            {
+                object->fat_min = V3_add(object->min, -tree.margin);
+                object->fat_max = V3_add(object->max,  tree.margin);
+            }
+        }
+        check("gj_aabb_tree_move", ok, tick);
+
+        // NOTE: Churn, and at tick 40 the tree is emptied and refilled
+        u32 churn = tick == 40 ? count : 100;
+        for (u32 k = 0; k < churn; k++)
+        {
+            u32 i = tick == 40 ? k : gj_random_range_u32(&random, count);
+            if (objects[i].alive)
+            {
+                gj_aabb_tree_remove(&tree, objects[i].proxy);
+                objects[i].alive = gj_False;
+            }
+            else if (tick != 40)
+            {
+                insert(&tree, objects, i);
+            }
+        }
+        if (tick == 40)
+        {
+            check("gj_aabb_tree_remove all", tree.root == NULL && tree.leaf_count == 0 && tree.node_count == 0, tick);
+            for (u32 i = 0; i < count; i += 3) insert(&tree, objects, i);
+        }
+
+        std::vector<u32> alive;
+        for (u32 i = 0; i < count; i++)
+        {
+            if (objects[i].alive) alive.push_back(i);
+        }
+        ok = gj_True;
+        u32 leaves = tree.root ? validate(tree.root, NULL, objects, &ok) : 0;
+        check("gj_aabb_tree structure", ok && leaves == alive.size() && tree.leaf_count == leaves &&
+              tree.node_count == (leaves ? 2 * leaves - 1 : 0) && balanced(&tree), tick);
+
+        ok = gj_True;
+        for (u32 query = 0; query < 50; query++)
+        {
+            V3f center = gj_random_V3f(&random, {-5.0f, -5.0f, -5.0f}, {world + 5.0f, world + 5.0f, world + 5.0f});
+            V3f extent = gj_random_V3f(&random, {0.0f, 0.0f, 0.0f}, {8.0f, 8.0f, 8.0f});
+            // NOTE: Fat boxes of grid boxes end in .25 and .75, so do these
+            if (query % 4 == 0)
+            {
+                center = {floorf(center.x) + 0.5f, floorf(center.y) + 0.5f, floorf(center.z) + 0.5f};
+                extent = {floorf(extent.x) + 0.25f, floorf(extent.y) + 0.25f, floorf(extent.z) + 0.25f};
+            }
+            V3f min = V3_sub(center, extent);
+            V3f max = V3_add(center, extent);
+            u32 found = gj_aabb_tree_query_aabb(&tree, min, max, out, out_max);
+            expected.clear();
+            for (u32 i : alive)
+            {
+                if (overlap(objects[i].fat_min, objects[i].fat_max, min, max)) expected.push_back(i);
+            }
+            if (!same(out, found, expected)) ok = gj_False;
+
+            // NOTE: Zero direction components give +-inf inverse directions
+            V3f direction = gj_random_V3f(&random, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f});
+            for (u32 axis = 0; axis < 3; axis++)
+            {
+                if (gj_random_range_u32(&random, 4) == 0) direction.a[axis] = 0.0f;
+            }
+            if (direction.x == 0.0f && direction.y == 0.0f && direction.z == 0.0f) direction.y = 1.0f;
+            f32 t_max = query % 2 ? 30.0f : FLT_MAX;
+            found = gj_aabb_tree_query_ray(&tree, center, direction, out, out_max, t_max);
+            RaySlab ray = RaySlab_create(center, direction);
+            expected.clear();
+            for (u32 i : alive)
+            {
+                if (slab(center, ray.inverse_direction, objects[i].fat_min, objects[i].fat_max, t_max)) expected.push_back(i);
+            }
+            if (!same(out, found, expected)) ok = gj_False;
+        }
+        check("gj_aabb_tree_query_aabb/query_ray", ok, tick);
+
+        if (tick % 10 == 0 || tick == 40)
+        {
+            expected_pairs.clear();
+            for (size_t x = 0; x < alive.size(); x++)
+            {
+                for (size_t y = x + 1; y < alive.size(); y++)
+                {
+                    Object* a = &objects[alive[x]];
+                    Object* b = &objects[alive[y]];
+                    if (overlap(a->fat_min, a->fat_max, b->fat_min, b->fat_max)) expected_pairs.push_back(std::make_pair(alive[x], alive[y]));
+                }
+            }
+            u32 pair_count = gj_aabb_tree_query_pairs(&tree, pairs, pair_max);
+            found_pairs.clear();
+            for (u32 i = 0; i < gj_Min(pair_count, pair_max); i++) found_pairs.push_back(std::make_pair(pairs[i].a, pairs[i].b));
+            std::sort(found_pairs.begin(), found_pairs.end());
+            check("gj_aabb_tree_query_pairs", pair_count == expected_pairs.size() && found_pairs == expected_pairs, tick);
+        }
+    }
+
+    // NOTE: A short out gets out_max of the matches and the full count back
+    {
+        V3f min = {0.0f, 0.0f, 0.0f};
+        V3f max = {world, world, world};
+        u32 found = gj_aabb_tree_query_aabb(&tree, min, max, out, out_max);
+        u32 short_out[3];
+        u32 short_found = gj_aabb_tree_query_aabb(&tree, min, max, short_out, gj_ArrayCount(short_out));
+        check("gj_aabb_tree_query_aabb out_max", found > 3 && short_found == found && memcmp(short_out, out, sizeof(short_out)) == 0, 0);
+        u32 pair_count = gj_aabb_tree_query_pairs(&tree, pairs, pair_max);
+        check("gj_aabb_tree_query_pairs pair_max", pair_count > 3 && gj_aabb_tree_query_pairs(&tree, pairs, 3) == pair_count, 0);
+    }
+
+    // NOTE: Boxes along a line inserted in order, which without rotations
+    //       gives a list
+    {
+        BeginTemporaryMemoryBlock(&arena);
+        GJAABBTree line;
+        gj_aabb_tree_create(&line, &arena, 0.0f);
+        for (u32 i = 0; i < 1000; i++) gj_aabb_tree_insert(&line, {(f32)i, 0.0f, 0.0f}, {(f32)i + 0.5f, 1.0f, 1.0f}, i);
+        check("gj_aabb_tree balance", balanced(&line), 0);
+        EndTemporaryMemoryBlock(&arena);
+    }
+
+    // NOTE: Removed nodes are reused, so remove and insert leave the arena alone
+    {
+        size_t used = arena.used;
+        for (u32 i = 0; i < count; i++)
+        {
+            if (!objects[i].alive) continue;
+            gj_aabb_tree_remove(&tree, objects[i].proxy);
+            insert(&tree, objects, i);
+        }
+        check("gj_aabb_tree free list", arena.used == used, 0);
+    }
+
+    printf(g_failures ? "aabb_tree_test: %u failures\n" : "aabb_tree_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
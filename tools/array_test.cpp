@@ -0,0 +1,157 @@
+// Checks the gj_DefineArray/gj_DefineGrowableArray methods against
+// std::vector doing the same random mix of operations.
+//
+//  g++ -O2 -I. tools/array_test.cpp -o array_test && ./array_test
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#if defined(_WIN32)
+#include <gj/win32_platform.h>
+#define init_platform_api win32_init_platform_api
+#else
+#include <gj/linux_platform.h>
+#define init_platform_api linux_init_platform_api
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok)
+{
+    if (!ok)
+    {
+        printf("%s: failed\n", name);
+        g_failures++;
+    }
+}
+
+template <typename Array>
+static b32
+same(Array* array, std::vector<u32>& expected)
+{
+    return array->count == expected.size() && (array->count == 0 || memcmp(array->data, expected.data(), array->count * sizeof(u32)) == 0);
+}
+
+// NOTE: Random operations on array mirrored on a std::vector, keeping the
+//       count under max_size by removing a range when it gets there. The
+//       contents are compared every 256 operations.
+template <typename Array>
+static void
+random_operations(const char* name, Array* array, u32 max_size, u32 operation_count, RandomXoshiro128* random)
+{
+    std::vector<u32> expected;
+    for (u32 operation = 0; operation < operation_count; operation++)
+    {
+        u32 value = gj_random_u32(random);
+        u32 kind  = gj_random_range_u32(random, 9);
+        if (kind <= 2)
+        {
+            array->add(value);
+            expected.push_back(value);
+        }
+        else if (kind == 3 && array->count)
+        {
+            u32 i = gj_random_range_u32(random, array->count);
+            check(name, array->unordered_remove(i) == expected[i]);
+            expected[i] = expected.back();
+            expected.pop_back();
+        }
+        else if (kind == 4 && array->count)
+        {
+            u32 i = gj_random_range_u32(random, array->count);
+            check(name, array->remove(i) == expected[i]);
+            expected.erase(expected.begin() + i);
+        }
+        else if (kind == 5)
+        {
+            u32 values[16];
+            u32 n = gj_random_range_u32(random, gj_ArrayCount(values) + 1);
+            for (u32 k = 0; k < n; k++) values[k] = gj_random_u32(random);
+            u32 i = gj_random_range_u32(random, array->count + 1);
+            array->insert_n(i, values, n);
+            expected.insert(expected.begin() + i, values, values + n);
+        }
+        else if (kind == 6 && array->count)
+        {
+            u32 i = gj_random_range_u32(random, array->count);
+            u32 n = gj_random_range_u32(random, gj_Min(array->count - i, 10u) + 1);
+            array->remove_range(i, n);
+            expected.erase(expected.begin() + i, expected.begin() + i + n);
+        }
+        else if (kind == 7 && array->count)
+        {
+            check(name, array->pop() == expected.back());
+            expected.pop_back();
+        }
+        else
+        {
+            u32 values[5] = {1, 2, 3, 4, 5};
+            u32 n = gj_random_range_u32(random, gj_ArrayCount(values) + 1);
+            array->append_n(values, n);
+            expected.insert(expected.end(), values, values + n);
+        }
+
+        if (array->count + 32 > max_size)
+        {
+            array->remove_range(0, max_size / 2);
+            expected.erase(expected.begin(), expected.begin() + max_size / 2);
+        }
+        if ((operation % 256 == 255 || operation + 1 == operation_count) && !same(array, expected))
+        {
+            printf("%s: differs after operation %u\n", name, operation);
+            g_failures++;
+            return;
+        }
+    }
+}
+
+int main()
+{
+    PlatformAPI platform_api;
+    init_platform_api(&platform_api, 0);
+    size_t arena_size = Megabytes(16);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    {
+        U32Array array;
+        U32Array_init(&array, &arena, 4096);
+        random_operations("array", &array, 4096, 200000, &random);
+
+        array.fill(7);
+        check("array fill", array.count == 4096 && array[0] == 7 && array[4095] == 7);
+    }
+
+    {
+        U32GrowableArray array;
+        U32GrowableArray_init(&array, &platform_api, 1u << 28);
+        u32* data = array.data;
+        random_operations("growable array", &array, 100000, 1000000, &random);
+        check("growable array pointers stay valid", array.data == data);
+
+        array.fill(3, 5000000);
+        check("growable array fill", array.count == 5000000 && array[0] == 3 && array[4999999] == 3);
+        U32GrowableArray_free(&array);
+    }
+
+    // NOTE: Full arrays refuse more elements instead of dropping them
+    {
+        U32GrowableArray array;
+        U32GrowableArray_init(&array, &platform_api, 100);
+        u32 values[100] = {};
+        check("growable array full", array.append_n(values, 100) != NULL);
+#if !defined(GJ_DEBUG)
+        check("growable array full add", !array.add(1) && array.count == 100);
+        check("growable array full add_new", array.add_new() == NULL && array.count == 100);
+        check("growable array full insert", !array.insert(0, 1) && array.count == 100);
+#endif
+        U32GrowableArray_free(&array);
+    }
+
+    printf(g_failures ? "array_test: %u failures\n" : "array_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+// Checks the GJBitset functions against a plain array of one byte per bit,
+// for sizes around the word and AVX2 register boundaries.
+//
+//  g++ -O2 -I. tools/bitset_test.cpp -o bitset_test && ./bitset_test
+//  g++ -O2 -mavx2 -I. tools/bitset_test.cpp -o bitset_test_avx2 && ./bitset_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 bit_count)
+{
+    if (!ok)
+    {
+        printf("%s: failed for %u bits\n", name, bit_count);
+        g_failures++;
+    }
+}
+
+// NOTE: Every bit matches and the padding past bit_count is still 0
+static b32
+same(GJBitset* bitset, u8* expected)
+{
+    for (u32 i = 0; i < bitset->word_count * 64; i++)
+    {
+        b32 bit = (bitset->words[i / 64] >> (i % 64)) & 1;
+        if (bit != (i < bitset->bit_count ? expected[i] : 0)) return gj_False;
+    }
+    return gj_True;
+}
+
+static void
+random_bits(GJBitset* bitset, u8* expected, RandomXoshiro128* random, u32 one_in)
+{
+    gj_bitset_clear_all(bitset);
+    for (u32 i = 0; i < bitset->bit_count; i++)
+    {
+        expected[i] = gj_random_range_u32(random, one_in) == 0;
+        gj_bitset_assign(bitset, i, expected[i]);
+    }
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(16);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    u32 bit_counts[] = {0, 1, 63, 64, 65, 255, 256, 257, 1000, 4097, 100000};
+    for (u32 size_index = 0; size_index < gj_ArrayCount(bit_counts); size_index++)
+    {
+        u32 bit_count = bit_counts[size_index];
+        BeginTemporaryMemoryBlock(&arena);
+        GJBitset a = gj_bitset_create(&arena, bit_count);
+        GJBitset b = gj_bitset_create(&arena, bit_count);
+        GJBitset dst = gj_bitset_create(&arena, bit_count);
+        u8* expected_a = push_array(&arena, u8, bit_count + 1);
+        u8* expected_b = push_array(&arena, u8, bit_count + 1);
+        u8* expected   = push_array(&arena, u8, bit_count + 1);
+        u32* indices   = push_array(&arena, u32, bit_count + 1);
+
+        check("gj_bitset_create", a.word_count % GJ_BITSET_WORD_ALIGNMENT == 0 && same(&a, expected), bit_count);
+
+        gj_bitset_set_all(&a);
+        for (u32 i = 0; i < bit_count; i++) expected[i] = 1;
+        check("gj_bitset_set_all", same(&a, expected), bit_count);
+
+        // NOTE: Sparse and dense, so the counts and iteration see empty words
+        //       and full ones
+        u32 densities[] = {1, 2, 50};
+        for (u32 density_index = 0; density_index < gj_ArrayCount(densities); density_index++)
+        {
+            random_bits(&a, expected_a, &random, densities[density_index]);
+            random_bits(&b, expected_b, &random, densities[(density_index + 1) % gj_ArrayCount(densities)]);
+            check("gj_bitset_assign", same(&a, expected_a) && same(&b, expected_b), bit_count);
+
+            for (u32 i = 0; i < bit_count; i++)
+            {
+                check("gj_bitset_get", gj_bitset_get(&a, i) == expected_a[i], bit_count);
+            }
+
+            gj_bitset_and(&dst, &a, &b);
+            for (u32 i = 0; i < bit_count; i++) expected[i] = expected_a[i] & expected_b[i];
+            check("gj_bitset_and", same(&dst, expected), bit_count);
+            gj_bitset_or(&dst, &a, &b);
+            for (u32 i = 0; i < bit_count; i++) expected[i] = expected_a[i] | expected_b[i];
+            check("gj_bitset_or", same(&dst, expected), bit_count);
+            gj_bitset_xor(&dst, &a, &b);
+            for (u32 i = 0; i < bit_count; i++) expected[i] = expected_a[i] ^ expected_b[i];
+            check("gj_bitset_xor", same(&dst, expected), bit_count);
+            gj_bitset_and_not(&dst, &a, &b);
+            for (u32 i = 0; i < bit_count; i++) expected[i] = expected_a[i] & !expected_b[i];
+            check("gj_bitset_and_not", same(&dst, expected), bit_count);
+
+            u32 expected_count = 0;
+            for (u32 i = 0; i < bit_count; i++) expected_count += expected[i];
+            check("gj_bitset_count", gj_bitset_count(&dst) == expected_count, bit_count);
+            check("gj_bitset_any", gj_bitset_any(&dst) == (expected_count > 0), bit_count);
+
+            u32 index_count = gj_bitset_to_indices(&dst, indices);
+            b32 ok = index_count == expected_count;
+            u32 next = gj_bitset_next(&dst, 0);
+            u32 visited = 0;
+            for (u32 i = 0, k = 0; i < bit_count && ok; i++)
+            {
+                if (!expected[i]) continue;
+                ok = indices[k++] == i && next == i;
+                next = gj_bitset_next(&dst, i + 1);
+            }
+            check("gj_bitset_to_indices/gj_bitset_next", ok && next == bit_count, bit_count);
+            gj_BitsetForEach(&dst, index)
+            {
+                if (index >= bit_count || !expected[index] || (visited < index_count && indices[visited] != index)) ok = gj_False;
+                visited++;
+            }
+            check("gj_BitsetForEach", ok && visited == expected_count, bit_count);
+
+            // NOTE: dst aliasing an input, after which the other single bit ops
+            gj_bitset_or(&a, &a, &b);
+            for (u32 i = 0; i < bit_count; i++) expected_a[i] |= expected_b[i];
+            check("gj_bitset_or in place", same(&a, expected_a), bit_count);
+            for (u32 i = 0; i < bit_count; i += 3)
+            {
+                gj_bitset_toggle(&a, i);
+                expected_a[i] = !expected_a[i];
+                if (i + 1 < bit_count) { gj_bitset_set(&a, i + 1); expected_a[i + 1] = 1; }
+                if (i + 2 < bit_count) { gj_bitset_unset(&a, i + 2); expected_a[i + 2] = 0; }
+            }
+            check("gj_bitset_toggle/set/unset", same(&a, expected_a), bit_count);
+        }
+
+        gj_bitset_clear_all(&a);
+        check("gj_bitset_clear_all", !gj_bitset_any(&a) && gj_bitset_count(&a) == 0 && gj_bitset_next(&a, 0) == bit_count, bit_count);
+        EndTemporaryMemoryBlock(&arena);
+    }
+
+    printf(g_failures ? "bitset_test: %u failures\n" : "bitset_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+// Checks gj_broadphase_update against testing every pair of boxes, over
+// several ticks of small moves (insertion sort path), a teleport of every
+// box (radix sort fallback) and changes in box count. Boxes are on a grid
+// part of the time so edges touch exactly, which counts as overlapping.
+//
+//  g++ -O2 -I. tools/broadphase_test.cpp -o broadphase_test && ./broadphase_test
+//  g++ -O2 -mavx2 -I. tools/broadphase_test.cpp -o broadphase_test_avx2 && ./broadphase_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <gj/gj_broadphase.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 count, u32 tick)
+{
+    if (!ok)
+    {
+        printf("%s: failed for count %u, tick %u\n", name, count, tick);
+        g_failures++;
+    }
+}
+
+typedef struct Entity
+{
+    V2f min;
+    V2f max;
+    V2f velocity;
+} Entity;
+
+typedef std::pair<u32, u32> Pair;
+
+static void
+brute_force(Entity* entities, u32 count, std::vector<Pair>& expected)
+{
+    expected.clear();
+    for (u32 i = 0; i < count; i++)
+    {
+        for (u32 j = i + 1; j < count; j++)
+        {
+            if (entities[i].min.x <= entities[j].max.x && entities[j].min.x <= entities[i].max.x &&
+                entities[i].min.y <= entities[j].max.y && entities[j].min.y <= entities[i].max.y) expected.push_back(Pair(i, j));
+        }
+    }
+}
+
+// NOTE: Order isn't part of the result, a < b is
+static b32
+same(GJBroadphase* broadphase, std::vector<Pair>& expected)
+{
+    std::vector<Pair> pairs;
+    for (u32 i = 0; i < broadphase->pair_count; i++)
+    {
+        if (broadphase->pairs[i].a >= broadphase->pairs[i].b) return gj_False;
+        pairs.push_back(Pair(broadphase->pairs[i].a, broadphase->pairs[i].b));
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs == expected;
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(64);
+    MemoryArena arena   = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    MemoryArena scratch = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    std::vector<Pair> expected;
+    u32 counts[] = {0, 1, 2, 3, 7, 8, 9, 16, 17, 33, 100, 501, 3000};
+    for (u32 count_index = 0; count_index < gj_ArrayCount(counts); count_index++)
+    {
+        BeginTemporaryMemoryBlock(&arena);
+        u32 count = counts[count_index];
+        f32 world = 10.0f * sqrtf((f32)count) + 10.0f;
+        Entity* entities = push_array(&arena, Entity, count);
+        for (u32 i = 0; i < count; i++)
+        {
+            V2f p    = {gj_random_f32(&random, 0.0f, world), gj_random_f32(&random, 0.0f, world)};
+            V2f size = {gj_random_f32(&random, 0.0f, 8.0f), gj_random_f32(&random, 0.0f, 8.0f)};
+            if (i % 4 == 0)
+            {
+                p    = {floorf(p.x), floorf(p.y)};
+                size = {floorf(size.x), floorf(size.y)};
+            }
+            // NOTE: Copies of an earlier box
+            if (i % 13 == 12) p = entities[gj_random_range_u32(&random, i)].min;
+            entities[i].min      = p;
+            entities[i].max      = V2_add(p, size);
+            entities[i].velocity = {gj_random_f32(&random, -1.0f, 1.0f), gj_random_f32(&random, -1.0f, 1.0f)};
+        }
+
+        GJBroadphase broadphase;
+        gj_broadphase_create(&broadphase, &arena, count, 8 * count + 8);
+        for (u32 tick = 0; tick < 20; tick++)
+        {
+            // NOTE: Every box jumps, the old order is no help
+            if (tick == 10)
+            {
+                for (u32 i = 0; i < count; i++)
+                {
+                    f32 dx = gj_random_f32(&random, -world, world);
+                    entities[i].min.x += dx;
+                    entities[i].max.x += dx;
+                }
+            }
+            // NOTE: One box less for a tick
+            u32 tick_count = tick == 15 && count ? count - 1 : count;
+
+            u32 pair_count = gj_broadphase_update(&broadphase, &entities[0].min, &entities[0].max, sizeof(Entity), tick_count, &scratch);
+            brute_force(entities, tick_count, expected);
+            check("gj_broadphase_update", pair_count == expected.size() && broadphase.pair_count == pair_count && same(&broadphase, expected), count, tick);
+            if (tick == 0 || tick == 15 || tick == 16 || (tick == 10 && count >= 100))
+            {
+                check("gj_broadphase_update radix sort", broadphase.radix_sorted || tick_count == 0, count, tick);
+            }
+            if (tick == 1 && count > 1)
+            {
+                check("gj_broadphase_update insertion sort", !broadphase.radix_sorted, count, tick);
+            }
+
+            for (u32 i = 0; i < tick_count; i++)
+            {
+                entities[i].min = V2_add(entities[i].min, entities[i].velocity);
+                entities[i].max = V2_add(entities[i].max, entities[i].velocity);
+            }
+        }
+        EndTemporaryMemoryBlock(&arena);
+    }
+
+    // NOTE: A short pair list keeps pair_capacity of the pairs and returns the
+    //       full count
+    {
+        u32 count = 200;
+        Entity* entities = push_array(&arena, Entity, count);
+        for (u32 i = 0; i < count; i++)
+        {
+            V2f p = {gj_random_f32(&random, 0.0f, 20.0f), gj_random_f32(&random, 0.0f, 20.0f)};
+            entities[i].min = p;
+            entities[i].max = V2_add(p, {4.0f, 4.0f});
+        }
+        brute_force(entities, count, expected);
+        GJBroadphase broadphase;
+        gj_broadphase_create(&broadphase, &arena, count, 10);
+        u32 pair_count = gj_broadphase_update(&broadphase, &entities[0].min, &entities[0].max, sizeof(Entity), count, &scratch);
+        b32 ok = expected.size() > 10 && pair_count == expected.size() && broadphase.pair_count == 10;
+        for (u32 i = 0; i < broadphase.pair_count; i++)
+        {
+            Pair pair(broadphase.pairs[i].a, broadphase.pairs[i].b);
+            if (!std::binary_search(expected.begin(), expected.end(), pair)) ok = gj_False;
+        }
+        check("gj_broadphase_update pair_capacity", ok, count, 0);
+    }
+
+    printf(g_failures ? "broadphase_test: %u failures\n" : "broadphase_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+// Checks gj_bvh_closest_hit/gj_bvh_any_hit against testing every triangle
+// with ray_triangle_intersection.
+//
+//  g++ -O2 -I. tools/bvh_test.cpp -o bvh_test && ./bvh_test
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <gj/gj_bvh.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+// NOTE: Closest t over all triangles, -1 for a miss
+static f32
+brute_force(V3f* positions, s32* indices, u32 index_count, V3f origin, V3f direction)
+{
+    f32 closest = -1.0f;
+    for (u32 i = 0; i < index_count; i += 3)
+    {
+        V3f pos;
+        if (ray_triangle_intersection(positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]], origin, direction, &pos))
+        {
+            f32 t = V3_dot(V3_sub(pos, origin), direction) / V3_dot(direction, direction);
+            if (closest < 0.0f || t < closest) closest = t;
+        }
+    }
+    return closest;
+}
+
+static void
+check(const char* name, GJBVH* bvh, V3f* positions, s32* indices, u32 index_count, V3f origin, V3f direction)
+{
+    f32 expected = brute_force(positions, indices, index_count, origin, direction);
+    RayHit hit;
+    b32 closest = gj_bvh_closest_hit(bvh, origin, direction, &hit);
+    b32 any     = gj_bvh_any_hit(bvh, origin, direction);
+    b32 hit_expected = expected >= 0.0f;
+    if (closest != hit_expected || any != hit_expected || (closest && fabsf(hit.t - expected) > 0.0001f * (1.0f + expected)))
+    {
+        printf("%s: ray (%g %g %g) (%g %g %g) closest %d t %g any %d, expected %d t %g\n", name,
+               origin.x, origin.y, origin.z, direction.x, direction.y, direction.z,
+               closest, hit.t, any, hit_expected, expected);
+        g_failures++;
+    }
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(256);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    // NOTE: Random triangle soup
+    {
+        u32 triangle_count = 20000;
+        V3f* positions = push_array(&arena, V3f, 3 * triangle_count);
+        s32* indices   = push_array(&arena, s32, 3 * triangle_count);
+        for (u32 i = 0; i < triangle_count; i++)
+        {
+            V3f center = gj_random_V3f(&random, {-50.0f, -50.0f, -50.0f}, {50.0f, 50.0f, 50.0f});
+            for (u32 j = 0; j < 3; j++)
+            {
+                positions[3 * i + j] = V3_add(center, gj_random_V3f(&random, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}));
+                indices[3 * i + j]   = 3 * i + j;
+            }
+        }
+        GJBVH bvh;
+        gj_bvh_build(&bvh, &arena, positions, sizeof(V3f), indices, 3 * triangle_count);
+        for (u32 i = 0; i < 1000; i++)
+        {
+            V3f origin    = gj_random_V3f(&random, {-60.0f, -60.0f, -60.0f}, {60.0f, 60.0f, 60.0f});
+            V3f direction = gj_random_V3f(&random, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f});
+            check("soup", &bvh, positions, indices, 3 * triangle_count, origin, direction);
+        }
+    }
+
+    // NOTE: Flat grid picked straight down, origins on the grid lines put
+    //       the ray on node faces with a direction that is 0 in x and z
+    {
+        u32 size = 8;
+        u32 vertex_count = (size + 1) * (size + 1);
+        V3f* positions = push_array(&arena, V3f, vertex_count);
+        s32* indices   = push_array(&arena, s32, 6 * size * size);
+        for (u32 z = 0; z <= size; z++)
+        {
+            for (u32 x = 0; x <= size; x++) positions[z * (size + 1) + x] = {(f32)x, 0.0f, (f32)z};
+        }
+        u32 index_count = 0;
+        for (u32 z = 0; z < size; z++)
+        {
+            for (u32 x = 0; x < size; x++)
+            {
+                s32 corner = z * (size + 1) + x;
+                indices[index_count++] = corner;
+                indices[index_count++] = corner + size + 1;
+                indices[index_count++] = corner + 1;
+                indices[index_count++] = corner + 1;
+                indices[index_count++] = corner + size + 1;
+                indices[index_count++] = corner + size + 2;
+            }
+        }
+        GJBVH bvh;
+        gj_bvh_build(&bvh, &arena, positions, sizeof(V3f), indices, index_count);
+        for (u32 x = 0; x <= 2 * size; x++)
+        {
+            for (u32 z = 0; z <= 2 * size; z++)
+            {
+                V3f origin = {0.5f * x, 10.0f, 0.5f * z + 0.3f};
+                check("grid down", &bvh, positions, indices, index_count, origin, {0.0f, -1.0f, 0.0f});
+                origin = {0.5f * x + 0.3f, -10.0f, 0.5f * z};
+                check("grid up", &bvh, positions, indices, index_count, origin, {0.0f, 1.0f, 0.0f});
+            }
+        }
+    }
+
+    printf(g_failures ? "bvh_test: %u failures\n" : "bvh_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+// Checks Frustum_cull_aabbs/Frustum_cull_spheres (SoA and AoS input) against
+// looping Frustum_intersects_aabb/Frustum_intersects_sphere, which they have
+// to match exactly, and Frustum_from_M4x4 against clipping points in clip
+// space.
+//
+//  g++ -O2 -I. tools/frustum_test.cpp -o frustum_test && ./frustum_test
+//  g++ -O2 -mavx2 -I. tools/frustum_test.cpp -o frustum_test_avx2 && ./frustum_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 at)
+{
+    if (!ok)
+    {
+        printf("%s: failed at %u\n", name, at);
+        g_failures++;
+    }
+}
+
+static b32
+same(u32* visible, u32 visible_count, u32* expected, u32 expected_count)
+{
+    return visible_count == expected_count && (expected_count == 0 || memcmp(visible, expected, expected_count * sizeof(u32)) == 0);
+}
+
+#define NEAR_PLANE 0.1f
+#define FAR_PLANE  200.0f
+
+// NOTE: Camera at a random spot looking at a random point near the origin
+static M4x4
+random_view_projection(RandomXoshiro128* random, V3f* camera_out = NULL)
+{
+    V3f camera    = gj_random_V3f(random, {-50.0f, -50.0f, -50.0f}, {50.0f, 50.0f, 50.0f});
+    if (camera_out) *camera_out = camera;
+    V3f target    = gj_random_V3f(random, {-5.0f, -5.0f, -5.0f}, {5.0f, 5.0f, 5.0f});
+    M4x4 view       = M4x4_model_view_matrix(camera, V3_sub(target, camera), {0.0f, 1.0f, 0.0f});
+    M4x4 projection = M4x4_projection_matrix(gj_random_f32(random, 30.0f, 100.0f), gj_random_f32(random, 0.5f, 2.0f), NEAR_PLANE, FAR_PLANE);
+    return M4x4_mul_scalar(projection, view);
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(16);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    // NOTE: Points around the camera from closer than the near plane to past
+    //       the far one and behind it, skipping the ones close to a plane
+    u32 inside_count = 0;
+    for (u32 round = 0; round < 100; round++)
+    {
+        V3f camera;
+        M4x4 view_projection = random_view_projection(&random, &camera);
+        Frustum frustum = Frustum_from_M4x4(view_projection);
+        b32 ok = gj_True;
+        for (u32 i = 0; i < 10000; i++)
+        {
+            V3f direction = V3_normalize(gj_random_V3f(&random, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}));
+            f32 distance  = powf(10.0f, gj_random_f32(&random, -2.0f, 2.5f));
+            V3f p = V3_add(camera, V3_mul(distance, direction));
+            V4f clip = M4x4_mul_scalar(view_projection, V4f{p.x, p.y, p.z, 1.0f});
+            // NOTE: clip.w is the view space depth, the sides are compared
+            //       in normalized device coordinates. The far plane comes
+            //       from r3 - r2 with r2 close to r3 so it is only good to a
+            //       few hundredths.
+            f32 near_distance = clip.w - NEAR_PLANE;
+            f32 far_distance  = FAR_PLANE - clip.w;
+            f32 side          = clip.w > 0.0f ? 1.0f - gj_Max(fabsf(clip.x / clip.w), fabsf(clip.y / clip.w)) : -1.0f;
+            if (fabsf(near_distance) < 0.001f || fabsf(far_distance) < 0.05f || fabsf(side) < 0.001f) continue;
+            b32 inside = near_distance > 0.0f && far_distance > 0.0f && side > 0.0f;
+            inside_count += inside;
+            if (Frustum_intersects_sphere(&frustum, p, 0.0f) != inside) ok = gj_False;
+            if (Frustum_intersects_aabb(&frustum, p, p) != inside) ok = gj_False;
+        }
+        check("Frustum_from_M4x4", ok, round);
+    }
+    check("Frustum_from_M4x4 points inside", inside_count > 10000, 0);
+
+    for (u32 count = 0; count < 1100; count += (count < 40 ? 1 : 97))
+    {
+        BeginTemporaryMemoryBlock(&arena);
+        Frustum frustum = Frustum_from_M4x4(random_view_projection(&random));
+        V3fSoA box_min = V3fSoA_create(&arena, count);
+        V3fSoA box_max = V3fSoA_create(&arena, count);
+        V3f* aos_min   = push_array(&arena, V3f, count);
+        V3f* aos_max   = push_array(&arena, V3f, count);
+        f32* radii     = push_array(&arena, f32, count);
+        u32* visible   = push_array(&arena, u32, count + 1);
+        u32* expected  = push_array(&arena, u32, count + 1);
+        for (u32 i = 0; i < count; i++)
+        {
+            aos_min[i] = gj_random_V3f(&random, {-100.0f, -100.0f, -100.0f}, {100.0f, 100.0f, 100.0f});
+            aos_max[i] = V3_add(aos_min[i], gj_random_V3f(&random, {0.0f, 0.0f, 0.0f}, {10.0f, 10.0f, 10.0f}));
+            radii[i]   = gj_random_f32(&random, 0.0f, 10.0f);
+            V3fSoA_set(&box_min, i, aos_min[i]);
+            V3fSoA_set(&box_max, i, aos_max[i]);
+        }
+
+        u32 expected_count = 0;
+        for (u32 i = 0; i < count; i++)
+        {
+            if (Frustum_intersects_aabb(&frustum, aos_min[i], aos_max[i])) expected[expected_count++] = i;
+        }
+        u32 visible_count = Frustum_cull_aabbs(&frustum, &box_min, &box_max, visible);
+        check("Frustum_cull_aabbs SoA", same(visible, visible_count, expected, expected_count), count);
+        visible_count = Frustum_cull_aabbs(&frustum, aos_min, aos_max, count, visible);
+        check("Frustum_cull_aabbs", same(visible, visible_count, expected, expected_count), count);
+
+        expected_count = 0;
+        for (u32 i = 0; i < count; i++)
+        {
+            if (Frustum_intersects_sphere(&frustum, aos_min[i], radii[i])) expected[expected_count++] = i;
+        }
+        visible_count = Frustum_cull_spheres(&frustum, &box_min, radii, visible);
+        check("Frustum_cull_spheres SoA", same(visible, visible_count, expected, expected_count), count);
+        visible_count = Frustum_cull_spheres(&frustum, aos_min, radii, count, visible);
+        check("Frustum_cull_spheres", same(visible, visible_count, expected, expected_count), count);
+        EndTemporaryMemoryBlock(&arena);
+    }
+
+    printf(g_failures ? "frustum_test: %u failures\n" : "frustum_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,58 @@
+// Throughput of gj_hash64 and gj_crc32c over random data, 256 MB per size.
+// gj_crc32c uses the crc32 instruction when built with SSE4.2 (GJ_SSE42) and
+// the slicing-by-8 table otherwise, build both ways to compare:
+//
+//  g++ -O2 -I. tools/hash_benchmark.cpp -o hash_benchmark
+//  g++ -O2 -msse4.2 -I. tools/hash_benchmark.cpp -o hash_benchmark_sse42
+
+#include <gj/gj_base.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+static double
+seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    // NOTE: Reference values, CRC-32C check value and XXH64 of "" with seed 0
+    if (gj_crc32c(0, "123456789", 9) != 0xE3069283 || gj_hash64("", 0, 0) != 0xEF46DB3751D8E999ull)
+    {
+        printf("hash_benchmark: wrong result for reference input\n");
+        return 1;
+    }
+
+    size_t buffer_size = Megabytes(1);
+    u8* buffer = (u8*)malloc(buffer_size);
+    for (size_t i = 0; i < buffer_size; i++) buffer[i] = (u8)rand();
+
+#if defined(GJ_SSE42)
+    printf("crc32c: sse4.2\n");
+#else
+    printf("crc32c: slicing-by-8 table\n");
+#endif
+    size_t sizes[] = {16, 64, 256, Kilobytes(4), Kilobytes(64), Megabytes(1)};
+    size_t total = Megabytes(256);
+    for (u32 size_index = 0; size_index < gj_ArrayCount(sizes); size_index++)
+    {
+        size_t size = sizes[size_index];
+        size_t iterations = total / size;
+        volatile u64 sink = 0;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) sink += gj_hash64(buffer, size, i);
+        double hash_seconds = seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) sink += gj_crc32c((u32)i, buffer, size);
+        double crc_seconds = seconds_since(start);
+
+        f64 gigabytes = (f64)total / Gigabytes(1);
+        printf("%8zu B  hash64 %6.2f GB/s  crc32c %6.2f GB/s\n", size, gigabytes / hash_seconds, gigabytes / crc_seconds);
+    }
+    free(buffer);
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Checks M4x4_inverse and M4x4_inverse_affine: m * inverse(m) is the
+// identity, the SIMD general inverse agrees with M4x4_inverse_scalar to
+// rounding, the affine one agrees with the general one, and the in place
+// and batch versions give the same results as single calls.
+//
+//  g++ -O2 -I. tools/m4x4_inverse_test.cpp -o m4x4_inverse_test && ./m4x4_inverse_test
+//  g++ -O2 -DGJ_MATH_NO_SIMD -I. tools/m4x4_inverse_test.cpp -o m4x4_inverse_test_scalar && ./m4x4_inverse_test_scalar
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 round)
+{
+    if (!ok)
+    {
+        printf("%s: failed in round %u\n", name, round);
+        g_failures++;
+    }
+}
+
+static b32
+near(M4x4* a, M4x4* b, f32 tolerance)
+{
+    for (u32 i = 0; i < 16; i++)
+    {
+        if (!(fabsf(a->a[i] - b->a[i]) <= tolerance * (1.0f + fabsf(b->a[i])))) return gj_False;
+    }
+    return gj_True;
+}
+
+// NOTE: == so -0.0 and 0.0 are equal, the sign of zero isn't kept
+static b32
+equal(M4x4* a, M4x4* b)
+{
+    for (u32 i = 0; i < 16; i++)
+    {
+        if (a->a[i] != b->a[i]) return gj_False;
+    }
+    return gj_True;
+}
+
+static b32
+is_identity(M4x4 m, M4x4 inverse, f32 tolerance)
+{
+    M4x4 product  = M4x4_mul_scalar(m, inverse);
+    M4x4 identity = M4x4_identity();
+    return near(&product, &identity, tolerance);
+}
+
+// NOTE: Diagonally dominant so the condition number stays small
+static M4x4
+random_M4x4(RandomXoshiro128* random)
+{
+    M4x4 m;
+    for (u32 i = 0; i < 16; i++) m.a[i] = gj_random_f32(random, -1.0f, 1.0f);
+    for (u32 i = 0; i < 4; i++) m.m[i][i] += gj_random_range_u32(random, 2) ? 4.0f : -4.0f;
+    return m;
+}
+
+// NOTE: Rotation times a per axis scale (possibly mirrored) plus translation
+static M4x4
+random_affine(RandomXoshiro128* random)
+{
+    V3f axis = V3_normalize(gj_random_V3f(random, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}));
+    M4x4 rotation = M4x4_from_axis_angle(axis, gj_random_f32(random, -3.0f, 3.0f));
+    V3f scale = gj_random_V3f(random, {0.1f, 0.1f, -10.0f}, {10.0f, 10.0f, -0.1f});
+    V3f translation = gj_random_V3f(random, {-100.0f, -100.0f, -100.0f}, {100.0f, 100.0f, 100.0f});
+    M4x4 m = M4x4_identity();
+    for (u32 row = 0; row < 3; row++)
+    {
+        for (u32 column = 0; column < 3; column++) m.m[row][column] = rotation.m[row][column] * scale.a[column];
+        m.m[row][3] = translation.a[row];
+    }
+    return m;
+}
+
+int main()
+{
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+    M4x4 identity = M4x4_identity();
+
+    {
+        M4x4 inverse;
+        check("M4x4_inverse identity", M4x4_inverse(&inverse, &identity) == 1.0f && equal(&inverse, &identity), 0);
+        check("M4x4_inverse_affine identity", M4x4_inverse_affine(&inverse, &identity) == 1.0f && equal(&inverse, &identity), 0);
+
+        // NOTE: Powers of two are exact
+        M4x4 diagonal = identity;
+        diagonal._00 = 2.0f; diagonal._11 = 4.0f; diagonal._22 = 0.5f; diagonal._33 = 8.0f;
+        M4x4 expected = identity;
+        expected._00 = 0.5f; expected._11 = 0.25f; expected._22 = 2.0f; expected._33 = 0.125f;
+        check("M4x4_inverse diagonal", M4x4_inverse(&inverse, &diagonal) == 32.0f && equal(&inverse, &expected), 0);
+
+        // NOTE: Two equal rows
+        M4x4 singular = random_M4x4(&random);
+        for (u32 i = 0; i < 4; i++) singular.m[2][i] = singular.m[0][i];
+        check("M4x4_inverse singular", fabsf(M4x4_inverse(&inverse, &singular)) < 1e-4f, 0);
+    }
+
+    M4x4 batch[64], batch_copy[64];
+    M4x4 affine_batch[64], affine_copy[64];
+    for (u32 round = 0; round < 100000; round++)
+    {
+        M4x4 m = random_M4x4(&random);
+        M4x4 inverse, expected;
+        f32 det          = M4x4_inverse(&inverse, &m);
+        f32 expected_det = M4x4_inverse_scalar(&expected, &m);
+        check("M4x4_inverse m * inverse", is_identity(m, inverse, 1e-5f) && is_identity(inverse, m, 1e-5f), round);
+        check("M4x4_inverse vs scalar", near(&inverse, &expected, 1e-5f) && fabsf(det - expected_det) <= 1e-5f * fabsf(expected_det), round);
+        M4x4 in_place = m;
+        M4x4_inverse(&in_place, &in_place);
+        check("M4x4_inverse in place", memcmp(&in_place, &inverse, sizeof(M4x4)) == 0, round);
+
+        M4x4 affine = random_affine(&random);
+        M4x4 affine_inverse;
+        f32 affine_det = M4x4_inverse_affine(&affine_inverse, &affine);
+        expected_det   = M4x4_inverse_scalar(&expected, &affine);
+        check("M4x4_inverse_affine m * inverse", is_identity(affine, affine_inverse, 1e-4f) && is_identity(affine_inverse, affine, 1e-4f), round);
+        check("M4x4_inverse_affine vs general", near(&affine_inverse, &expected, 1e-4f) && fabsf(affine_det - expected_det) <= 1e-4f * fabsf(expected_det), round);
+        check("M4x4_inverse_affine last row", affine_inverse._30 == 0.0f && affine_inverse._31 == 0.0f && affine_inverse._32 == 0.0f && affine_inverse._33 == 1.0f, round);
+        in_place = affine;
+        M4x4_inverse_affine(&in_place, &in_place);
+        check("M4x4_inverse_affine in place", memcmp(&in_place, &affine_inverse, sizeof(M4x4)) == 0, round);
+
+        // NOTE: Batches in place against single calls on the copies
+        batch[round % 64] = batch_copy[round % 64] = m;
+        affine_batch[round % 64] = affine_copy[round % 64] = affine;
+        if (round % 64 == 63)
+        {
+            b32 ok = gj_True;
+            M4x4_inverse(batch, batch, 64);
+            M4x4_inverse_affine(affine_batch, affine_batch, 64);
+            for (u32 i = 0; i < 64; i++)
+            {
+                M4x4 single        = M4x4_inverse(batch_copy[i]);
+                M4x4 affine_single = M4x4_inverse_affine(affine_copy[i]);
+                if (memcmp(&batch[i], &single, sizeof(M4x4)) != 0 || memcmp(&affine_batch[i], &affine_single, sizeof(M4x4)) != 0) ok = gj_False;
+            }
+            check("M4x4_inverse batch", ok, round);
+        }
+    }
+
+    printf(g_failures ? "m4x4_inverse_test: %u failures\n" : "m4x4_inverse_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
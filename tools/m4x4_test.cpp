@@ -0,0 +1,70 @@
+// Checks the SIMD M4x4_mul overloads against the _scalar versions on random
+// matrices and vectors. Both sum the products in the same order so the
+// results have to be bit-identical.
+//
+//  g++ -O2 -I. tools/m4x4_test.cpp -o m4x4_test && ./m4x4_test
+//  g++ -O2 -mavx2 -I. tools/m4x4_test.cpp -o m4x4_test_avx2 && ./m4x4_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 round)
+{
+    if (!ok)
+    {
+        printf("%s: failed in round %u\n", name, round);
+        g_failures++;
+    }
+}
+
+static M4x4
+random_M4x4(RandomXoshiro128* random)
+{
+    M4x4 m;
+    for (u32 i = 0; i < 16; i++) m.a[i] = gj_random_f32(random, -10.0f, 10.0f);
+    return m;
+}
+
+int main()
+{
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    for (u32 round = 0; round < 100000; round++)
+    {
+        M4x4 m = random_M4x4(&random);
+        M4x4 n = random_M4x4(&random);
+        V4f v4 = {gj_random_f32(&random, -10.0f, 10.0f), gj_random_f32(&random, -10.0f, 10.0f),
+                  gj_random_f32(&random, -10.0f, 10.0f), gj_random_f32(&random, -10.0f, 10.0f)};
+        V3f v3 = {v4.x, v4.y, v4.z};
+
+        M4x4 expected = M4x4_mul_scalar(m, n);
+        M4x4 result = M4x4_mul(m, n);
+        check("M4x4_mul", memcmp(&result, &expected, sizeof(M4x4)) == 0, round);
+        M4x4_mul(&result, &m, &n);
+        check("M4x4_mul pointers", memcmp(&result, &expected, sizeof(M4x4)) == 0, round);
+
+        // NOTE: result aliasing either input
+        M4x4 in_place = m;
+        M4x4_mul(&in_place, &in_place, &n);
+        check("M4x4_mul result = m", memcmp(&in_place, &expected, sizeof(M4x4)) == 0, round);
+        in_place = n;
+        M4x4_mul(&in_place, &m, &in_place);
+        check("M4x4_mul result = n", memcmp(&in_place, &expected, sizeof(M4x4)) == 0, round);
+
+        V4f expected_v4 = M4x4_mul_scalar(m, v4);
+        V4f result_v4 = M4x4_mul(m, v4);
+        check("M4x4_mul V4f", memcmp(&result_v4, &expected_v4, sizeof(V4f)) == 0, round);
+        V3f expected_v3 = M4x4_mul_scalar(m, v3);
+        V3f result_v3 = M4x4_mul(m, v3);
+        check("M4x4_mul V3f", memcmp(&result_v3, &expected_v3, sizeof(V3f)) == 0, round);
+    }
+
+    printf(g_failures ? "m4x4_test: %u failures\n" : "m4x4_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,212 @@
+// Checks the random generators: known outputs of xoshiro128+ and PCG32,
+// gj_random_advance against stepping, the ranges staying in bounds and
+// coming out uniform, and the wide fills against one scalar generator per
+// lane (each lane is the base generator jumped once more).
+//
+//  g++ -O2 -I. tools/random_test.cpp -o random_test && ./random_test
+//  g++ -O2 -mavx2 -I. tools/random_test.cpp -o random_test_avx2 && ./random_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok)
+{
+    if (!ok)
+    {
+        printf("%s: failed\n", name);
+        g_failures++;
+    }
+}
+
+// NOTE: Every value in [0, range) and each within 2% of count / range
+static b32
+uniform(u32* values, u32 count, u32 range)
+{
+    u32 histogram[16] = {};
+    for (u32 i = 0; i < count; i++)
+    {
+        if (values[i] >= range) return gj_False;
+        histogram[values[i]]++;
+    }
+    f32 expected = (f32)count / (f32)range;
+    for (u32 i = 0; i < range; i++)
+    {
+        if (fabsf((f32)histogram[i] - expected) > 0.02f * expected) return gj_False;
+    }
+    return gj_True;
+}
+
+// NOTE: out[lane_count * step + lane] is the step-th draw of the lane's own
+//       scalar generator, fill_f32 applies the same min + (max - min) * unit
+//       as gj_random_f32
+template <typename Wide>
+static void
+check_wide(const char* name, u32 lane_count, MemoryArena* arena)
+{
+    BeginTemporaryMemoryBlock(arena);
+    RandomXoshiro128 base;
+    gj_random_seed(&base, 7);
+    RandomXoshiro128 lanes[8];
+    RandomXoshiro128 lane_base = base;
+    for (u32 lane = 0; lane < lane_count; lane++)
+    {
+        lanes[lane] = lane_base;
+        gj_random_jump(&lane_base);
+    }
+    Wide wide;
+    gj_random_seed(&wide, &base);
+    check(name, memcmp(&base, &lane_base, sizeof(base)) == 0);
+
+    // NOTE: Odd count so the last partial register goes through the tail
+    u32 count = 1001;
+    u32* values = push_array(arena, u32, count);
+    gj_random_fill_u32(&wide, values, count);
+    b32 ok = gj_True;
+    for (u32 i = 0; i < count; i++)
+    {
+        if (values[i] != gj_random_u32(&lanes[i % lane_count])) ok = gj_False;
+    }
+    // NOTE: The tail draws a whole register
+    for (u32 lane = count % lane_count; lane && lane < lane_count; lane++) gj_random_u32(&lanes[lane]);
+    check(name, ok);
+
+    f32* floats = push_array(arena, f32, count);
+    gj_random_fill_f32(&wide, floats, count, -3.0f, 5.0f);
+    for (u32 i = 0; i < count; i++)
+    {
+        if (floats[i] != gj_random_f32(&lanes[i % lane_count], -3.0f, 5.0f) || floats[i] < -3.0f || floats[i] >= 5.0f) ok = gj_False;
+    }
+    check(name, ok);
+
+    // NOTE: Rejected lanes redraw with every lane stepping, so only the
+    //       bounds and the distribution can be compared
+    count = 1200000;
+    values = push_array(arena, u32, count);
+    gj_random_fill_between_u32(&wide, values, count, 100, 106);
+    for (u32 i = 0; i < count; i++) values[i] -= 100;
+    check(name, uniform(values, count, 6));
+    gj_random_fill_between_u32(&wide, values, count, 5, 5);
+    check(name, values[0] == 5 && values[count - 1] == 5);
+    EndTemporaryMemoryBlock(arena);
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(64);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+
+    // NOTE: xoshiro128+ from state {1, 2, 3, 4} by hand, PCG32 is pcg32-demo
+    //       with seed 42 and stream 54
+    {
+        RandomXoshiro128 xoshiro = {{1, 2, 3, 4}};
+        u32 first = gj_random_u32(&xoshiro);
+        u32 second = gj_random_u32(&xoshiro);
+        check("xoshiro128+ reference", first == 5 && second == 12295);
+
+        RandomPCG32 pcg;
+        gj_random_seed(&pcg, 42, 54);
+        u32 expected[] = {0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e};
+        b32 ok = gj_True;
+        for (u32 i = 0; i < gj_ArrayCount(expected); i++) ok &= gj_random_u32(&pcg) == expected[i];
+        check("pcg32 reference", ok);
+
+        RandomPCG32 stepped;
+        gj_random_seed(&stepped, 1234, 5);
+        RandomPCG32 advanced = stepped;
+        for (u32 i = 0; i < 100000; i++) gj_random_u32(&stepped);
+        gj_random_advance(&advanced, 100000);
+        check("gj_random_advance", gj_random_u32(&stepped) == gj_random_u32(&advanced));
+    }
+
+    {
+        RandomXoshiro128 xoshiro;
+        gj_random_seed(&xoshiro, 1);
+        RandomPCG32 pcg;
+        gj_random_seed(&pcg, 1);
+        u32 count = 1200000;
+        u32* values = push_array(&arena, u32, count);
+
+        u32 ranges[] = {1, 2, 3, 7, 16};
+        for (u32 range_index = 0; range_index < gj_ArrayCount(ranges); range_index++)
+        {
+            u32 range = ranges[range_index];
+            for (u32 i = 0; i < count; i++) values[i] = gj_random_range_u32(&xoshiro, range);
+            check("gj_random_range_u32 xoshiro128+", uniform(values, count, range));
+            for (u32 i = 0; i < count; i++) values[i] = gj_random_between_u32(&pcg, 10, 10 + range) - 10;
+            check("gj_random_between_u32 pcg32", uniform(values, count, range));
+        }
+
+        // NOTE: Large ranges reject the most draws
+        b32 ok = gj_True;
+        u32 large_ranges[] = {0x80000001, 0xFFFFFFFF, 3000000000u};
+        for (u32 range_index = 0; range_index < gj_ArrayCount(large_ranges); range_index++)
+        {
+            for (u32 i = 0; i < 100000; i++) ok &= gj_random_range_u32(&xoshiro, large_ranges[range_index]) < large_ranges[range_index];
+        }
+        check("gj_random_range_u32 large", ok);
+
+        for (u32 i = 0; i < count; i++)
+        {
+            f32 unit = gj_random_unit_f32(&xoshiro);
+            f32 bilateral = gj_random_bilateral_f32(&pcg);
+            V3f v = gj_random_V3f(&xoshiro, {-1.0f, 2.0f, 3.0f}, {1.0f, 4.0f, 3.5f});
+            if (unit < 0.0f || unit >= 1.0f || bilateral < -1.0f || bilateral >= 1.0f ||
+                v.x < -1.0f || v.x >= 1.0f || v.y < 2.0f || v.y >= 4.0f || v.z < 3.0f || v.z >= 3.5f)
+            {
+                ok = gj_False;
+            }
+        }
+        check("unit/bilateral/V3f bounds", ok);
+    }
+
+    check_wide<RandomXoshiro128x4>("RandomXoshiro128x4", 4, &arena);
+#if defined(GJ_AVX2)
+    check_wide<RandomXoshiro128x8>("RandomXoshiro128x8", 8, &arena);
+#endif
+
+    // NOTE: 4 V3f per 3 registers, then one register per V3f for the tail
+    {
+        RandomXoshiro128 base;
+        gj_random_seed(&base, 3);
+        RandomXoshiro128 lanes[4];
+        RandomXoshiro128 lane_base = base;
+        for (u32 lane = 0; lane < 4; lane++)
+        {
+            lanes[lane] = lane_base;
+            gj_random_jump(&lane_base);
+        }
+        RandomXoshiro128x4 wide;
+        gj_random_seed(&wide, &base);
+
+        V3f min = {-1.0f, 0.0f, 10.0f};
+        V3f max = {1.0f, 100.0f, 11.0f};
+        V3f scale = V3_sub(max, min);
+        V3f out[11];
+        gj_random_fill_V3f(&wide, out, gj_ArrayCount(out), min, max);
+        b32 ok = gj_True;
+        f32* floats = (f32*)out;
+        for (u32 i = 0; i < 8 * 3; i++)
+        {
+            u32 axis = i % 3;
+            f32 expected = min.a[axis] + scale.a[axis] * gj_random_unit_f32(&lanes[i % 4]);
+            if (floats[i] != expected) ok = gj_False;
+        }
+        for (u32 i = 8; i < gj_ArrayCount(out); i++)
+        {
+            for (u32 axis = 0; axis < 3; axis++)
+            {
+                if (out[i].a[axis] != min.a[axis] + scale.a[axis] * gj_random_unit_f32(&lanes[axis])) ok = gj_False;
+            }
+            gj_random_u32(&lanes[3]);
+        }
+        check("gj_random_fill_V3f", ok);
+    }
+
+    printf(g_failures ? "random_test: %u failures\n" : "random_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+// Checks ray_boxes_intersection and ray_boxes_intersection_wide against a
+// plain scalar slab loop per box: the same hits, entry distances and hit
+// count. Boxes and origins are on an integer grid with axis parallel
+// directions mixed in, so rays start on slab planes and run along faces.
+//
+//  g++ -O2 -I. tools/ray_boxes_test.cpp -o ray_boxes_test && ./ray_boxes_test
+//  g++ -O2 -mavx2 -I. tools/ray_boxes_test.cpp -o ray_boxes_test_avx2 && ./ray_boxes_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 count)
+{
+    if (!ok)
+    {
+        printf("%s: failed for count %u\n", name, count);
+        g_failures++;
+    }
+}
+
+// NOTE: Closed box over [0, t_max], an axis giving NaN (0 * inf, the ray
+//       starting on a slab plane of an axis it is parallel to) is skipped.
+//       Returns the entry distance, FLT_MAX for a miss.
+static f32
+slab(V3f origin, V3f inverse_direction, V3f box_min, V3f box_max, f32 t_max)
+{
+    f32 enter = 0.0f;
+    f32 exit  = t_max;
+    for (u32 axis = 0; axis < 3; axis++)
+    {
+        f32 t0 = (box_min.a[axis] - origin.a[axis]) * inverse_direction.a[axis];
+        f32 t1 = (box_max.a[axis] - origin.a[axis]) * inverse_direction.a[axis];
+        if (isnan(t0) || isnan(t1)) continue;
+        if (t0 > t1) { f32 t = t0; t0 = t1; t1 = t; }
+        if (t0 > enter) enter = t0;
+        if (t1 < exit)  exit  = t1;
+    }
+    return enter <= exit ? enter : FLT_MAX;
+}
+
+static f32
+grid_f32(RandomXoshiro128* random, s32 min, s32 max)
+{
+    return (f32)((s32)gj_random_between_u32(random, 0, (u32)(max - min + 1)) + min);
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(16);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    for (u32 count = 0; count < 1100; count += (count < 70 ? 1 : 97))
+    {
+        BeginTemporaryMemoryBlock(&arena);
+        V3fSoA box_min = V3fSoA_create(&arena, count);
+        V3fSoA box_max = V3fSoA_create(&arena, count);
+        for (u32 i = 0; i < count; i++)
+        {
+            V3f min = {grid_f32(&random, -8, 8), grid_f32(&random, -8, 8), grid_f32(&random, -8, 8)};
+            V3f size = {grid_f32(&random, 0, 4), grid_f32(&random, 0, 4), grid_f32(&random, 0, 4)};
+            V3fSoA_set(&box_min, i, min);
+            V3fSoA_set(&box_max, i, V3_add(min, size));
+        }
+        // NOTE: A spare word past the boxes to check it isn't written
+        GJBitset hits = gj_bitset_create(&arena, count + 64);
+        hits.bit_count = count;
+        f32* t_enter = push_array(&arena, f32, count + 1);
+
+        for (u32 round = 0; round < 100; round++)
+        {
+            V3f origin    = {grid_f32(&random, -10, 10), grid_f32(&random, -10, 10), grid_f32(&random, -10, 10)};
+            V3f direction = gj_random_V3f(&random, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f});
+            // NOTE: Zero components give +-inf inverse directions
+            for (u32 axis = 0; axis < 3; axis++)
+            {
+                u32 kind = gj_random_range_u32(&random, 4);
+                if (kind == 0) direction.a[axis] = 0.0f;
+                if (kind == 1) direction.a[axis] = -0.0f;
+            }
+            if (direction.x == 0.0f && direction.y == 0.0f && direction.z == 0.0f) direction.x = 1.0f;
+            f32 t_max = round % 3 ? FLT_MAX : gj_random_f32(&random, 0.0f, 20.0f);
+            RaySlab ray = RaySlab_create(origin, direction);
+
+            // NOTE: Words past the boxes have to stay as they are
+            for (u32 w = 0; w < hits.word_count; w++) hits.words[w] = 0xA5A5A5A5A5A5A5A5ull;
+            u32 hit_count = ray_boxes_intersection(&ray, &box_min, &box_max, &hits, t_enter, t_max);
+            u32 expected_count = 0;
+            b32 ok = gj_True;
+            for (u32 i = 0; i < count; i++)
+            {
+                f32 expected = slab(origin, ray.inverse_direction, V3fSoA_get(&box_min, i), V3fSoA_get(&box_max, i), t_max);
+                b32 hit = expected != FLT_MAX;
+                expected_count += hit;
+                if (gj_bitset_get(&hits, i) != hit || t_enter[i] != expected) ok = gj_False;
+            }
+            if (count % 64 && hits.words[count / 64] >> (count % 64)) ok = gj_False;
+            for (u32 w = (count + 63) / 64; w < hits.word_count; w++)
+            {
+                if (hits.words[w] != 0xA5A5A5A5A5A5A5A5ull) ok = gj_False;
+            }
+            check("ray_boxes_intersection", ok && hit_count == expected_count, count);
+
+            // NOTE: Without t_enter, and the single group version
+            hit_count = ray_boxes_intersection(&ray, &box_min, &box_max, &hits, NULL, t_max);
+            check("ray_boxes_intersection without t_enter", hit_count == expected_count, count);
+            for (u32 first = 0; first + GJ_WIDE_LANES <= count; first += GJ_WIDE_LANES)
+            {
+                WideF32 wide_enter;
+                u32 mask = ray_boxes_intersection_wide(&ray, &box_min, &box_max, first, &wide_enter, t_max);
+                f32 enter[GJ_WIDE_LANES];
+                gj_wide_store(enter, wide_enter);
+                for (u32 lane = 0; lane < GJ_WIDE_LANES; lane++)
+                {
+                    b32 hit = (mask >> lane) & 1;
+                    if (hit != gj_bitset_get(&hits, first + lane) || (hit && enter[lane] != t_enter[first + lane])) ok = gj_False;
+                }
+            }
+            check("ray_boxes_intersection_wide", ok, count);
+        }
+        EndTemporaryMemoryBlock(&arena);
+    }
+
+    printf(g_failures ? "ray_boxes_test: %u failures\n" : "ray_boxes_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+// Checks ray_triangles_intersection and ray_packet_triangles_intersection
+// against looping ray_triangle_intersection over every triangle. Both use
+// the same operations, so the nearest triangle, t, u and v have to match
+// exactly, with ties going to the lower triangle index.
+//
+//  g++ -O2 -I. tools/ray_triangle_test.cpp -o ray_triangle_test && ./ray_triangle_test
+//  g++ -O2 -mavx2 -I. tools/ray_triangle_test.cpp -o ray_triangle_test_avx2 && ./ray_triangle_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 triangle_count)
+{
+    if (!ok)
+    {
+        printf("%s: failed for %u triangles\n", name, triangle_count);
+        g_failures++;
+    }
+}
+
+// NOTE: ray_triangle_intersection decides the hit, t/u/v are recomputed
+//       with its operations since it only returns the position
+static RayHit
+brute_force(V3f* vertices, u32 triangle_count, V3f origin, V3f direction, f32 t_max)
+{
+    RayHit result = {t_max, 0.0f, 0.0f, GJ_RAY_NO_HIT};
+    for (u32 i = 0; i < triangle_count; i++)
+    {
+        V3f v0 = vertices[3 * i], v1 = vertices[3 * i + 1], v2 = vertices[3 * i + 2];
+        V3f pos;
+        if (!ray_triangle_intersection(v0, v1, v2, origin, direction, &pos)) continue;
+
+        V3f edge1 = V3_sub(v1, v0);
+        V3f edge2 = V3_sub(v2, v0);
+        V3f pvec  = V3_cross(direction, edge2);
+        f32 inv_det = 1.0f / V3_dot(edge1, pvec);
+        V3f tvec  = V3_sub(origin, v0);
+        V3f qvec  = V3_cross(tvec, edge1);
+        f32 t = V3_dot(edge2, qvec) * inv_det;
+        if (t < result.t)
+        {
+            result.t        = t;
+            result.u        = V3_dot(tvec, pvec) * inv_det;
+            result.v        = V3_dot(direction, qvec) * inv_det;
+            result.triangle = i;
+        }
+    }
+    return result;
+}
+
+static b32
+same(RayHit* a, RayHit* b)
+{
+    return a->triangle == b->triangle && memcmp(&a->t, &b->t, sizeof(f32)) == 0 &&
+           memcmp(&a->u, &b->u, sizeof(f32)) == 0 && memcmp(&a->v, &b->v, sizeof(f32)) == 0;
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(16);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    u32 triangle_counts[] = {0, 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 100, 1001};
+    for (u32 count_index = 0; count_index < gj_ArrayCount(triangle_counts); count_index++)
+    {
+        BeginTemporaryMemoryBlock(&arena);
+        u32 triangle_count = triangle_counts[count_index];
+        V3f* vertices = push_array(&arena, V3f, 3 * triangle_count);
+        TriangleSoA triangles = TriangleSoA_create(&arena, triangle_count);
+        for (u32 i = 0; i < triangle_count; i++)
+        {
+            u32 kind = gj_random_range_u32(&random, 10);
+            if (kind == 0 && i > 0)
+            {
+                // NOTE: Copy of an earlier triangle, the earlier one wins the tie
+                u32 k = gj_random_range_u32(&random, i);
+                for (u32 j = 0; j < 3; j++) vertices[3 * i + j] = vertices[3 * k + j];
+            }
+            else if (kind == 1)
+            {
+                // NOTE: Degenerate, never hit
+                V3f p = gj_random_V3f(&random, {-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f});
+                vertices[3 * i] = vertices[3 * i + 1] = vertices[3 * i + 2] = p;
+            }
+            else
+            {
+                V3f center = gj_random_V3f(&random, {-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f});
+                for (u32 j = 0; j < 3; j++) vertices[3 * i + j] = V3_add(center, gj_random_V3f(&random, {-3.0f, -3.0f, -3.0f}, {3.0f, 3.0f, 3.0f}));
+            }
+            TriangleSoA_set(&triangles, i, vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]);
+        }
+
+        // NOTE: Rays from outside toward a point in the triangles' box, an odd
+        //       count so the packet version has a tail
+        u32 ray_count = 4 * GJ_WIDE_LANES + 3;
+        V3fSoA origins    = V3fSoA_create(&arena, ray_count);
+        V3fSoA directions = V3fSoA_create(&arena, ray_count);
+        RayHit* hits      = push_array(&arena, RayHit, ray_count);
+        RayHit* expected  = push_array(&arena, RayHit, ray_count);
+        f32 t_maxes[] = {FLT_MAX, 1.0f};
+        for (u32 round = 0; round < 50; round++)
+        {
+            f32 t_max = t_maxes[round % gj_ArrayCount(t_maxes)];
+            u32 expected_hit_count = 0;
+            b32 ok = gj_True;
+            for (u32 r = 0; r < ray_count; r++)
+            {
+                V3f origin = gj_random_V3f(&random, {-30.0f, -30.0f, -30.0f}, {30.0f, 30.0f, 30.0f});
+                V3f target = gj_random_V3f(&random, {-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f});
+                V3f direction = V3_sub(target, origin);
+                V3fSoA_set(&origins, r, origin);
+                V3fSoA_set(&directions, r, direction);
+
+                expected[r] = brute_force(vertices, triangle_count, origin, direction, t_max);
+                expected_hit_count += expected[r].triangle != GJ_RAY_NO_HIT;
+                RayHit hit;
+                b32 any = ray_triangles_intersection(origin, direction, &triangles, &hit, t_max);
+                if (any != (expected[r].triangle != GJ_RAY_NO_HIT) || !same(&hit, &expected[r])) ok = gj_False;
+            }
+            check("ray_triangles_intersection", ok, triangle_count);
+
+            u32 hit_count = ray_packet_triangles_intersection(&origins, &directions, &triangles, hits, t_max);
+            ok = hit_count == expected_hit_count;
+            for (u32 r = 0; r < ray_count; r++)
+            {
+                if (!same(&hits[r], &expected[r])) ok = gj_False;
+            }
+            check("ray_packet_triangles_intersection", ok, triangle_count);
+        }
+        EndTemporaryMemoryBlock(&arena);
+    }
+
+    printf(g_failures ? "ray_triangle_test: %u failures\n" : "ray_triangle_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
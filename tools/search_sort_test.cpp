@@ -0,0 +1,167 @@
+// Checks gj_find_u32 against a linear loop, the gj_lower_bound_ and
+// gj_binary_search_ functions against std::lower_bound, and the radix sorts
+// against std::stable_sort carrying the same payloads.
+//
+//  g++ -O2 -I. tools/search_sort_test.cpp -o search_sort_test && ./search_sort_test
+//  g++ -O2 -mavx2 -I. tools/search_sort_test.cpp -o search_sort_test_avx2 && ./search_sort_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 count)
+{
+    if (!ok)
+    {
+        printf("%s: failed for count %u\n", name, count);
+        g_failures++;
+    }
+}
+
+template <typename Key>
+struct Keyed
+{
+    Key key;
+    u32 payload;
+};
+
+template <typename Key>
+static bool
+key_less(const Keyed<Key>& a, const Keyed<Key>& b) { return a.key < b.key; }
+
+// NOTE: Sorts keys with payload 0..count-1 both ways, duplicates keep their
+//       order in both so the payloads have to match too
+template <typename Key>
+static void
+check_sort(const char* name, void (*sort)(Key*, u32*, u32, MemoryArena*), Key* keys, u32 count, MemoryArena* arena)
+{
+    BeginTemporaryMemoryBlock(arena);
+    Keyed<Key>* expected = push_array(arena, Keyed<Key>, count);
+    u32* payloads = push_array(arena, u32, count);
+    for (u32 i = 0; i < count; i++)
+    {
+        expected[i] = {keys[i], i};
+        payloads[i] = i;
+    }
+    std::stable_sort(expected, expected + count, key_less<Key>);
+
+    size_t used = arena->used;
+    sort(keys, payloads, count, arena);
+    b32 ok = arena->used == used;
+    for (u32 i = 0; i < count; i++)
+    {
+        if (memcmp(&keys[i], &expected[i].key, sizeof(Key)) != 0 || payloads[i] != expected[i].payload) ok = gj_False;
+    }
+    check(name, ok, count);
+    EndTemporaryMemoryBlock(arena);
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(128);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    // NOTE: Every count up to a few vectors so each tail length is covered,
+    //       with the value at every position and missing
+    for (u32 count = 0; count < 200; count++)
+    {
+        u32* values = push_array(&arena, u32, count + 1);
+        for (u32 i = 0; i < count; i++) values[i] = gj_random_range_u32(&random, 64) + 1;
+        for (u32 position = 0; position <= count; position++)
+        {
+            u32 value = position < count ? values[position] : 0;
+            s32 expected = -1;
+            for (u32 i = 0; i < count; i++)
+            {
+                if (values[i] == value) { expected = (s32)i; break; }
+            }
+            check("gj_find_u32", gj_find_u32(values, count, value) == expected, count);
+            check("gj_find_s32", gj_find_s32((s32*)values, count, (s32)value) == expected, count);
+        }
+    }
+
+    for (u32 round = 0; round < 200; round++)
+    {
+        BeginTemporaryMemoryBlock(&arena);
+        u32 count = gj_random_range_u32(&random, 1000);
+        u32* u32_values = push_array(&arena, u32, count);
+        s32* s32_values = push_array(&arena, s32, count);
+        f32* f32_values = push_array(&arena, f32, count);
+        for (u32 i = 0; i < count; i++)
+        {
+            u32_values[i] = gj_random_range_u32(&random, 2 * count + 1);
+            s32_values[i] = (s32)u32_values[i] - (s32)count;
+            f32_values[i] = 0.5f * (f32)s32_values[i];
+        }
+        std::sort(u32_values, u32_values + count);
+        std::sort(s32_values, s32_values + count);
+        std::sort(f32_values, f32_values + count);
+
+        for (u32 i = 0; i < 20; i++)
+        {
+            u32 value = gj_random_range_u32(&random, 2 * count + 3);
+            s32 signed_value = (s32)value - (s32)count - 1;
+            f32 float_value = 0.5f * (f32)signed_value;
+            u32 u32_expected = (u32)(std::lower_bound(u32_values, u32_values + count, value) - u32_values);
+            u32 s32_expected = (u32)(std::lower_bound(s32_values, s32_values + count, signed_value) - s32_values);
+            u32 f32_expected = (u32)(std::lower_bound(f32_values, f32_values + count, float_value) - f32_values);
+            check("gj_lower_bound_u32", gj_lower_bound_u32(u32_values, count, value) == u32_expected, count);
+            check("gj_lower_bound_s32", gj_lower_bound_s32(s32_values, count, signed_value) == s32_expected, count);
+            check("gj_lower_bound_f32", gj_lower_bound_f32(f32_values, count, float_value) == f32_expected, count);
+
+            s32 found = gj_binary_search_u32(u32_values, count, value);
+            b32 present = u32_expected < count && u32_values[u32_expected] == value;
+            check("gj_binary_search_u32", found == (present ? (s32)u32_expected : -1), count);
+            found = gj_binary_search_s32(s32_values, count, signed_value);
+            present = s32_expected < count && s32_values[s32_expected] == signed_value;
+            check("gj_binary_search_s32", found == (present ? (s32)s32_expected : -1), count);
+        }
+        EndTemporaryMemoryBlock(&arena);
+    }
+
+    // NOTE: Full range keys use every pass, small ones skip the top passes
+    //       and have lots of duplicates
+    u32 counts[] = {0, 1, 2, 255, 256, 1000, 100000};
+    u32 ranges[] = {0xFFFFFFFF, 1000, 70000, 1};
+    for (u32 count_index = 0; count_index < gj_ArrayCount(counts); count_index++)
+    {
+        for (u32 range_index = 0; range_index < gj_ArrayCount(ranges); range_index++)
+        {
+            BeginTemporaryMemoryBlock(&arena);
+            u32 count = counts[count_index];
+            u32 range = ranges[range_index];
+            u32* u32_keys = push_array(&arena, u32, count);
+            s32* s32_keys = push_array(&arena, s32, count);
+            f32* f32_keys = push_array(&arena, f32, count);
+            for (u32 i = 0; i < count; i++)
+            {
+                u32_keys[i] = range == 0xFFFFFFFF ? gj_random_u32(&random) : gj_random_range_u32(&random, range);
+                s32_keys[i] = (s32)(range == 0xFFFFFFFF ? u32_keys[i] : u32_keys[i] - range / 2);
+                f32_keys[i] = range == 1 ? 1.0f : gj_random_f32(&random, -1000.0f, 1000.0f) * (f32)(u32_keys[i] % 7);
+                // NOTE: -0.0 and 0.0 are ordered by the sort but equal to std::stable_sort
+                if (f32_keys[i] == 0.0f) f32_keys[i] = 0.0f;
+            }
+            check_sort("gj_radix_sort_u32", gj_radix_sort_u32, u32_keys, count, &arena);
+            check_sort("gj_radix_sort_s32", gj_radix_sort_s32, s32_keys, count, &arena);
+            check_sort("gj_radix_sort_f32", gj_radix_sort_f32, f32_keys, count, &arena);
+            EndTemporaryMemoryBlock(&arena);
+        }
+    }
+
+    {
+        f32 keys[] = {0.0f, -0.0f, -1.0f, INFINITY, -INFINITY, 1.0f};
+        gj_radix_sort_f32(keys, NULL, gj_ArrayCount(keys), &arena);
+        check("gj_radix_sort_f32 -0.0 before 0.0", keys[0] == -INFINITY && keys[1] == -1.0f && signbit(keys[2]) &&
+              keys[3] == 0.0f && !signbit(keys[3]) && keys[4] == 1.0f && keys[5] == INFINITY, gj_ArrayCount(keys));
+    }
+
+    printf(g_failures ? "search_sort_test: %u failures\n" : "search_sort_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
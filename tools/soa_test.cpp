@@ -0,0 +1,114 @@
+// Checks the V3fSoA batch kernels against the scalar V3 functions on the
+// same values. The kernels only use plain IEEE ops in the same order, so
+// the results have to be bit-identical, for every tail length.
+//
+//  g++ -O2 -I. tools/soa_test.cpp -o soa_test && ./soa_test
+//  g++ -O2 -mavx2 -I. tools/soa_test.cpp -o soa_test_avx2 && ./soa_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 count)
+{
+    if (!ok)
+    {
+        printf("%s: failed for count %u\n", name, count);
+        g_failures++;
+    }
+}
+
+static b32
+same(V3fSoA* soa, V3f* expected, u32 count)
+{
+    for (u32 i = 0; i < count; i++)
+    {
+        V3f v = V3fSoA_get(soa, i);
+        if (memcmp(&v, &expected[i], sizeof(V3f)) != 0) return gj_False;
+    }
+    return gj_True;
+}
+
+static b32
+same(f32* values, f32* expected, u32 count)
+{
+    return count == 0 || memcmp(values, expected, count * sizeof(f32)) == 0;
+}
+
+int main()
+{
+    size_t arena_size = Megabytes(16);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    for (u32 count = 0; count < 1100; count += (count < 40 ? 1 : 97))
+    {
+        BeginTemporaryMemoryBlock(&arena);
+        V3fSoA a   = V3fSoA_create(&arena, count);
+        V3fSoA b   = V3fSoA_create(&arena, count);
+        V3fSoA dst = V3fSoA_create(&arena, count);
+        V3f* va       = push_array(&arena, V3f, count);
+        V3f* vb       = push_array(&arena, V3f, count);
+        V3f* expected = push_array(&arena, V3f, count);
+        f32* values          = push_array(&arena, f32, count);
+        f32* expected_values = push_array(&arena, f32, count);
+
+        // NOTE: Some zero vectors so V3_normalize takes its zero length path
+        for (u32 i = 0; i < count; i++)
+        {
+            va[i] = gj_random_range_u32(&random, 8) ? gj_random_V3f(&random, {-100.0f, -100.0f, -100.0f}, {100.0f, 100.0f, 100.0f}) : V3f{};
+            vb[i] = gj_random_V3f(&random, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f});
+        }
+        V3fSoA_from_V3f(&a, va, count);
+        V3fSoA_from_V3f(&b, vb, count);
+        check("V3fSoA_from_V3f", same(&a, va, count) && same(&b, vb, count), count);
+        V3fSoA_to_V3f(expected, &a, count);
+        check("V3fSoA_to_V3f", count == 0 || memcmp(expected, va, count * sizeof(V3f)) == 0, count);
+
+        V3_add(&dst, &a, &b);
+        for (u32 i = 0; i < count; i++) expected[i] = V3_add(va[i], vb[i]);
+        check("V3_add", same(&dst, expected, count), count);
+        V3_sub(&dst, &a, &b);
+        for (u32 i = 0; i < count; i++) expected[i] = V3_sub(va[i], vb[i]);
+        check("V3_sub", same(&dst, expected, count), count);
+        V3_mul(&dst, &a, &b);
+        for (u32 i = 0; i < count; i++) expected[i] = V3_mul(va[i], vb[i]);
+        check("V3_mul", same(&dst, expected, count), count);
+        V3_mul(&dst, 0.3f, &a);
+        for (u32 i = 0; i < count; i++) expected[i] = V3_mul(0.3f, va[i]);
+        check("V3_mul scalar", same(&dst, expected, count), count);
+        V3_cross(&dst, &a, &b);
+        for (u32 i = 0; i < count; i++) expected[i] = V3_cross(va[i], vb[i]);
+        check("V3_cross", same(&dst, expected, count), count);
+        V3_lerp(&dst, &a, &b, 0.7f);
+        for (u32 i = 0; i < count; i++) expected[i] = V3_lerp(va[i], vb[i], 0.7f);
+        check("V3_lerp", same(&dst, expected, count), count);
+        V3_normalize(&dst, &a);
+        for (u32 i = 0; i < count; i++) expected[i] = V3_normalize(va[i]);
+        check("V3_normalize", same(&dst, expected, count), count);
+
+        V3_dot(values, &a, &b, count);
+        for (u32 i = 0; i < count; i++) expected_values[i] = V3_dot(va[i], vb[i]);
+        check("V3_dot", same(values, expected_values, count), count);
+        V3_distance(values, &a, &b, count);
+        for (u32 i = 0; i < count; i++) expected_values[i] = V3_length(V3_sub(va[i], vb[i]));
+        check("V3_distance", same(values, expected_values, count), count);
+
+        // NOTE: dst aliasing an input
+        V3_cross(&a, &a, &b);
+        for (u32 i = 0; i < count; i++) expected[i] = V3_cross(va[i], vb[i]);
+        check("V3_cross in place", same(&a, expected, count), count);
+        V3_normalize(&a, &a);
+        for (u32 i = 0; i < count; i++) expected[i] = V3_normalize(expected[i]);
+        check("V3_normalize in place", same(&a, expected, count), count);
+        EndTemporaryMemoryBlock(&arena);
+    }
+
+    printf(g_failures ? "soa_test: %u failures\n" : "soa_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
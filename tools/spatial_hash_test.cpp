@@ -0,0 +1,192 @@
+// Checks the GJSpatialHash queries against testing every point, for 3D and
+// 2D builds, small queries walking cells and large ones taking the straight
+// scan, and that a threaded build gives the same layout as a single thread.
+//
+//  g++ -O2 -I. tools/spatial_hash_test.cpp -o spatial_hash_test -lpthread && ./spatial_hash_test
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#include <gj/gj_spatial_hash.h>
+#if defined(_WIN32)
+#include <gj/win32_platform.h>
+#define init_platform_api win32_init_platform_api
+#else
+#include <gj/linux_platform.h>
+#define init_platform_api linux_init_platform_api
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 query)
+{
+    if (!ok)
+    {
+        printf("%s: failed for query %u\n", name, query);
+        g_failures++;
+    }
+}
+
+// NOTE: Order isn't part of the result
+static b32
+same(u32* out, u32 found, std::vector<u32>& expected)
+{
+    std::vector<u32> sorted(out, out + found);
+    std::sort(sorted.begin(), sorted.end());
+    return sorted == expected;
+}
+
+typedef struct Entity
+{
+    u32 id;
+    V3f position;
+    V2f planar_position;
+} Entity;
+
+// NOTE: Every 50th query is large enough for the straight scan
+static void
+check_queries(GJSpatialHash* hash, Entity* entities, u32 count, f32 extent, f32 max_radius, RandomXoshiro128* random)
+{
+    std::vector<u32> out(count);
+    std::vector<u32> expected;
+    for (u32 query = 0; query < 300; query++)
+    {
+        V3f center = gj_random_V3f(random, {-extent, -extent, -0.25f * extent}, {extent, extent, 0.25f * extent});
+        f32 radius = gj_random_f32(random, 0.0f, query % 50 == 0 ? 2.0f * extent : max_radius);
+
+        u32 found = gj_spatial_hash_query_radius(hash, center, radius, out.data(), count);
+        expected.clear();
+        for (u32 i = 0; i < count; i++)
+        {
+            V3f d = V3_sub(entities[i].position, center);
+            if (V3_dot(d, d) <= radius * radius) expected.push_back(i);
+        }
+        check("gj_spatial_hash_query_radius", same(out.data(), found, expected), query);
+
+        V3f min = V3_add(center, -radius);
+        V3f max = V3_add(center, 0.5f * radius);
+        found = gj_spatial_hash_query_aabb(hash, min, max, out.data(), count);
+        expected.clear();
+        for (u32 i = 0; i < count; i++)
+        {
+            V3f p = entities[i].position;
+            if (p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z) expected.push_back(i);
+        }
+        check("gj_spatial_hash_query_aabb", same(out.data(), found, expected), query);
+        check("gj_spatial_hash_query_aabb empty", gj_spatial_hash_query_aabb(hash, max, min, out.data(), count) == (radius == 0.0f ? found : 0), query);
+
+        V3i cell_min = gj_spatial_hash_cell(hash, center);
+        V3i cell_max = {cell_min.x + 1, cell_min.y + 2, cell_min.z};
+        found = gj_spatial_hash_query_cells(hash, cell_min, cell_max, out.data(), count);
+        expected.clear();
+        for (u32 i = 0; i < count; i++)
+        {
+            V3i cell = gj_spatial_hash_cell(hash, entities[i].position);
+            if (cell.x >= cell_min.x && cell.x <= cell_max.x && cell.y >= cell_min.y && cell.y <= cell_max.y && cell.z == cell_min.z) expected.push_back(i);
+        }
+        check("gj_spatial_hash_query_cells", same(out.data(), found, expected), query);
+    }
+}
+
+int main()
+{
+    PlatformAPI platform_api;
+    init_platform_api(&platform_api, 0);
+    size_t arena_size = Megabytes(64);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    // NOTE: Enough points for 4 build threads, some exactly on cell borders
+    u32 count = 4 * GJ_PARALLEL_MIN_RANGE + 123;
+    f32 cell_size = 4.0f;
+    Entity* entities = push_array(&arena, Entity, count);
+    for (u32 i = 0; i < count; i++)
+    {
+        V3f p = gj_random_V3f(&random, {-200.0f, -200.0f, -50.0f}, {200.0f, 200.0f, 50.0f});
+        if (i % 7 == 0) p.x = cell_size * floorf(p.x / cell_size);
+        if (i % 11 == 0) p.y = cell_size * floorf(p.y / cell_size);
+        entities[i].id              = i;
+        entities[i].position        = p;
+        entities[i].planar_position = {p.x, p.y};
+    }
+
+    GJSpatialHash hash, threaded_hash;
+    gj_spatial_hash_create(&hash, &arena, count, cell_size);
+    gj_spatial_hash_create(&threaded_hash, &arena, count, cell_size, 4);
+    gj_spatial_hash_build(&hash, &entities[0].position, sizeof(Entity), count);
+    gj_spatial_hash_build(&threaded_hash, &entities[0].position, sizeof(Entity), count, &platform_api, 4);
+    check("gj_spatial_hash_build threaded", memcmp(hash.items, threaded_hash.items, count * sizeof(u32)) == 0 &&
+          memcmp(hash.bucket_start, threaded_hash.bucket_start, (hash.bucket_count + 1) * sizeof(u32)) == 0, 0);
+
+    b32 ok = gj_True;
+    for (u32 bucket = 0; bucket < hash.bucket_count; bucket++)
+    {
+        for (u32 entry = hash.bucket_start[bucket]; entry < hash.bucket_start[bucket + 1]; entry++)
+        {
+            u32 item = hash.items[entry];
+            if (gj_spatial_hash_bucket(&hash, gj_spatial_hash_cell(&hash, entities[item].position)) != bucket ||
+                memcmp(&hash.positions[entry], &entities[item].position, sizeof(V3f)) != 0) ok = gj_False;
+        }
+    }
+    check("gj_spatial_hash_build buckets", ok && hash.bucket_start[hash.bucket_count] == count, 0);
+
+    check_queries(&hash, entities, count, 210.0f, 15.0f, &random);
+
+    // NOTE: Few buckets and densely packed points, so the cells of one query
+    //       share buckets and each entry must only be reported for its own cell
+    {
+        u32 dense_count = 200;
+        Entity* dense = push_array(&arena, Entity, dense_count);
+        for (u32 i = 0; i < dense_count; i++) dense[i].position = gj_random_V3f(&random, {-12.0f, -12.0f, -3.0f}, {12.0f, 12.0f, 3.0f});
+        GJSpatialHash dense_hash;
+        gj_spatial_hash_create(&dense_hash, &arena, dense_count, 2.0f);
+        gj_spatial_hash_build(&dense_hash, &dense[0].position, sizeof(Entity), dense_count);
+        check_queries(&dense_hash, dense, dense_count, 12.0f, 3.0f, &random);
+    }
+
+    std::vector<u32> out(count);
+    std::vector<u32> expected;
+    // NOTE: z is ignored in planar hashes
+    GJSpatialHash planar_hash;
+    gj_spatial_hash_create(&planar_hash, &arena, count, cell_size);
+    gj_spatial_hash_build(&planar_hash, &entities[0].planar_position, sizeof(Entity), count);
+    for (u32 query = 0; query < 100; query++)
+    {
+        V2f center = {gj_random_f32(&random, -200.0f, 200.0f), gj_random_f32(&random, -200.0f, 200.0f)};
+        f32 radius = gj_random_f32(&random, 0.0f, 10.0f);
+        u32 found = gj_spatial_hash_query_radius(&planar_hash, center, radius, out.data(), count);
+        expected.clear();
+        for (u32 i = 0; i < count; i++)
+        {
+            V3f d = {entities[i].planar_position.x - center.x, entities[i].planar_position.y - center.y, 0.0f};
+            if (V3_dot(d, d) <= radius * radius) expected.push_back(i);
+        }
+        check("gj_spatial_hash_query_radius planar", same(out.data(), found, expected), query);
+
+        V2f max = {center.x + radius, center.y + 2.0f * radius};
+        found = gj_spatial_hash_query_aabb(&planar_hash, center, max, out.data(), count);
+        expected.clear();
+        for (u32 i = 0; i < count; i++)
+        {
+            V2f p = entities[i].planar_position;
+            if (p.x >= center.x && p.x <= max.x && p.y >= center.y && p.y <= max.y) expected.push_back(i);
+        }
+        check("gj_spatial_hash_query_aabb planar", same(out.data(), found, expected), query);
+    }
+
+    // NOTE: A short out gets the first out_max matches and the full count back
+    {
+        u32 found = gj_spatial_hash_query_radius(&hash, {0.0f, 0.0f, 0.0f}, 30.0f, out.data(), count);
+        u32 short_out[3];
+        u32 short_found = gj_spatial_hash_query_radius(&hash, {0.0f, 0.0f, 0.0f}, 30.0f, short_out, gj_ArrayCount(short_out));
+        check("gj_spatial_hash_query_radius out_max", found > 3 && short_found == found && memcmp(short_out, out.data(), sizeof(short_out)) == 0, 0);
+    }
+
+    printf(g_failures ? "spatial_hash_test: %u failures\n" : "spatial_hash_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}
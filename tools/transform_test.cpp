@@ -0,0 +1,145 @@
+// Checks M4x4_transform_points/directions over strided and SoA buffers
+// against M4x4_mul_scalar per vertex, bit-identical, for every tail length,
+// in place, and split across threads.
+//
+//  g++ -O2 -I. tools/transform_test.cpp -o transform_test -lpthread && ./transform_test
+//  g++ -O2 -mavx2 -I. tools/transform_test.cpp -o transform_test_avx2 -lpthread && ./transform_test_avx2
+
+#include <gj/gj_base.h>
+#include <gj/gj_math.h>
+#if defined(_WIN32)
+#include <gj/win32_platform.h>
+#define init_platform_api win32_init_platform_api
+#else
+#include <gj/linux_platform.h>
+#define init_platform_api linux_init_platform_api
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+
+static u32 g_failures = 0;
+
+static void
+check(const char* name, b32 ok, u32 count)
+{
+    if (!ok)
+    {
+        printf("%s: failed for count %u\n", name, count);
+        g_failures++;
+    }
+}
+
+// NOTE: Points are m * (p, 1), directions m * (d, 0)
+static V3f
+expected_transform(M4x4 m, V3f v, b32 directions)
+{
+    if (!directions) return M4x4_mul_scalar(m, v);
+    V4f r = M4x4_mul_scalar(m, V4f{v.x, v.y, v.z, 0.0f});
+    return {r.x, r.y, r.z};
+}
+
+// NOTE: Interleaved vertices of stride bytes with the V3f first, the bytes
+//       after it have to stay untouched
+static void
+check_strided(M4x4* m, b32 directions, u32 count, u32 stride, PlatformAPI* platform_api, u32 thread_count,
+              RandomXoshiro128* random, MemoryArena* arena)
+{
+    BeginTemporaryMemoryBlock(arena);
+    byte* src = push_array(arena, byte, (u64)count * stride + 1);
+    byte* dst = push_array(arena, byte, (u64)count * stride + 1);
+    for (u64 i = 0; i < (u64)count * stride / 4; i++) ((f32*)src)[i] = gj_random_f32(random, -100.0f, 100.0f);
+    memset(dst, 0xAB, (u64)count * stride + 1);
+
+    const char* name = directions ? "M4x4_transform_directions" : "M4x4_transform_points";
+    if (directions) M4x4_transform_directions(m, (V3f*)dst, stride, (V3f*)src, stride, count, platform_api, thread_count);
+    else            M4x4_transform_points(m, (V3f*)dst, stride, (V3f*)src, stride, count, platform_api, thread_count);
+    b32 ok = gj_True;
+    for (u32 i = 0; i < count; i++)
+    {
+        V3f expected = expected_transform(*m, *(V3f*)(src + i * stride), directions);
+        if (memcmp(dst + i * stride, &expected, sizeof(V3f)) != 0) ok = gj_False;
+        for (u32 k = sizeof(V3f); k < stride; k++) if (dst[i * stride + k] != 0xAB) ok = gj_False;
+    }
+    check(name, ok && dst[(u64)count * stride] == 0xAB, count);
+
+    // NOTE: In place, dst now holds the expected results of src
+    if (directions) M4x4_transform_directions(m, (V3f*)src, stride, count, platform_api, thread_count);
+    else            M4x4_transform_points(m, (V3f*)src, stride, count, platform_api, thread_count);
+    for (u32 i = 0; i < count; i++)
+    {
+        if (memcmp(dst + i * stride, src + i * stride, sizeof(V3f)) != 0) ok = gj_False;
+    }
+    check(name, ok, count);
+    EndTemporaryMemoryBlock(arena);
+}
+
+static void
+check_soa(M4x4* m, b32 directions, u32 count, PlatformAPI* platform_api, u32 thread_count,
+          RandomXoshiro128* random, MemoryArena* arena)
+{
+    BeginTemporaryMemoryBlock(arena);
+    V3fSoA src = V3fSoA_create(arena, count);
+    V3fSoA dst = V3fSoA_create(arena, count);
+    for (u32 i = 0; i < count; i++) V3fSoA_set(&src, i, gj_random_V3f(random, {-100.0f, -100.0f, -100.0f}, {100.0f, 100.0f, 100.0f}));
+
+    const char* name = directions ? "M4x4_transform_directions SoA" : "M4x4_transform_points SoA";
+    if (directions) M4x4_transform_directions(m, &dst, &src, platform_api, thread_count);
+    else            M4x4_transform_points(m, &dst, &src, platform_api, thread_count);
+    b32 ok = gj_True;
+    for (u32 i = 0; i < count; i++)
+    {
+        V3f result   = V3fSoA_get(&dst, i);
+        V3f expected = expected_transform(*m, V3fSoA_get(&src, i), directions);
+        if (memcmp(&result, &expected, sizeof(V3f)) != 0) ok = gj_False;
+    }
+    check(name, ok, count);
+
+    if (directions) M4x4_transform_directions(m, &src, &src, platform_api, thread_count);
+    else            M4x4_transform_points(m, &src, &src, platform_api, thread_count);
+    for (u32 i = 0; i < count; i++)
+    {
+        V3f result   = V3fSoA_get(&src, i);
+        V3f expected = V3fSoA_get(&dst, i);
+        if (memcmp(&result, &expected, sizeof(V3f)) != 0) ok = gj_False;
+    }
+    check(name, ok, count);
+    EndTemporaryMemoryBlock(arena);
+}
+
+int main()
+{
+    PlatformAPI platform_api;
+    init_platform_api(&platform_api, 0);
+    size_t arena_size = Megabytes(128);
+    MemoryArena arena = create_memory_arena(arena_size, (u8*)malloc(arena_size));
+    RandomXoshiro128 random;
+    gj_random_seed(&random, 1);
+
+    M4x4 m;
+    for (u32 i = 0; i < 16; i++) m.a[i] = gj_random_f32(&random, -2.0f, 2.0f);
+
+    // NOTE: Packed V3f and interleaved position/normal/uv
+    u32 strides[] = {sizeof(V3f), 8 * sizeof(f32)};
+    for (u32 directions = 0; directions < 2; directions++)
+    {
+        for (u32 count = 0; count < 40; count++)
+        {
+            for (u32 stride_index = 0; stride_index < gj_ArrayCount(strides); stride_index++)
+            {
+                check_strided(&m, directions, count, strides[stride_index], NULL, 1, &random, &arena);
+            }
+            check_soa(&m, directions, count, NULL, 1, &random, &arena);
+        }
+
+        // NOTE: Enough for several threads with a tail in the last range
+        u32 count = 4 * GJ_PARALLEL_MIN_RANGE + 7;
+        for (u32 stride_index = 0; stride_index < gj_ArrayCount(strides); stride_index++)
+        {
+            check_strided(&m, directions, count, strides[stride_index], &platform_api, 4, &random, &arena);
+        }
+        check_soa(&m, directions, count, &platform_api, 4, &random, &arena);
+    }
+
+    printf(g_failures ? "transform_test: %u failures\n" : "transform_test: ok\n", g_failures);
+    return g_failures ? 1 : 0;
+}